@@ -1,6 +1,7 @@
 #ifndef KEYDIVERSIFICATION_HPP__
 #define KEYDIVERSIFICATION_HPP__
 
+#include <functional>
 #include <vector>
 #include <memory>
 #include <logicalaccess/key.hpp>
@@ -21,8 +22,34 @@ class LLA_CORE_API KeyDiversification : public XmlSerializable
                                          ByteVector diversify) = 0;
     virtual std::string getKeyDiversificationType()            = 0;
 
+    /**
+     * \brief Diversify the same key for many inputs at once.
+     * \param key The master key.
+     * \param diversify The diversification inputs, as built by initDiversification().
+     * \param threads The number of worker threads, 0 for one per hardware thread.
+     * \return The diversified keys, in the same order as the inputs.
+     *
+     * The default implementation calls getDiversifiedKey() for each input, concurrently
+     * when more than one thread is used.
+     */
+    virtual std::vector<ByteVector>
+    getDiversifiedKeys(std::shared_ptr<Key> key, const std::vector<ByteVector> &diversify,
+                       unsigned int threads = 1);
+
     static std::shared_ptr<KeyDiversification>
     getKeyDiversificationFromType(std::string kdiv);
+
+  protected:
+    /**
+     * \brief Split [0, count) in contiguous ranges and run them on worker threads.
+     * \param count The number of items.
+     * \param threads The number of worker threads, 0 for one per hardware thread.
+     * \param fn The function called with each [begin, end) range.
+     *
+     * The first exception thrown by a worker is rethrown once all workers are done.
+     */
+    static void forEachRange(size_t count, unsigned int threads,
+                             const std::function<void(size_t, size_t)> &fn);
 };
 }
 
@@ -64,6 +64,21 @@ class LLA_CORE_API ReaderCardAdapter
     */
     virtual ByteVector sendCommand(const ByteVector &command, long timeout = -1);
 
+    /**
+    * \brief Send a batch of independent commands to the reader.
+    *
+    * Commands are adapted first, then handed over to the data transport at once so
+    * it can pipeline them. Answers are adapted and checked once all of them are
+    * received, the first failing answer throws.
+    * Adapters overriding sendCommand() must override this one too, usually with
+    * sendCommandsInSequence().
+    * \param commands The command buffers.
+    * \param timeout The timeout of each command.
+    * \return The results, in the commands order.
+    */
+    virtual std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                                 long timeout = -1);
+
     /**
     * \brief Get the result checker.
     * \return The result checker.
@@ -83,6 +98,15 @@ class LLA_CORE_API ReaderCardAdapter
     }
 
   protected:
+    /**
+    * \brief Send a batch of commands one by one through sendCommand().
+    * \param commands The command buffers.
+    * \param timeout The timeout of each command.
+    * \return The results, in the commands order.
+    */
+    std::vector<ByteVector> sendCommandsInSequence(const std::vector<ByteVector> &commands,
+                                                   long timeout);
+
     /**
     * \brief The data transport.
     */
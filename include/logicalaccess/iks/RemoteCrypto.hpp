@@ -1,6 +1,10 @@
 #pragma once
 
 #include "logicalaccess/lla_fwd.hpp"
+#include <exception>
+#include <future>
+#include <string>
+#include <vector>
 
 namespace logicalaccess
 {
@@ -26,6 +30,27 @@ struct MyDivInfo
     ByteVector div_input;
 };
 
+/**
+ * One AES operation of a batch.
+ */
+struct AESOperation
+{
+    /**
+     * The name of the IKS key, or the reference of a session key.
+     */
+    std::string key_name;
+
+    /**
+     * The initialization vector, 16 bytes.
+     */
+    ByteVector iv;
+
+    /**
+     * The data to encrypt or decrypt, a multiple of 16 bytes.
+     */
+    ByteVector payload;
+};
+
 /**
  * Base plugin API for RemoteCrypto.
  *
@@ -47,6 +72,22 @@ class RemoteCrypto
     virtual bool verify_signature(const SignatureResult &sr,
                                   const std::string &pubkey_pem) = 0;
 
+    /**
+     * Verify many signatures issued by the same IKS.
+     *
+     * Results are in the same order as the signatures. The default
+     * implementation calls verify_signature() for each signature.
+     */
+    virtual std::vector<bool> verify_signatures(const std::vector<SignatureResult> &srs,
+                                                const std::string &pubkey_pem)
+    {
+        std::vector<bool> ret;
+        ret.reserve(srs.size());
+        for (const auto &sr : srs)
+            ret.push_back(verify_signature(sr, pubkey_pem));
+        return ret;
+    }
+
     virtual ByteVector aes_encrypt(const ByteVector &in, const std::string &key_name,
                                    const ByteVector &iv) = 0;
 
@@ -54,6 +95,88 @@ class RemoteCrypto
                                    const ByteVector &iv,
                                    SignatureResult *out_signature = nullptr) = 0;
 
+    /**
+     * Start an encryption without waiting for its result.
+     *
+     * The default implementation encrypts before returning.
+     */
+    virtual std::future<ByteVector> aes_encrypt_async(const ByteVector &in,
+                                                      const std::string &key_name,
+                                                      const ByteVector &iv)
+    {
+        std::promise<ByteVector> result;
+        try
+        {
+            result.set_value(aes_encrypt(in, key_name, iv));
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+        return result.get_future();
+    }
+
+    /**
+     * Start a decryption without waiting for its result.
+     *
+     * If `out_signature` is not null, it is filled when the result is retrieved
+     * and must stay valid until then. The default implementation decrypts before
+     * returning.
+     */
+    virtual std::future<ByteVector>
+    aes_decrypt_async(const ByteVector &in, const std::string &key_name,
+                      const ByteVector &iv, SignatureResult *out_signature = nullptr)
+    {
+        std::promise<ByteVector> result;
+        try
+        {
+            result.set_value(aes_decrypt(in, key_name, iv, out_signature));
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+        return result.get_future();
+    }
+
+    /**
+     * Encrypt many payloads, possibly with different keys.
+     *
+     * Results are in the same order as the operations. The default
+     * implementation calls aes_encrypt() for each operation.
+     */
+    virtual std::vector<ByteVector>
+    aes_encrypt_batch(const std::vector<AESOperation> &ops)
+    {
+        std::vector<ByteVector> ret;
+        ret.reserve(ops.size());
+        for (const auto &op : ops)
+            ret.push_back(aes_encrypt(op.payload, op.key_name, op.iv));
+        return ret;
+    }
+
+    /**
+     * Decrypt many payloads, possibly with different keys.
+     *
+     * If `out_signatures` is not null, it receives one signature per operation.
+     * The default implementation calls aes_decrypt() for each operation.
+     */
+    virtual std::vector<ByteVector>
+    aes_decrypt_batch(const std::vector<AESOperation> &ops,
+                      std::vector<SignatureResult> *out_signatures = nullptr)
+    {
+        std::vector<ByteVector> ret;
+        ret.reserve(ops.size());
+        if (out_signatures)
+            out_signatures->resize(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            ret.push_back(aes_decrypt(ops[i].payload, ops[i].key_name, ops[i].iv,
+                                      out_signatures ? &(*out_signatures)[i] : nullptr));
+        }
+        return ret;
+    }
+
     virtual void iso_authenticate_step1(const std::string &key_identity,
                                         const ByteVector &random_picc,
                                         const MyDivInfo &div_info, bool &out_success,
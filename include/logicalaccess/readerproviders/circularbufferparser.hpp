@@ -14,6 +14,16 @@
 
 namespace logicalaccess
 {
+/**
+ * \brief Checksum ending a frame, computed over all the frame bytes before it.
+ */
+enum class FrameChecksum
+{
+    NONE, /**< No checksum. */
+    XOR8, /**< One byte, XOR of the bytes. */
+    SUM8  /**< One byte, sum of the bytes modulo 256. */
+};
+
 class LLA_CORE_API CircularBufferParser
 {
   public:
@@ -27,6 +37,14 @@ class LLA_CORE_API CircularBufferParser
 
     virtual ByteVector
     getValidBuffer(boost::circular_buffer<unsigned char> &circular_buffer);
+
+    /**
+     * \brief Check the checksum ending a frame.
+     * \param checksum The checksum type.
+     * \param frame The complete frame, checksum included.
+     * \return True if the checksum matches or there is none, false otherwise.
+     */
+    static bool isChecksumValid(FrameChecksum checksum, const ByteVector &frame);
 };
 }
 
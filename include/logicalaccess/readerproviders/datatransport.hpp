@@ -9,7 +9,13 @@
 
 #include <logicalaccess/lla_fwd.hpp>
 #include <logicalaccess/readerproviders/readerprovider.hpp>
+#include <logicalaccess/readerproviders/transportmetrics.hpp>
+#include <logicalaccess/readerproviders/tracerecorder.hpp>
 
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 #include <vector>
 
 namespace logicalaccess
@@ -21,6 +27,15 @@ namespace logicalaccess
 class LLA_CORE_API DataTransport : public XmlSerializable
 {
   public:
+    /**
+     * \brief Callback invoked when an asynchronous command completes.
+     *
+     * On failure the result is empty and the exception pointer is set.
+     */
+    using CommandCallback = std::function<void(const ByteVector &, std::exception_ptr)>;
+
+    DataTransport();
+
     virtual ~DataTransport() = default;
 
     /**
@@ -78,6 +93,55 @@ class LLA_CORE_API DataTransport : public XmlSerializable
      */
     virtual ByteVector sendCommand(const ByteVector &command, long int timeout = -1);
 
+    /**
+     * \brief Send a batch of independent commands to the reader.
+     *
+     * The default implementation sends the commands one after the other.
+     * Transports able to pipeline commands override it.
+     * \param commands The command buffers.
+     * \param timeout The timeout of each command.
+     * \return The results, in the commands order.
+     */
+    virtual std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                                 long int timeout = -1);
+
+    /**
+     * \brief Send a command to the reader without blocking the caller.
+     *
+     * TCP, UDP and serial port transports run the command as non-blocking I/O on
+     * the shared TransportReactor, so a few threads drive any number of readers.
+     * Commands queued on the same transport are executed in order, never
+     * concurrently, and must not be mixed with blocking commands. Destroying the
+     * transport aborts its pending commands.
+     *
+     * This default implementation, used by transports without event-driven I/O,
+     * runs the blocking sendCommand() and invokes the callback before returning.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \param callback Invoked with the result or the error. The reactor invokes it
+     * on a command thread, where it may block.
+     */
+    virtual void asyncSendCommand(const ByteVector &command, long int timeout,
+                                  CommandCallback callback);
+
+    /**
+     * \brief Send a command to the reader without blocking the caller.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \return A future holding the result of the command.
+     */
+    std::future<ByteVector> asyncSendCommand(const ByteVector &command,
+                                             long int timeout = -1);
+
+    /**
+     * \brief Get the counters and latency histogram of this transport.
+     * \return The transport metrics.
+     */
+    std::shared_ptr<TransportMetrics> getMetrics() const
+    {
+        return d_metrics;
+    }
+
     /**
      * \brief Get the last command.
      * \return The last command.
@@ -101,6 +165,59 @@ class LLA_CORE_API DataTransport : public XmlSerializable
 
     virtual ByteVector receive(long int timeout) = 0;
 
+    /**
+     * \brief Get if sendCommand() must connect the transport before sending.
+     * \return True to call connect() before each command, false otherwise.
+     */
+    virtual bool connectBeforeCommand() const
+    {
+        return true;
+    }
+
+    /**
+     * \brief Get if the traffic is written to the global trace recorder.
+     * \return True if traced, false otherwise.
+     */
+    virtual bool isTraced() const
+    {
+        return true;
+    }
+
+    /**
+     * \brief Log, trace and remember a command about to be sent.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     */
+    void commandStarted(const ByteVector &command, long int timeout);
+
+    /**
+     * \brief Record, trace and remember the result of a command.
+     * \param command The command buffer.
+     * \param result The command result.
+     * \param latency The time from sending the command to receiving the result.
+     */
+    void commandCompleted(const ByteVector &command, const ByteVector &result,
+                          std::chrono::steady_clock::duration latency);
+
+    /**
+     * \brief Record and trace a failed command.
+     * \param eptr The error.
+     */
+    void commandFailed(std::exception_ptr eptr);
+
+    /**
+     * \brief Write a record to the global trace recorder, if any.
+     * \param direction The record kind.
+     * \param data The raw bytes.
+     */
+    void trace(TraceDirection direction, const ByteVector &data) const;
+
+    /**
+     * \brief Write the exception being handled to the global trace recorder, if any.
+     * Must be called from a catch block.
+     */
+    void traceCurrentException() const;
+
     /**
      * \brief The reader unit.
      */
@@ -115,6 +232,11 @@ class LLA_CORE_API DataTransport : public XmlSerializable
      * \brief The last command.
      */
     ByteVector d_lastCommand;
+
+    /**
+     * \brief The transport counters.
+     */
+    std::shared_ptr<TransportMetrics> d_metrics;
 };
 }
 
@@ -0,0 +1,52 @@
+/**
+ * \file delimiterbufferparser.hpp
+ * \brief A CircularBufferParser for STX/ETX delimited frames.
+ */
+
+#ifndef DELIMITERBUFFERPARSER_HPP
+#define DELIMITERBUFFERPARSER_HPP
+
+#include <logicalaccess/readerproviders/circularbufferparser.hpp>
+
+namespace logicalaccess
+{
+/**
+ * \brief Extract frames starting with a STX byte and ending with an ETX byte,
+ * optionally followed by a fixed size trailer (checksum).
+ *
+ * Bytes received before the STX byte are discarded. When a checksum is used,
+ * it is the last byte of the trailer; on mismatch the STX byte is dropped and
+ * the next one is searched.
+ */
+class LLA_CORE_API DelimiterBufferParser : public CircularBufferParser
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param stx The start of frame byte.
+     * \param etx The end of frame byte.
+     * \param trailerSize Size of the data following the ETX byte.
+     * \param checksum The checksum ending the trailer.
+     */
+    DelimiterBufferParser(unsigned char stx, unsigned char etx, size_t trailerSize = 0,
+                          FrameChecksum checksum = FrameChecksum::NONE);
+
+    virtual ~DelimiterBufferParser()
+    {
+    }
+
+    ByteVector
+    getValidBuffer(boost::circular_buffer<unsigned char> &circular_buffer) override;
+
+  protected:
+    unsigned char d_stx;
+
+    unsigned char d_etx;
+
+    size_t d_trailerSize;
+
+    FrameChecksum d_checksum;
+};
+}
+
+#endif /* DELIMITERBUFFERPARSER_HPP */
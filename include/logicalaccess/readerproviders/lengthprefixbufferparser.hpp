@@ -0,0 +1,66 @@
+/**
+ * \file lengthprefixbufferparser.hpp
+ * \brief A CircularBufferParser for length prefixed frames.
+ */
+
+#ifndef LENGTHPREFIXBUFFERPARSER_HPP
+#define LENGTHPREFIXBUFFERPARSER_HPP
+
+#include <logicalaccess/readerproviders/circularbufferparser.hpp>
+
+namespace logicalaccess
+{
+/**
+ * \brief Extract frames made of a fixed size header holding the payload length,
+ * the payload and a fixed size trailer (checksum, end byte...).
+ *
+ * Frame size is headerSize + length + trailerSize, where length is read
+ * at lengthOffset on lengthSize bytes. When a checksum is used, it is the last
+ * byte of the trailer.
+ *
+ * A length above the maximum or a bad checksum means the buffer is not aligned
+ * on a frame: the first byte is dropped and parsing starts again.
+ */
+class LLA_CORE_API LengthPrefixBufferParser : public CircularBufferParser
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param lengthOffset Offset of the length field in the frame.
+     * \param lengthSize Size of the length field, 1 to 4 bytes.
+     * \param headerSize Size of the header, including the length field.
+     * \param trailerSize Size of the data following the payload.
+     * \param bigEndian True if the length field is big endian.
+     * \param checksum The checksum ending the trailer.
+     * \param maxLength The largest valid value of the length field.
+     */
+    LengthPrefixBufferParser(size_t lengthOffset, size_t lengthSize, size_t headerSize,
+                             size_t trailerSize = 0, bool bigEndian = true,
+                             FrameChecksum checksum = FrameChecksum::NONE,
+                             size_t maxLength = 4096);
+
+    virtual ~LengthPrefixBufferParser()
+    {
+    }
+
+    ByteVector
+    getValidBuffer(boost::circular_buffer<unsigned char> &circular_buffer) override;
+
+  protected:
+    size_t d_lengthOffset;
+
+    size_t d_lengthSize;
+
+    size_t d_headerSize;
+
+    size_t d_trailerSize;
+
+    bool d_bigEndian;
+
+    FrameChecksum d_checksum;
+
+    size_t d_maxLength;
+};
+}
+
+#endif /* LENGTHPREFIXBUFFERPARSER_HPP */
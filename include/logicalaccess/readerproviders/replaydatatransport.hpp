@@ -0,0 +1,159 @@
+/**
+ * \file replaydatatransport.hpp
+ * \brief Data transport replaying a recorded trace.
+ */
+
+#ifndef LOGICALACCESS_REPLAYDATATRANSPORT_HPP
+#define LOGICALACCESS_REPLAYDATATRANSPORT_HPP
+
+#include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/readerproviders/tracerecorder.hpp>
+
+namespace logicalaccess
+{
+#define TRANSPORT_REPLAY "Replay"
+
+/**
+ * \brief A data transport answering with the responses of a trace recorded by
+ * TraceRecorder, without any reader.
+ *
+ * Each command consumes the next recorded command and returns the response
+ * recorded after it. A recorded error is raised again as an exception. This
+ * makes a captured session usable as a deterministic test or benchmark of the
+ * command layers.
+ */
+class LLA_CORE_API ReplayDataTransport : public DataTransport
+{
+  public:
+    ReplayDataTransport();
+
+    /**
+     * \brief Constructor.
+     * \param filename The trace file to replay.
+     * \param transport Only replay the records of this transport, empty for all.
+     */
+    explicit ReplayDataTransport(const std::string &filename,
+                                 const std::string &transport = "");
+
+    /**
+     * \brief Get the transport type of this instance.
+     * \return The transport type.
+     */
+    std::string getTransportType() const override
+    {
+        return TRANSPORT_REPLAY;
+    }
+
+    bool connect() override;
+
+    void disconnect() override;
+
+    bool isConnected() override;
+
+    /**
+     * \brief Get the data transport endpoint name.
+     * \return The trace file path.
+     */
+    std::string getName() const override;
+
+    /**
+     * \brief Load a trace file and rewind.
+     * \param filename The trace file path.
+     */
+    void setTraceFile(const std::string &filename);
+
+    /**
+     * \brief Get the trace file path.
+     * \return The trace file path.
+     */
+    std::string getTraceFile() const;
+
+    /**
+     * \brief Only replay the records of a transport.
+     * \param transport The transport, as recorded ("<type>:<name>"), empty for all.
+     */
+    void setTransportFilter(const std::string &transport);
+
+    /**
+     * \brief Get the replayed transport.
+     * \return The transport, empty for all.
+     */
+    std::string getTransportFilter() const;
+
+    /**
+     * \brief Check the sent commands against the recorded ones.
+     * \param strict True to raise an exception on a different command.
+     */
+    void setStrict(bool strict);
+
+    bool isStrict() const;
+
+    /**
+     * \brief Restart the replay from the first record.
+     */
+    void rewind();
+
+    /**
+     * \brief Get if all the recorded commands were replayed.
+     * \return True at the end of the trace.
+     */
+    bool isFinished() const;
+
+    /**
+     * \brief Serialize the current object to XML.
+     * \param parentNode The parent node.
+     */
+    void serialize(boost::property_tree::ptree &parentNode) override;
+
+    /**
+     * \brief UnSerialize a XML node to the current object.
+     * \param node The XML node.
+     */
+    void unSerialize(boost::property_tree::ptree &node) override;
+
+    /**
+     * \brief Get the default Xml Node name for this object.
+     * \return The Xml node name.
+     */
+    std::string getDefaultXmlNodeName() const override;
+
+  protected:
+    /**
+     * \brief Replayed traffic is not recorded again.
+     * \return False.
+     */
+    bool isTraced() const override
+    {
+        return false;
+    }
+
+    void send(const ByteVector &data) override;
+
+    ByteVector receive(long int timeout) override;
+
+    /**
+     * \brief Move to the next record of the replayed transport.
+     * \return The record, null at the end of the trace.
+     */
+    const TraceRecord *nextRecord();
+
+    std::string d_filename;
+
+    std::string d_transportFilter;
+
+    bool d_strict;
+
+    bool d_connected;
+
+    std::vector<TraceRecord> d_records;
+
+    size_t d_position;
+
+    /**
+     * \brief True when send() already consumed the command of the pending receive().
+     */
+    bool d_commandSent;
+};
+}
+
+#endif /* LOGICALACCESS_REPLAYDATATRANSPORT_HPP */
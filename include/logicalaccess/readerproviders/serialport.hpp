@@ -19,12 +19,18 @@
 #include <boost/circular_buffer.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <condition_variable>
+#include <functional>
 
 #include <logicalaccess/readerproviders/readerunit.hpp>
 #include <logicalaccess/readerproviders/circularbufferparser.hpp>
 
 namespace logicalaccess
 {
+/**
+ * \brief Maximum amount of received data buffered while the consumer lags behind.
+ */
+#define SERIAL_MAX_READ_BUFFER_SIZE 65536
+
 /**
  * \brief A class that represents a serial (COM) port.
  *
@@ -160,6 +166,17 @@ class LLA_CORE_API SerialPort
     {
         m_circular_buffer_parser.reset(circular_buffer_parser);
     }
+
+    /**
+     * \brief Share a parser with other serial ports. The parser must not hold
+     * any parsing state.
+     * \param circular_buffer_parser The parser.
+     */
+    void setCircularBufferParser(
+        std::shared_ptr<CircularBufferParser> circular_buffer_parser)
+    {
+        m_circular_buffer_parser = circular_buffer_parser;
+    }
     std::shared_ptr<CircularBufferParser> getCircularBufferParser() const
     {
         return m_circular_buffer_parser;
@@ -203,6 +220,16 @@ class LLA_CORE_API SerialPort
      */
     void dataConsumed();
 
+    /**
+     * \brief Set a handler invoked by the reader thread each time data are received.
+     *
+     * The handler runs with the internal mutex held: it must not block, only
+     * schedule the read. Once this method returns, the previous handler is no
+     * longer invoked.
+     * \param handler The handler, or null to remove it.
+     */
+    void setDataHandler(std::function<void()> handler);
+
   private:
     void do_read(const boost::system::error_code &e, size_t bytes_transferred);
 
@@ -222,6 +249,10 @@ class LLA_CORE_API SerialPort
 
     boost::asio::serial_port m_serial_port;
 
+    /**
+     * \brief Received data, grown up to SERIAL_MAX_READ_BUFFER_SIZE. Beyond that,
+     * the oldest data, in which the parser found no frame, are dropped.
+     */
     boost::circular_buffer<unsigned char> m_circular_read_buffer;
 
     ByteVector m_read_buffer;
@@ -239,6 +270,11 @@ class LLA_CORE_API SerialPort
     std::condition_variable cond_var_;
     bool data_flag_;
     std::mutex cond_var_mutex_;
+
+    /**
+     * \brief Invoked on data reception, guarded by cond_var_mutex_.
+     */
+    std::function<void()> m_data_handler;
 };
 }
 
@@ -9,6 +9,13 @@
 
 #include <logicalaccess/readerproviders/datatransport.hpp>
 #include <logicalaccess/readerproviders/serialportxml.hpp>
+#include <logicalaccess/readerproviders/transportreactor.hpp>
+#include <boost/asio/deadline_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 namespace logicalaccess
 {
@@ -16,6 +23,10 @@ namespace logicalaccess
 
 /**
  * \brief A serial port data transport class.
+ *
+ * asyncSendCommand() waits for the answer on the shared TransportReactor: the
+ * serial port reader thread signals each reception, and the frame is parsed by a
+ * non-blocking handler. The port is opened by the caller of the first command.
  */
 class LLA_CORE_API SerialPortDataTransport : public DataTransport
 {
@@ -79,9 +90,18 @@ class LLA_CORE_API SerialPortDataTransport : public DataTransport
     /**
      * \brief Start to auto-detect the first serial port with a reader. Update serial port
      * when found.
+     *
+     * All the enumerated ports are probed concurrently with the reader ping command,
+     * the first one to answer wins. The result is cached per transport type, later
+     * detections only check the cached port is still answering.
      */
     virtual void startAutoDetect();
 
+    /**
+     * \brief Forget the serial ports found by previous auto-detections.
+     */
+    static void clearAutoDetectCache();
+
     /**
      * \brief Serialize the current object to XML.
      * \param parentNode The parent node.
@@ -132,7 +152,31 @@ class LLA_CORE_API SerialPortDataTransport : public DataTransport
 
     ByteVector receive(long int timeout) override;
 
+    /**
+     * \brief Send a command, waiting for the answer on the shared reactor.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \param callback Invoked on a command thread with the result or the error.
+     */
+    void asyncSendCommand(const ByteVector &command, long int timeout,
+                          CommandCallback callback) override;
+
+    using DataTransport::asyncSendCommand;
+
   protected:
+    /**
+     * \brief Probe a serial port with a command.
+     * \param port The serial port, closed on return.
+     * \param cmd The command to send.
+     * \param parser The parser validating the answer, may be null.
+     * \param timeout The time to wait for an answer, in milliseconds.
+     * \param cancelled Stop waiting as soon as it is set.
+     * \return True if the port answered.
+     */
+    bool probePort(std::shared_ptr<SerialPortXml> port, const ByteVector &cmd,
+                   std::shared_ptr<CircularBufferParser> parser, long int timeout,
+                   const std::atomic<bool> &cancelled) const;
+
     /**
      * \brief The auto-detected status
      */
@@ -147,6 +191,50 @@ class LLA_CORE_API SerialPortDataTransport : public DataTransport
      * \brief The baudrate to use when configuring the serial port.
      */
     unsigned long d_portBaudRate;
+
+  private:
+    void asyncStart(const AsyncCommandQueue::Command &command);
+
+    void asyncAbort();
+
+    /**
+     * \brief Try to read the answer of the running command.
+     */
+    void asyncRead();
+
+    /**
+     * \brief Stop waiting for data. The timer handler then completes the command.
+     */
+    void asyncFinish();
+
+    /**
+     * \brief The running asynchronous command.
+     */
+    ByteVector d_asyncCommand;
+
+    ByteVector d_asyncResult;
+
+    std::chrono::steady_clock::time_point d_asyncSendTime;
+
+    std::shared_ptr<SerialPort> d_asyncPort;
+
+    bool d_asyncRunning;
+
+    bool d_asyncAborted;
+
+    /**
+     * \brief Reactor objects, created by the first asynchronous command.
+     */
+    std::once_flag d_asyncInit;
+
+    std::unique_ptr<boost::asio::io_service::strand> d_ioStrand;
+
+    std::unique_ptr<boost::asio::deadline_timer> d_timer;
+
+    /**
+     * \brief The asynchronous commands. Declared last, so it is closed first.
+     */
+    std::unique_ptr<AsyncCommandQueue> d_asyncCommands;
 };
 }
 
@@ -8,16 +8,43 @@
 #define LOGICALACCESS_TCPDATATRANSPORT_HPP
 
 #include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/readerproviders/circularbufferparser.hpp>
+#include <logicalaccess/readerproviders/transportreactor.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <chrono>
 
 namespace logicalaccess
 {
 #define TRANSPORT_TCP "TCP"
 
+/**
+ * \brief Size of the buffer used for a single socket read.
+ */
+#define TCP_READ_CHUNK_SIZE 1024
+
+/**
+ * \brief Maximum amount of data buffered while waiting for a complete frame.
+ */
+#define TCP_MAX_FRAME_BUFFER_SIZE 65536
+
 /**
  * \brief An TCP data transport class.
+ *
+ * The socket is registered with the process-wide TransportReactor. Blocking
+ * operations start asynchronous I/O on the reactor and wait for its completion,
+ * so many transports share a few I/O threads.
+ *
+ * In persistent mode the connection is kept open across commands and only
+ * re-established after an error, saving a TCP handshake per command.
+ *
+ * When a CircularBufferParser is set, receive() accumulates the incoming data
+ * until the parser extracts one complete frame. Bytes following the frame are
+ * kept for the next call.
+ *
+ * asyncSendCommand() connects, writes and reads frames with non-blocking
+ * handlers on the reactor. It does not probe idle persistent connections.
  */
 class LLA_CORE_API TCPDataTransport : public DataTransport
 {
@@ -113,6 +140,93 @@ class LLA_CORE_API TCPDataTransport : public DataTransport
      */
     void setPort(int port);
 
+    /**
+     * \brief Get if the connection is kept open across commands.
+     * \return True in persistent mode, false otherwise.
+     */
+    bool isPersistentConnection() const;
+
+    /**
+     * \brief Set if the connection is kept open across commands.
+     *
+     * In persistent mode, connect() reuses an open socket and TCP_NODELAY and
+     * SO_KEEPALIVE are enabled on new connections. The socket is reopened
+     * lazily when the peer closed it or an I/O error occurred.
+     * \param persistent True to enable the persistent mode.
+     */
+    void setPersistentConnection(bool persistent);
+
+    /**
+     * \brief Get the idle delay after which a persistent connection is probed.
+     * \return The delay in milliseconds, 0 if probing is disabled.
+     */
+    long int getHealthCheckInterval() const;
+
+    /**
+     * \brief Set the idle delay after which a persistent connection is probed.
+     *
+     * When the connection has been idle longer than this delay, connect() sends
+     * the reader ping command before reusing it, and reconnects if the reader
+     * does not answer.
+     * \param interval The delay in milliseconds, 0 to disable probing.
+     */
+    void setHealthCheckInterval(long int interval);
+
+    /**
+     * \brief Get if command batches are pipelined.
+     * \return True if pipelining is enabled.
+     */
+    bool isPipelining() const;
+
+    /**
+     * \brief Set if command batches are pipelined.
+     *
+     * When enabled and a frame parser is set, sendCommands() writes the whole
+     * batch at once then reads one frame per command. Only enable it for readers
+     * queuing commands and answering them in order.
+     * \param pipelining True to enable pipelining.
+     */
+    void setPipelining(bool pipelining);
+
+    /**
+     * \brief Send a batch of independent commands, pipelined when enabled.
+     * \param commands The command buffers.
+     * \param timeout The timeout of each command.
+     * \return The results, in the commands order.
+     */
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long int timeout = -1) override;
+
+    /**
+     * \brief Send a command with non-blocking I/O on the shared reactor.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \param callback Invoked on a command thread with the result or the error.
+     */
+    void asyncSendCommand(const ByteVector &command, long int timeout,
+                          CommandCallback callback) override;
+
+    using DataTransport::asyncSendCommand;
+
+    /**
+     * \brief Set the frame parser used by receive(). Take ownership of the parser.
+     * \param circular_buffer_parser The parser, or null to return raw reads.
+     */
+    void setCircularBufferParser(CircularBufferParser *circular_buffer_parser)
+    {
+        d_circular_buffer_parser.reset(circular_buffer_parser);
+        d_receiveBuffer.clear();
+    }
+
+    /**
+     * \brief Get the frame parser used by receive().
+     * \return The parser.
+     */
+    std::shared_ptr<CircularBufferParser> getCircularBufferParser() const
+    {
+        return d_circular_buffer_parser;
+    }
+
     /**
      * \brief Send data packet
      * \param data The packet.
@@ -121,6 +235,9 @@ class LLA_CORE_API TCPDataTransport : public DataTransport
 
     /**
      * \brief Receive packet
+     *
+     * Without frame parser, return the data of a single socket read. Otherwise
+     * return exactly one frame.
      * \param timeout Time waiting for data.
      * \return The data receive.
      */
@@ -147,9 +264,59 @@ class LLA_CORE_API TCPDataTransport : public DataTransport
 
   protected:
     /**
-     * \brief Provides core I/O functionality
+     * \brief Read once from the socket into the read buffer.
+     * \param timeout Time waiting for data.
+     * \return The count of bytes read, 0 on timeout or error.
+     */
+    size_t receiveSome(long int timeout);
+
+    /**
+     * \brief Check that an open persistent connection can be reused.
+     *
+     * Discard data received since the last command (unless the reader sends
+     * unsolicited data), detect a connection closed by the peer and probe the
+     * reader when idle for too long.
+     * \param timeout The probe timeout.
+     * \return True if the connection is usable, false otherwise.
+     */
+    virtual bool checkConnection(long int timeout);
+
+    /**
+     * \brief The non-blocking part of checkConnection(), without the probe.
+     * \return True if the peer did not close the connection, false otherwise.
+     */
+    bool checkSocket();
+
+    /**
+     * \brief Append the last socket read to the frame buffer, growing it up to
+     * TCP_MAX_FRAME_BUFFER_SIZE.
+     * \param len The count of bytes read.
+     */
+    void appendReceived(size_t len);
+
+    /**
+     * \brief Get if the reader sends data on its own, such as badge events.
+     *
+     * Such data is kept for receive() instead of being discarded as stale when a
+     * persistent connection is reused.
+     * \return True if unsolicited data is expected, false otherwise.
+     */
+    virtual bool isUnsolicitedDataExpected() const
+    {
+        return false;
+    }
+
+    /**
+     * \brief Send the reader ping command and wait for an answer.
+     * \param timeout The probe timeout.
+     * \return True if the reader answered, false otherwise.
+     */
+    virtual bool probeConnection(long int timeout);
+
+    /**
+     * \brief Serialize this transport handlers on the shared reactor.
      */
-    boost::asio::io_service d_ios;
+    boost::asio::io_service::strand d_ioStrand;
 
     /**
      * \brief TCP Socket
@@ -171,6 +338,51 @@ class LLA_CORE_API TCPDataTransport : public DataTransport
 */
     size_t d_bytes_transferred;
 
+    /**
+     * \brief Pending I/O handlers synchronization.
+     */
+    PendingHandlers d_handlers;
+
+    /**
+     * \brief Last error reported by an I/O handler.
+     */
+    boost::system::error_code d_last_error;
+
+    /**
+     * \brief Keep the connection open across commands.
+     */
+    bool d_persistentConnection;
+
+    /**
+     * \brief Idle delay before probing a persistent connection, 0 to disable.
+     */
+    long int d_healthCheckInterval;
+
+    /**
+     * \brief Pipeline command batches.
+     */
+    bool d_pipelining;
+
+    /**
+     * \brief Time of the last successful I/O.
+     */
+    std::chrono::steady_clock::time_point d_lastActivity;
+
+    /**
+     * \brief The frame parser.
+     */
+    std::shared_ptr<CircularBufferParser> d_circular_buffer_parser;
+
+    /**
+     * \brief Data received but not yet returned as a frame.
+     */
+    boost::circular_buffer<unsigned char> d_receiveBuffer;
+
+    /**
+     * \brief Reusable buffer for socket reads.
+     */
+    ByteVector d_readBuffer;
+
     /**
      * \brief The ip address
      */
@@ -180,6 +392,74 @@ class LLA_CORE_API TCPDataTransport : public DataTransport
      * \brief The listening port.
      */
     int d_port;
+
+  private:
+    /**
+     * \brief The step of the running asynchronous command.
+     */
+    enum class AsyncStep
+    {
+        Connect,
+        Send,
+        Receive
+    };
+
+    void asyncStart(const AsyncCommandQueue::Command &command);
+
+    void asyncAbort();
+
+    void asyncConnect();
+
+    void asyncSend();
+
+    void asyncReceive();
+
+    /**
+     * \brief Start an I/O step bounded by the command deadline.
+     */
+    void asyncArmTimer(AsyncStep step);
+
+    /**
+     * \brief Handle the end of the I/O or of the timer of the current step.
+     */
+    void asyncStepDone();
+
+    void asyncSucceed(const ByteVector &result);
+
+    void asyncFail(const std::string &message);
+
+    /**
+     * \brief The running asynchronous command.
+     */
+    ByteVector d_asyncCommand;
+
+    long int d_asyncTimeout;
+
+    std::chrono::steady_clock::time_point d_asyncSendTime;
+
+    std::chrono::steady_clock::time_point d_asyncDeadline;
+
+    AsyncStep d_asyncStep;
+
+    /**
+     * \brief Handlers of the current step still to run: the I/O and the timer.
+     */
+    int d_asyncWaiting;
+
+    boost::system::error_code d_asyncError;
+
+    size_t d_asyncTransferred;
+
+    bool d_asyncTimedOut;
+
+    bool d_asyncAborted;
+
+    bool d_asyncFirstRead;
+
+    /**
+     * \brief The asynchronous commands. Declared last, so it is closed first.
+     */
+    AsyncCommandQueue d_asyncCommands;
 };
 }
 
@@ -0,0 +1,195 @@
+/**
+ * \file tracerecorder.hpp
+ * \brief Binary trace of the data transports traffic.
+ */
+
+#ifndef LOGICALACCESS_TRACERECORDER_HPP
+#define LOGICALACCESS_TRACERECORDER_HPP
+
+#include <logicalaccess/lla_core_api.hpp>
+#include <logicalaccess/lla_fwd.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief The kind of a trace record.
+ */
+enum class TraceDirection : uint8_t
+{
+    /**
+     * \brief Bytes sent to the reader.
+     */
+    Command = 1,
+
+    /**
+     * \brief Bytes received from the reader.
+     */
+    Response = 2,
+
+    /**
+     * \brief The transport failed, data holds the error message.
+     */
+    Error = 3
+};
+
+/**
+ * \brief A trace record.
+ */
+struct TraceRecord
+{
+    /**
+     * \brief Microseconds elapsed since the trace started.
+     */
+    uint64_t timestamp;
+
+    /**
+     * \brief The transport, as "<transport type>:<endpoint name>".
+     */
+    std::string transport;
+
+    TraceDirection direction;
+
+    ByteVector data;
+};
+
+/**
+ * \brief Write the raw traffic of the data transports to a compact binary file.
+ *
+ * Unlike the COMS log, nothing is formatted: each record is a small fixed
+ * header followed by the raw bytes. Transport names are written once and then
+ * referred to by index.
+ *
+ * File layout, all integers little-endian:
+ * - header: "LLATRACE", u16 version, u64 start time (microseconds since epoch)
+ * - transport declaration: u8 0, u16 id, u16 name length, name
+ * - data record: u8 direction, u16 transport id, u64 timestamp, u32 length, bytes
+ *
+ * Once installed with setGlobal(), every DataTransport records its commands,
+ * responses and errors to it.
+ */
+class LLA_CORE_API TraceRecorder
+{
+  public:
+    /**
+     * \brief Create a trace file, truncating any existing one.
+     * \param filename The trace file path.
+     */
+    explicit TraceRecorder(const std::string &filename);
+
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /**
+     * \brief Append a record. Thread-safe.
+     * \param transport The transport name.
+     * \param direction The record kind.
+     * \param data The raw bytes.
+     */
+    void record(const std::string &transport, TraceDirection direction,
+                const ByteVector &data);
+
+    /**
+     * \brief Flush the pending records to disk.
+     */
+    void flush();
+
+    /**
+     * \brief Get the count of data records written.
+     * \return The records count.
+     */
+    uint64_t getRecordCount() const;
+
+    /**
+     * \brief Install the recorder all data transports write to.
+     * \param recorder The recorder, null to stop recording.
+     */
+    static void setGlobal(std::shared_ptr<TraceRecorder> recorder);
+
+    /**
+     * \brief Get the recorder all data transports write to.
+     * \return The recorder, null when not recording.
+     */
+    static std::shared_ptr<TraceRecorder> getGlobal();
+
+    /**
+     * \brief The trace file format version.
+     */
+    static const uint16_t VERSION = 1;
+
+  private:
+    void writeU8(uint8_t value);
+
+    void writeU16(uint16_t value);
+
+    void writeU32(uint32_t value);
+
+    void writeU64(uint64_t value);
+
+    std::mutex d_mutex;
+
+    std::ofstream d_file;
+
+    std::chrono::steady_clock::time_point d_start;
+
+    std::map<std::string, uint16_t> d_transports;
+
+    std::atomic<uint64_t> d_records;
+
+    static std::shared_ptr<TraceRecorder> s_global;
+
+    /**
+     * \brief Avoid the shared_ptr atomic access when nothing is recorded.
+     */
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * \brief Read a trace file written by TraceRecorder.
+ */
+class LLA_CORE_API TraceReader
+{
+  public:
+    /**
+     * \brief Load a trace file.
+     * \param filename The trace file path.
+     */
+    explicit TraceReader(const std::string &filename);
+
+    /**
+     * \brief Get the time the trace started.
+     * \return Microseconds since epoch.
+     */
+    uint64_t getStartTime() const
+    {
+        return d_startTime;
+    }
+
+    /**
+     * \brief Get the trace records, in recording order.
+     * \return The records.
+     */
+    const std::vector<TraceRecord> &getRecords() const
+    {
+        return d_records;
+    }
+
+  private:
+    uint64_t d_startTime;
+
+    std::vector<TraceRecord> d_records;
+};
+}
+
+#endif /* LOGICALACCESS_TRACERECORDER_HPP */
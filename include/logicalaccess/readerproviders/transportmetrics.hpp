@@ -0,0 +1,121 @@
+/**
+ * \file transportmetrics.hpp
+ * \brief Counters and latency histogram of a data transport.
+ */
+
+#ifndef LOGICALACCESS_TRANSPORTMETRICS_HPP
+#define LOGICALACCESS_TRANSPORTMETRICS_HPP
+
+#include <logicalaccess/lla_core_api.hpp>
+#include <logicalaccess/plugins/llacommon/loglinearhistogram.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace logicalaccess
+{
+/**
+ * \brief Counters and latency histogram of a data transport.
+ *
+ * All updates are lock-free and can happen from any thread. Latencies are
+ * recorded in microseconds in a LogLinearHistogram, so any recorded value is
+ * known within 6.25%, from 1 microsecond up to more than 19 hours.
+ */
+class LLA_CORE_API TransportMetrics
+{
+  public:
+    TransportMetrics();
+
+    TransportMetrics(const TransportMetrics &) = delete;
+    TransportMetrics &operator=(const TransportMetrics &) = delete;
+
+    /**
+     * \brief Record a command round trip.
+     * \param bytesOut The command size.
+     * \param bytesIn The response size.
+     * \param latency The time between sending the command and receiving the response.
+     */
+    void recordCommand(size_t bytesOut, size_t bytesIn,
+                       std::chrono::steady_clock::duration latency);
+
+    /**
+     * \brief Record a command without response in the allowed time.
+     */
+    void recordTimeout();
+
+    /**
+     * \brief Record a failed command (exception raised by the transport).
+     */
+    void recordError();
+
+    /**
+     * \brief Record a connection re-established after it was lost.
+     */
+    void recordReconnect();
+
+    uint64_t getCommandCount() const;
+
+    uint64_t getBytesOut() const;
+
+    uint64_t getBytesIn() const;
+
+    uint64_t getTimeoutCount() const;
+
+    uint64_t getErrorCount() const;
+
+    uint64_t getReconnectCount() const;
+
+    /**
+     * \brief Get the lowest recorded latency.
+     * \return The latency in microseconds, 0 if nothing was recorded.
+     */
+    uint64_t getMinLatency() const;
+
+    /**
+     * \brief Get the highest recorded latency.
+     * \return The latency in microseconds, 0 if nothing was recorded.
+     */
+    uint64_t getMaxLatency() const;
+
+    /**
+     * \brief Get the mean latency.
+     * \return The latency in microseconds, 0 if nothing was recorded.
+     */
+    uint64_t getMeanLatency() const;
+
+    /**
+     * \brief Get a latency percentile.
+     * \param percentile The percentile, between 0 and 100.
+     * \return The latency in microseconds, 0 if nothing was recorded.
+     */
+    uint64_t getLatencyPercentile(double percentile) const;
+
+    /**
+     * \brief Reset all counters.
+     */
+    void reset();
+
+    /**
+     * \brief Export the counters and the main latency percentiles.
+     * \return A JSON object, latencies are in microseconds.
+     */
+    std::string toJson() const;
+
+  private:
+    std::atomic<uint64_t> d_commands;
+    std::atomic<uint64_t> d_bytesOut;
+    std::atomic<uint64_t> d_bytesIn;
+    std::atomic<uint64_t> d_timeouts;
+    std::atomic<uint64_t> d_errors;
+    std::atomic<uint64_t> d_reconnects;
+    std::atomic<uint64_t> d_latencySum;
+    std::atomic<uint64_t> d_latencyMin;
+    std::atomic<uint64_t> d_latencyMax;
+    std::array<std::atomic<uint64_t>, LogLinearHistogram::BUCKET_COUNT> d_buckets;
+};
+}
+
+#endif /* LOGICALACCESS_TRANSPORTMETRICS_HPP */
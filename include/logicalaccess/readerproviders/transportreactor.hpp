@@ -0,0 +1,346 @@
+/**
+ * \file transportreactor.hpp
+ * \brief Shared event loop for data transports.
+ */
+
+#ifndef LOGICALACCESS_TRANSPORTREACTOR_HPP
+#define LOGICALACCESS_TRANSPORTREACTOR_HPP
+
+#include <logicalaccess/lla_core_api.hpp>
+#include <logicalaccess/lla_fwd.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Count the I/O handlers a transport started on the reactor and wait for them.
+ *
+ * Transports exposing a blocking API start asynchronous operations on the
+ * reactor I/O service, then wait for all their handlers to run.
+ */
+class LLA_CORE_API PendingHandlers
+{
+  public:
+    PendingHandlers();
+
+    /**
+     * \brief Start the reactor, post `start` on the strand and wait until `count`
+     * handlers have completed.
+     *
+     * Throws LibLogicalAccessException when called on a reactor I/O thread, which
+     * would otherwise wait forever for handlers only it could run.
+     * \param strand The transport I/O strand.
+     * \param count The number of handlers `start` initiates.
+     * \param start Initiates the asynchronous operations.
+     */
+    void run(boost::asio::io_service::strand &strand, int count,
+             const std::function<void()> &start);
+
+    /**
+     * \brief Count handlers about to be started.
+     * \param count The number of handlers.
+     */
+    void add(int count);
+
+    /**
+     * \brief Wait until all the counted handlers have completed.
+     */
+    void wait();
+
+    /**
+     * \brief Signal the completion of an I/O handler.
+     */
+    void completed();
+
+  private:
+    std::mutex d_mutex;
+
+    std::condition_variable d_cond;
+
+    int d_count;
+};
+
+/**
+ * \brief The asynchronous commands of one transport, run one at a time.
+ *
+ * The transport starts each command as a state machine of non-blocking handlers
+ * on its I/O strand, and reports the end of the command with complete().
+ * Completion callbacks are invoked on a command thread of the reactor, never on
+ * an I/O thread, so they may block or send blocking commands.
+ *
+ * Handlers referring to the transport must be created through wrap() or post(),
+ * so close() can wait for them. The transport destructor calls close() before
+ * releasing the sockets the handlers use.
+ */
+class LLA_CORE_API AsyncCommandQueue
+{
+  public:
+    /**
+     * \brief Callback invoked when a command completes.
+     */
+    using Callback = std::function<void(const ByteVector &, std::exception_ptr)>;
+
+    /**
+     * \brief A queued command.
+     */
+    struct Command
+    {
+        ByteVector command;
+        long int timeout;
+        Callback callback;
+    };
+
+    /**
+     * \brief Constructor.
+     * \param strand The transport I/O strand.
+     * \param start Start the state machine of a command. Invoked on the strand.
+     * \param abort Cancel the I/O of the running command. Invoked on the strand;
+     * the cancelled handlers must still run and complete() the command.
+     */
+    AsyncCommandQueue(boost::asio::io_service::strand &strand,
+                      std::function<void(const Command &)> start,
+                      std::function<void()> abort);
+
+    ~AsyncCommandQueue();
+
+    AsyncCommandQueue(const AsyncCommandQueue &) = delete;
+    AsyncCommandQueue &operator=(const AsyncCommandQueue &) = delete;
+
+    /**
+     * \brief Queue a command. It starts once the previous commands completed.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \param callback Invoked on a command thread with the result or the error.
+     */
+    void push(const ByteVector &command, long int timeout, Callback callback);
+
+    /**
+     * \brief End the running command and start the next one. Must be called on
+     * the strand.
+     * \param result The command result.
+     * \param eptr The error, if any.
+     */
+    void complete(const ByteVector &result, std::exception_ptr eptr);
+
+    /**
+     * \brief Wrap a handler of the running command on the strand.
+     * \param handler The handler, invoked exactly once.
+     * \return The wrapped handler.
+     */
+    template <typename Handler>
+    auto wrap(Handler handler)
+    {
+        d_handlers.add(1);
+        return d_strand.wrap(Tracked<Handler>{&d_handlers, std::move(handler)});
+    }
+
+    /**
+     * \brief Post a handler of the running command on the strand.
+     * \param handler The handler.
+     */
+    void post(const std::function<void()> &handler);
+
+    /**
+     * \brief Fail the queued commands, abort the running one and wait for all the
+     * handlers. No command can be queued afterward.
+     */
+    void close();
+
+  private:
+    /**
+     * \brief Signal the completion of a handler, even if it throws.
+     */
+    struct Completion
+    {
+        PendingHandlers *handlers;
+
+        ~Completion()
+        {
+            handlers->completed();
+        }
+    };
+
+    /**
+     * \brief A handler signaling its completion to close().
+     */
+    template <typename Handler>
+    struct Tracked
+    {
+        PendingHandlers *handlers;
+        Handler handler;
+
+        template <typename... Args>
+        void operator()(Args &&... args)
+        {
+            Completion completion{handlers};
+            handler(std::forward<Args>(args)...);
+        }
+    };
+
+    boost::asio::io_service::strand &d_strand;
+
+    std::function<void(const Command &)> d_start;
+
+    std::function<void()> d_abort;
+
+    /**
+     * \brief The queued commands, the front one is running. Only used on the strand.
+     */
+    std::deque<Command> d_commands;
+
+    bool d_closed;
+
+    /**
+     * \brief Set once a command was queued, close() has nothing to do otherwise.
+     */
+    std::atomic<bool> d_used;
+
+    PendingHandlers d_handlers;
+};
+
+/**
+ * \brief A process-wide event loop shared by all data transports.
+ *
+ * The reactor owns two io_service instances:
+ *  - the I/O service, on which transports register their sockets and timers.
+ *    Its handlers never block, so a few threads multiplex every reader.
+ *  - the command service, on which the callbacks of asynchronous commands are
+ *    invoked. They may block, as they often send the next command.
+ *
+ * Thread counts default to the `TransportReactorThreads` and
+ * `TransportWorkerThreads` settings. The threads start on first use.
+ */
+class LLA_CORE_API TransportReactor
+{
+  public:
+    /**
+     * \brief Get the reactor instance.
+     * \return The reactor instance.
+     */
+    static TransportReactor *getInstance();
+
+    /**
+     * \brief Destructor. Stop the worker threads.
+     */
+    ~TransportReactor();
+
+    TransportReactor(const TransportReactor &) = delete;
+    TransportReactor &operator=(const TransportReactor &) = delete;
+
+    /**
+     * \brief Get the shared I/O service. Only non-blocking handlers should run on it.
+     * \return The io_service.
+     */
+    boost::asio::io_service &getIOService()
+    {
+        return d_ios;
+    }
+
+    /**
+     * \brief Get the command service, on which handlers may block.
+     * \return The io_service.
+     */
+    boost::asio::io_service &getCommandService()
+    {
+        return d_commandIos;
+    }
+
+    /**
+     * \brief Start the worker threads if they are not running yet.
+     */
+    void start();
+
+    /**
+     * \brief Check whether the calling thread runs the I/O service.
+     * \return True on a reactor I/O thread, where blocking is forbidden.
+     */
+    static bool isIOThread();
+
+    /**
+     * \brief Stop the worker threads. Pending handlers are discarded.
+     */
+    void stop();
+
+    /**
+     * \brief Get the number of I/O threads used when the reactor starts.
+     * \return The thread count.
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * \brief Set the number of I/O threads. Takes effect on next start.
+     * \param count The thread count (at least 1).
+     */
+    void setThreadCount(size_t count);
+
+    /**
+     * \brief Get the number of command threads used when the reactor starts.
+     * \return The thread count.
+     */
+    size_t getWorkerCount() const;
+
+    /**
+     * \brief Set the number of command threads. Takes effect on next start.
+     * \param count The thread count (at least 1).
+     */
+    void setWorkerCount(size_t count);
+
+  protected:
+    TransportReactor();
+
+    /**
+     * \brief Run an io_service on count new threads.
+     * \param io True for the I/O threads, flagged for isIOThread().
+     */
+    static void spawn(boost::asio::io_service &ios, size_t count, bool io,
+                      std::vector<std::thread> &threads);
+
+    /**
+     * \brief Provides core I/O functionality.
+     */
+    boost::asio::io_service d_ios;
+
+    /**
+     * \brief Invokes the callbacks of asynchronous commands.
+     */
+    boost::asio::io_service d_commandIos;
+
+    /**
+     * \brief Keep the io_service instances running while no handler is pending.
+     */
+    std::unique_ptr<boost::asio::io_service::work> d_work;
+
+    std::unique_ptr<boost::asio::io_service::work> d_commandWork;
+
+    /**
+     * \brief The I/O and command threads.
+     */
+    std::vector<std::thread> d_threads;
+
+    /**
+     * \brief The I/O thread count to use when starting. 0 means use the settings.
+     */
+    size_t d_threadCount;
+
+    /**
+     * \brief The command thread count to use when starting. 0 means use the settings.
+     */
+    size_t d_workerCount;
+
+    mutable std::mutex d_mutex;
+};
+}
+
+#endif /* LOGICALACCESS_TRANSPORTREACTOR_HPP */
@@ -8,14 +8,21 @@
 #define LOGICALACCESS_UDPDATATRANSPORT_HPP
 
 #include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/readerproviders/transportreactor.hpp>
 #include <boost/asio.hpp>
 
+#include <chrono>
+
 namespace logicalaccess
 {
 #define TRANSPORT_UDP "UDP"
 
 /**
  * \brief An UDP data transport class.
+ *
+ * The socket is registered with the process-wide TransportReactor. receive()
+ * waits on the reactor and returns as soon as a datagram arrives.
+ * asyncSendCommand() sends and receives with non-blocking handlers on the reactor.
  */
 class LLA_CORE_API UDPDataTransport : public DataTransport
 {
@@ -109,8 +116,38 @@ class LLA_CORE_API UDPDataTransport : public DataTransport
      */
     void setPort(int port);
 
+    /**
+     * \brief Get the maximum size of a received datagram.
+     * \return The maximum datagram size.
+     */
+    size_t getMaxDatagramSize() const;
+
+    /**
+     * \brief Set the maximum size of a received datagram. Larger datagrams are
+     * truncated.
+     * \param size The maximum datagram size.
+     */
+    void setMaxDatagramSize(size_t size);
+
+    /**
+     * \brief Send a command with non-blocking I/O on the shared reactor.
+     * \param command The command buffer.
+     * \param timeout The command timeout.
+     * \param callback Invoked on a command thread with the result or the error.
+     */
+    void asyncSendCommand(const ByteVector &command, long int timeout,
+                          CommandCallback callback) override;
+
+    using DataTransport::asyncSendCommand;
+
     void send(const ByteVector &data) override;
 
+    /**
+     * \brief Receive a datagram.
+     * \param timeout Time waiting for data. 0 waits without time limit, a negative
+     * value only returns a datagram already received.
+     * \return The datagram, or an empty buffer on timeout.
+     */
     ByteVector receive(long int timeout) override;
 
   protected:
@@ -120,9 +157,29 @@ class LLA_CORE_API UDPDataTransport : public DataTransport
     std::shared_ptr<boost::asio::ip::udp::socket> d_socket;
 
     /**
-     * \brief Provides core I/O functionality
+     * \brief Serialize this transport handlers on the shared reactor.
      */
-    boost::asio::io_service ios;
+    boost::asio::io_service::strand d_ioStrand;
+
+    /**
+     * \brief Read deadline timer.
+     */
+    boost::asio::deadline_timer d_timer;
+
+    /**
+     * \brief Reusable datagram buffer.
+     */
+    ByteVector d_readBuffer;
+
+    /**
+     * \brief Byte Readed, 0 on timeout or error.
+     */
+    size_t d_bytes_transferred;
+
+    /**
+     * \brief Pending I/O handlers synchronization.
+     */
+    PendingHandlers d_handlers;
 
     /**
      * \brief The ip address
@@ -133,6 +190,56 @@ class LLA_CORE_API UDPDataTransport : public DataTransport
      * \brief The listening port.
      */
     int d_port;
+
+  private:
+    /**
+     * \brief Read complete
+     * \param error Read error
+     * \param bytes_transferred Byte transfered
+     */
+    void read_complete(const boost::system::error_code &error, size_t bytes_transferred);
+
+    /**
+     * \brief Read timeout
+     * \param error Read timeout or canceled
+     */
+    void time_out(const boost::system::error_code &error);
+
+    void asyncStart(const AsyncCommandQueue::Command &command);
+
+    void asyncAbort();
+
+    void asyncReceive();
+
+    /**
+     * \brief Handle the end of the receive or of its timer.
+     */
+    void asyncReceiveDone();
+
+    void asyncComplete(const ByteVector &result, std::exception_ptr eptr);
+
+    /**
+     * \brief The running asynchronous command.
+     */
+    ByteVector d_asyncCommand;
+
+    long int d_asyncTimeout;
+
+    std::chrono::steady_clock::time_point d_asyncSendTime;
+
+    /**
+     * \brief Handlers of the receive still to run: the read and the timer.
+     */
+    int d_asyncWaiting;
+
+    size_t d_asyncTransferred;
+
+    bool d_asyncAborted;
+
+    /**
+     * \brief The asynchronous commands. Declared last, so it is closed first.
+     */
+    AsyncCommandQueue d_asyncCommands;
 };
 }
 
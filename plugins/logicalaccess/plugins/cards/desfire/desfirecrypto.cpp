@@ -20,6 +20,7 @@
 #include <logicalaccess/plugins/crypto/des_symmetric_key.hpp>
 #include <logicalaccess/plugins/crypto/des_initialization_vector.hpp>
 #include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/plugins/crypto/des_engine.hpp>
 #include <logicalaccess/myexception.hpp>
 #include <logicalaccess/iks/IslogKeyServer.hpp>
 #include <logicalaccess/iks/RemoteCrypto.hpp>
@@ -39,6 +40,11 @@ DESFireCrypto::DESFireCrypto()
 
     d_lastIV.clear();
     d_lastIV.resize(8, 0x00);
+
+    d_decipherStreamed  = false;
+    d_decipherCrc       = 0;
+    d_decipherCrcLength = 0;
+    d_macStreamed       = false;
 }
 
 DESFireCrypto::~DESFireCrypto()
@@ -47,7 +53,14 @@ DESFireCrypto::~DESFireCrypto()
 
 void DESFireCrypto::appendDecipherData(const ByteVector &data)
 {
-    d_buf.insert(d_buf.end(), data.begin(), data.end());
+    if (d_decipherStreamed || (d_buf.empty() && canStreamData()))
+    {
+        streamDecipherData(data);
+    }
+    else
+    {
+        d_buf.insert(d_buf.end(), data.begin(), data.end());
+    }
 }
 
 ByteVector DESFireCrypto::desfireDecrypt(size_t length)
@@ -56,7 +69,11 @@ ByteVector DESFireCrypto::desfireDecrypt(size_t length)
 
     if (d_auth_method == CM_LEGACY)
     {
-        ret = desfire_decrypt(d_sessionKey, d_buf, length);
+        ret = desfire_decrypt(getDESEngine(d_sessionKey), d_buf, length);
+    }
+    else if (d_decipherStreamed)
+    {
+        ret = finishStreamedDecipher(length);
     }
     else
     {
@@ -70,6 +87,8 @@ void DESFireCrypto::initBuf()
 {
     d_buf.clear();
     d_last_left.clear();
+    d_decipherStreamed = false;
+    d_macStreamed      = false;
     if (d_auth_method == CM_LEGACY)
     {
         d_lastIV.clear();
@@ -85,6 +104,38 @@ bool DESFireCrypto::verifyMAC(bool end, const ByteVector &data)
     bool ret;
     d_buf.insert(d_buf.end(), data.begin(), data.end());
 
+    if (d_macStreamed || (!end && d_auth_method != CM_LEGACY && canStreamData()))
+    {
+        auto context = getCMACContext(d_sessionKey, d_cipher);
+        if (!d_macStreamed)
+        {
+            context->start(d_lastIV);
+            d_macStreamed = true;
+        }
+
+        // Keep the last 8 bytes, they may be the MAC.
+        if (d_buf.size() > 8)
+        {
+            context->update(ByteVector(d_buf.begin(), d_buf.end() - 8));
+            d_buf.erase(d_buf.begin(), d_buf.end() - 8);
+        }
+        if (!end)
+        {
+            return true;
+        }
+
+        d_macStreamed = false;
+        EXCEPTION_ASSERT_WITH_LOG(d_buf.size() == 8, LibLogicalAccessException,
+                                  "Wrong MAC buffer length.");
+        ByteVector mac;
+        mac.swap(d_buf);
+        context->update(ByteVector(1, 0x00)); // SW_OPERATION_OK
+        ByteVector ourMac = context->stop(d_cipher->getBlockSize());
+        d_lastIV          = ourMac;
+        ourMac.resize(8);
+        return mac == ourMac;
+    }
+
     if (end)
     {
         if (d_auth_method == CM_LEGACY) // Native DESFire mode
@@ -96,7 +147,7 @@ bool DESFireCrypto::verifyMAC(bool end, const ByteVector &data)
             mac.insert(mac.end(), d_buf.end() - 4, d_buf.end());
             ByteVector ourMacBuf;
             ourMacBuf.insert(ourMacBuf.end(), d_buf.begin(), d_buf.end() - 4);
-            ByteVector ourMac = desfire_mac(d_sessionKey, ourMacBuf);
+            ByteVector ourMac = desfire_mac(getDESEngine(d_sessionKey), ourMacBuf);
             ret               = (mac == ourMac);
         }
         else
@@ -132,7 +183,7 @@ ByteVector DESFireCrypto::generateMAC(unsigned char /*cmd*/, const ByteVector &d
     ByteVector ret;
     if (d_auth_method == CM_LEGACY)
     {
-        ret = desfire_mac(d_sessionKey, data);
+        ret = desfire_mac(getDESEngine(d_sessionKey), data);
     }
     else
     {
@@ -149,7 +200,7 @@ ByteVector DESFireCrypto::desfireEncrypt(const ByteVector &data, const ByteVecto
 
     if (d_auth_method == CM_LEGACY)
     {
-        ret = desfire_encrypt(d_sessionKey, data, calccrc);
+        ret = desfire_encrypt(getDESEngine(d_sessionKey), data, calccrc);
     }
     else
     {
@@ -170,16 +221,21 @@ short DESFireCrypto::desfire_crc16(const void *data, size_t dataLength)
     return ((second << 8) | first);
 }
 
-uint32_t DESFireCrypto::desfire_crc32(const void *data, size_t dataLength)
+static uint32_t desfire_crc32_checksum(const boost::crc_32_type &result)
 {
-    boost::crc_32_type result;
-    result.process_bytes(data, dataLength);
     uint32_t crc = result.checksum();
     crc ^= 0xffffffff;
     crc = (-1 * (crc ^ 0xffffffff)) - 1;
     return crc;
 }
 
+uint32_t DESFireCrypto::desfire_crc32(const void *data, size_t dataLength)
+{
+    boost::crc_32_type result;
+    result.process_bytes(data, dataLength);
+    return desfire_crc32_checksum(result);
+}
+
 /**
  * Check wheter or not a key is triple DES.
  * We do this by comparing the 8 first byte to 8 second byte, ignoring
@@ -197,175 +253,44 @@ static bool is_triple_des(const ByteVector &key)
     return false;
 }
 
-ByteVector DESFireCrypto::desfire_CBC_send(const ByteVector &key, const ByteVector &iv,
-                                           const ByteVector &data)
+std::shared_ptr<openssl::DESEngine>
+DESFireCrypto::createDESEngine(const ByteVector &key)
 {
-    symmetric_key skey;
-    unsigned char in[8], out[8], in2[8];
-
-    unsigned int j;
-
-    ByteVector ret;
-
     EXCEPTION_ASSERT_WITH_LOG(key.size() >= 8, LibLogicalAccessException,
-    "DESFire send cbc encryption need a valid 3des key.");
+                              "DESFire encryption need a valid key.");
 
     bool is3des = is_triple_des(key);
-    // Set encryption keys
     if (is3des)
     {
         EXCEPTION_ASSERT_WITH_LOG(key.size() >= 16, LibLogicalAccessException,
-                                  "DESFire send cbc encryption need a valid 3des key.");
-        EXCEPTION_ASSERT_WITH_LOG(des3_setup(&key[0], 16, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                  "DESFire setup failed");
-
-    }
-    else
-    {
-        EXCEPTION_ASSERT_WITH_LOG(des_setup(&key[0], 8, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                  "DESFire setup failed");
+                                  "DESFire encryption need a valid 3des key.");
     }
 
-    // clear buffers
-    memset(in, 0x00, 8);
-    memset(out, 0x00, 8);
-    memset(in2, 0x00, 8);
-
-    // do for each 8 byte block of input
-    for (unsigned int i = 0; i < data.size() / 8; i++)
-    {
-        // copy 8 bytes from input buffer to in
-        memcpy(in, &data[i * 8], 8);
-
-        if (i == 0)
-        {
-            if (iv.size() >= 8)
-            {
-                for (j = 0; j < 8; j++)
-                {
-                    in[j] ^= iv[j];
-                }
-            }
-        }
-        else
-        {
-            for (j = 0; j < 8; j++)
-            {
-                in[j] ^= in2[j];
-            }
-        }
-
-        // encryption
-        if (is3des)
-        {
-            des3_ecb_decrypt(in, out, &skey);
-        }
-        else
-        {
-            des_ecb_decrypt(in, out, &skey);
-        }
-
-        memcpy(in2, out, 8);
-
-        // copy decrypted block to output
-        ret.insert(ret.end(), out, out + 8);
-    }
+    return std::make_shared<openssl::DESEngine>(
+        ByteVector(key.begin(), key.begin() + (is3des ? 16 : 8)));
+}
 
-    if (is3des)
-    {
-        des3_done(&skey);
-    }
-    else
+openssl::DESEngine &DESFireCrypto::getDESEngine(const ByteVector &key)
+{
+    if (!d_desEngine || key != d_desEngineKey)
     {
-        des_done(&skey);
+        d_desEngine    = createDESEngine(key);
+        d_desEngineKey = key;
     }
+    return *d_desEngine;
+}
 
-    return ret;
+ByteVector DESFireCrypto::desfire_CBC_send(const ByteVector &key, const ByteVector &iv,
+                                           const ByteVector &data)
+{
+    // DESFire native send mode: deciphering with CBC encryption chaining
+    return createDESEngine(key)->cbcSendDecipher(iv, data);
 }
 
 ByteVector DESFireCrypto::desfire_CBC_receive(const ByteVector &key, const ByteVector &iv,
                                               const ByteVector &data)
 {
-    symmetric_key skey;
-    unsigned char in[8], out[8], in2[8];
-
-    unsigned int j;
-
-    ByteVector ret;
-
-    EXCEPTION_ASSERT_WITH_LOG(key.size() >= 8, LibLogicalAccessException,
-                              "DESFire encryption need a valid key.");
-
-    bool is3des = is_triple_des(key);
-
-    // Set encryption keys
-    if (is3des)
-    {
-        EXCEPTION_ASSERT_WITH_LOG(key.size() >= 16, LibLogicalAccessException,
-                                  "DESFire encryption need a valid 3des key.");
-        EXCEPTION_ASSERT_WITH_LOG(des3_setup(&key[0], 16, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                  "DESFire setup failed");
-    }
-    else
-    {
-      EXCEPTION_ASSERT_WITH_LOG(des_setup(&key[0], 8, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                "DESFire setup failed");
-    }
-
-    // clear buffers
-    memset(in, 0x00, 8);
-    memset(out, 0x00, 8);
-    memset(in2, 0x00, 8);
-
-    // do for each 8 byte block of input
-    for (unsigned int i = 0; i < data.size() / 8; i++)
-    {
-        // copy 8 bytes from input buffer to in
-        memcpy(in, &data[i * 8], 8);
-
-        if (is3des)
-        {
-            des3_ecb_decrypt(in, out, &skey);
-        }
-        else
-        {
-            des_ecb_decrypt(in, out, &skey);
-        }
-
-        if (i == 0)
-        {
-            if (iv.size() >= 8)
-            {
-                for (j = 0; j < 8; j++)
-                {
-                    out[j] ^= iv[j];
-                }
-            }
-        }
-        else
-        {
-            for (j = 0; j < 8; j++)
-            {
-                out[j] ^= in2[j];
-            }
-        }
-
-        memcpy(in2, &data[i * 8], 8);
-
-        // copy decrypted block to output
-        ret.insert(ret.end(), out, out + 8);
-    }
-
-    if (is3des)
-    {
-        des3_done(&skey);
-    }
-    else
-    {
-        des_done(&skey);
-    }
-
-    return ret;
+    return createDESEngine(key)->cbcDecrypt(iv, data);
 }
 
 ByteVector DESFireCrypto::desfire_CBC_mac(const ByteVector &key, const ByteVector &iv,
@@ -378,85 +303,15 @@ ByteVector DESFireCrypto::desfire_CBC_mac(const ByteVector &key, const ByteVecto
 ByteVector DESFireCrypto::sam_CBC_send(const ByteVector &key, const ByteVector &iv,
                                        const ByteVector &data)
 {
-    unsigned char in[8], out[8];
-    symmetric_key skey;
-    unsigned int j;
-
-    ByteVector ret;
-
-    EXCEPTION_ASSERT_WITH_LOG(key.size() >= 8, LibLogicalAccessException,
-                              "DESFire sam cbc encryption need a valid key.");
-
-    bool is3des = is_triple_des(key);
-
-    // Set encryption keys
-    if (is3des)
-    {
-        EXCEPTION_ASSERT_WITH_LOG(key.size() >= 16, LibLogicalAccessException,
-                                  "DESFire sam cbc encryption need a valid key.");
-        EXCEPTION_ASSERT_WITH_LOG(des3_setup(&key[0], 16, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                  "DESFire setup failed");
-    }
-    else
-    {
-      EXCEPTION_ASSERT_WITH_LOG(des_setup(&key[0], 8, 0, &skey) == CRYPT_OK, LibLogicalAccessException,
-                                "DESFire setup failed");
-    }
-
-    // clear buffers
-    memset(in, 0x00, 8);
-    memset(out, 0x00, 8);
-
-    // do for each 8 byte block of input
-    for (unsigned int i = 0; i < data.size() / 8; i++)
-    {
-        // copy 8 bytes from input buffer to in
-        memcpy(in, &data[i * 8], 8);
-
-        if (i == 0)
-        {
-            if (iv.size() >= 8)
-            {
-                for (j = 0; j < 8; j++)
-                {
-                    in[j] ^= iv[j];
-                }
-            }
-        }
-        else
-        {
-            for (j = 0; j < 8; j++)
-            {
-                in[j] = in[j] ^ out[j];
-            }
-        }
-
-        if (is3des)
-        {
-            des3_ecb_encrypt(in, out, &skey);
-        }
-        else
-        {
-            des_ecb_encrypt(in, out, &skey);
-        }
-
-        // copy encrypted block to output
-        ret.insert(ret.end(), out, out + 8);
-    }
-
-    if (is3des)
-    {
-        des3_done(&skey);
-    }
-    else
-    {
-        des_done(&skey);
-    }
-
-    return ret;
+    return createDESEngine(key)->cbcEncrypt(iv, data);
 }
 
 ByteVector DESFireCrypto::desfire_mac(const ByteVector &key, ByteVector data)
+{
+    return desfire_mac(*createDESEngine(key), data);
+}
+
+ByteVector DESFireCrypto::desfire_mac(openssl::DESEngine &engine, ByteVector data)
 {
     int pad = (8 - (data.size() % 8)) % 8;
     for (int i = 0; i < pad; ++i)
@@ -464,11 +319,18 @@ ByteVector DESFireCrypto::desfire_mac(const ByteVector &key, ByteVector data)
         data.push_back(0x00);
     }
 
-    return desfire_CBC_mac(key, ByteVector(), data);
+    ByteVector ret = engine.cbcEncrypt(ByteVector(), data);
+    return ByteVector(ret.end() - 8, ret.end() - 4);
 }
 
 ByteVector DESFireCrypto::desfire_encrypt(const ByteVector &key, ByteVector data,
                                           bool calccrc)
+{
+    return desfire_encrypt(*createDESEngine(key), data, calccrc);
+}
+
+ByteVector DESFireCrypto::desfire_encrypt(openssl::DESEngine &engine, ByteVector data,
+                                          bool calccrc)
 {
     if (calccrc)
     {
@@ -481,7 +343,7 @@ ByteVector DESFireCrypto::desfire_encrypt(const ByteVector &key, ByteVector data
     {
         data.push_back(0x00);
     }
-    return desfire_CBC_send(key, ByteVector(), data);
+    return engine.cbcSendDecipher(ByteVector(), data);
 }
 
 ByteVector DESFireCrypto::sam_encrypt(const ByteVector &key, ByteVector data)
@@ -501,10 +363,16 @@ ByteVector DESFireCrypto::sam_encrypt(const ByteVector &key, ByteVector data)
 
 ByteVector DESFireCrypto::desfire_decrypt(const ByteVector &key, const ByteVector &data,
                                           size_t datalen)
+{
+    return desfire_decrypt(*createDESEngine(key), data, datalen);
+}
+
+ByteVector DESFireCrypto::desfire_decrypt(openssl::DESEngine &engine,
+                                          const ByteVector &data, size_t datalen)
 {
     ByteVector ret;
     size_t ll;
-    ret = desfire_CBC_receive(key, ByteVector(), data);
+    ret = engine.cbcDecrypt(ByteVector(), data);
     if (datalen == 0)
     {
         ll = ret.size() - 1;
@@ -540,7 +408,7 @@ ByteVector DESFireCrypto::authenticate_PICC1(unsigned char keyno, ByteVector div
     d_sessionKey.clear();
     d_authkey.resize(16);
     getKey(d_currentAid, 0, keyno, diversify, d_authkey);
-    d_rndB = desfire_CBC_send(d_authkey, ByteVector(), encRndB);
+    d_rndB = getDESEngine(d_authkey).cbcSendDecipher(ByteVector(), encRndB);
     ByteVector rndB1;
     rndB1.insert(rndB1.end(), d_rndB.begin() + 1, d_rndB.begin() + 8);
     rndB1.push_back(d_rndB[0]);
@@ -557,12 +425,12 @@ ByteVector DESFireCrypto::authenticate_PICC1(unsigned char keyno, ByteVector div
     ByteVector rndAB;
     rndAB.insert(rndAB.end(), d_rndA.begin(), d_rndA.end());
     rndAB.insert(rndAB.end(), rndB1.begin(), rndB1.end());
-    return desfire_CBC_send(d_authkey, ByteVector(), rndAB);
+    return getDESEngine(d_authkey).cbcSendDecipher(ByteVector(), rndAB);
 }
 
 void DESFireCrypto::authenticate_PICC2(unsigned char keyno, const ByteVector &encRndA1)
 {
-    ByteVector rndA = desfire_CBC_send(d_authkey, ByteVector(), encRndA1);
+    ByteVector rndA = getDESEngine(d_authkey).cbcSendDecipher(ByteVector(), encRndA1);
     ByteVector checkRndA;
 
     d_sessionKey.clear();
@@ -657,6 +525,7 @@ void DESFireCrypto::selectApplication(size_t aid)
     d_cipher.reset();
     d_currentKeyNo = 0;
     d_sessionKey.clear();
+    d_cmac.reset();
 }
 
 ByteVector DESFireCrypto::changeKey_PICC(uint8_t keyno, ByteVector oldKeyDiversify,
@@ -695,13 +564,14 @@ ByteVector DESFireCrypto::changeKey_PICC(uint8_t keyno, ByteVector oldKeyDiversi
             encCryptogram.push_back(static_cast<unsigned char>(crc & 0xff));
             encCryptogram.push_back(static_cast<unsigned char>((crc & 0xff00) >> 8));
             encCryptogram.resize(24); // Pad
-            cryptogram = desfire_CBC_send(d_sessionKey, ByteVector(), encCryptogram);
+            cryptogram =
+                getDESEngine(d_sessionKey).cbcSendDecipher(ByteVector(), encCryptogram);
         }
         else
         {
             if (newkey->getKeyType() == DF_KEY_AES) // Change PICC Key
                 newkeydiv.push_back(newkey->getKeyVersion());
-            cryptogram = desfire_encrypt(d_sessionKey, newkeydiv);
+            cryptogram = desfire_encrypt(getDESEngine(d_sessionKey), newkeydiv, true);
         }
     }
     else
@@ -895,6 +765,7 @@ void DESFireCrypto::iso_authenticate_PICC2(unsigned char keyno,
     d_mac_size    = 8;
     d_lastIV.clear();
     d_lastIV.resize(d_cipher->getBlockSize(), 0x00);
+    d_cmac = std::make_shared<openssl::CMACContext>(d_sessionKey, d_cipher);
 }
 
 ByteVector DESFireCrypto::aes_authenticate_PICC1(unsigned char keyno,
@@ -991,6 +862,8 @@ void DESFireCrypto::aes_authenticate_PICC2(unsigned char keyno,
         d_sessionKey.insert(d_sessionKey.end(), d_rndB.begin(), d_rndB.begin() + 4);
         d_sessionKey.insert(d_sessionKey.end(), d_rndA.begin() + 12, d_rndA.begin() + 16);
         d_sessionKey.insert(d_sessionKey.end(), d_rndB.begin() + 12, d_rndB.begin() + 16);
+        d_cmac = std::make_shared<openssl::CMACContext>(
+            d_sessionKey, std::make_shared<openssl::AESCipher>());
 
         d_currentKeyNo = keyno;
     }
@@ -1018,6 +891,8 @@ void DESFireCrypto::aes_authenticate_PICC2_GENERIC(unsigned char keyno,
         d_sessionKey.insert(d_sessionKey.end(), d_rndB.begin(), d_rndB.begin() + 4);
         d_sessionKey.insert(d_sessionKey.end(), d_rndA.begin() + 12, d_rndA.begin() + 16);
         d_sessionKey.insert(d_sessionKey.end(), d_rndB.begin() + 12, d_rndB.begin() + 16);
+        d_cmac = std::make_shared<openssl::CMACContext>(
+            d_sessionKey, std::make_shared<openssl::AESCipher>());
 
         d_currentKeyNo = keyno;
     }
@@ -1047,8 +922,8 @@ DESFireCrypto::desfire_cmac(const ByteVector &key,
         return ret;
     }
 
-    ByteVector ret = openssl::CMACCrypto::cmac(key, cipherMAC, data, d_lastIV,
-                                               cipherMAC->getBlockSize());
+    ByteVector ret = getCMACContext(key, cipherMAC)
+                         ->cmac(data, d_lastIV, cipherMAC->getBlockSize());
 
     if (cipherMAC == d_cipher)
     {
@@ -1064,6 +939,177 @@ DESFireCrypto::desfire_cmac(const ByteVector &key,
     return ret;
 }
 
+std::shared_ptr<openssl::CMACContext>
+DESFireCrypto::getCMACContext(const ByteVector &key,
+                              std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipherMAC)
+{
+    if (d_cmac && d_cmac->matches(key, cipherMAC))
+        return d_cmac;
+
+    auto context = std::make_shared<openssl::CMACContext>(key, cipherMAC);
+    if (key == d_sessionKey)
+        d_cmac = context;
+    return context;
+}
+
+/**
+ * \brief Find the data length of a deciphered ISO buffer, before the CRC.
+ * \param decdata The deciphered data. The padding 0x80 is cleared.
+ * \param datalen The excepted data length, or 0 to analyse the padding.
+ */
+static size_t iso_data_length(ByteVector &decdata, size_t datalen)
+{
+    size_t ll;
+
+    if (datalen == 0)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(decdata.size() > 0, LibLogicalAccessException,
+                                  "Incorrect FLT result");
+
+        // Lets analyse the padding and find crc ourself
+        ll = decdata.size() - 1;
+
+        while (ll > 0 && decdata[ll] == 0x00)
+        {
+            ll--;
+        }
+
+        EXCEPTION_ASSERT_WITH_LOG(decdata[ll] == 0x80, LibLogicalAccessException,
+                                  "Incorrect FLT result");
+
+        decdata[ll] = 0x00; // Remove 0x80 for padding check
+
+        EXCEPTION_ASSERT_WITH_LOG(ll >= 4, LibLogicalAccessException,
+                                  "Cannot find the crc in the encrypted data");
+
+        ll -= 4; // Move to crc start
+    }
+    else
+    {
+        ll = datalen;
+    }
+
+    EXCEPTION_ASSERT_WITH_LOG(ll + 4 <= decdata.size(), LibLogicalAccessException,
+                              "Cannot find the crc in the encrypted data");
+    return ll;
+}
+
+/**
+ * \brief Check the CRC and the padding of a deciphered ISO buffer.
+ * \param decdata The deciphered data.
+ * \param ll The data length.
+ * \param crc1 The CRC calculated on the data and the status.
+ */
+static void iso_check_crc(const ByteVector &decdata, size_t ll, uint32_t crc1)
+{
+    uint32_t crc2 = decdata[ll] | (decdata[ll + 1] << 8) | (decdata[ll + 2] << 16) |
+                    (decdata[ll + 3] << 24);
+    size_t pad = decdata.size() - ll - 4;
+    ByteVector padding =
+        ByteVector(decdata.begin() + ll + 4, decdata.begin() + ll + 4 + pad);
+    ByteVector padding1;
+    for (size_t i = 0; i < pad; ++i)
+    {
+        padding1.push_back(0x00);
+    }
+    std::stringstream ss;
+    ss << "Error in crc computation: (crc1: " << std::hex << crc1;
+    ss << ", crc2: " << crc2 << ") or padding. Padding: " << padding
+       << ". padding1: " << padding1;
+    EXCEPTION_ASSERT_WITH_LOG(crc1 == crc2 && padding == padding1,
+                              LibLogicalAccessException, ss.str());
+}
+
+bool DESFireCrypto::canStreamData() const
+{
+    return d_auth_method != CM_LEGACY && !iks_wrapper_ && d_cipher &&
+           !d_sessionKey.empty();
+}
+
+void DESFireCrypto::streamDecipherData(const ByteVector &data)
+{
+    if (!d_decipherStreamed)
+    {
+        d_decipherStreamed  = true;
+        d_decipherCrc       = boost::crc_32_type().get_interim_remainder();
+        d_decipherCrcLength = 0;
+    }
+
+    const size_t blockSize = d_cipher->getBlockSize();
+    ByteVector encdata;
+    encdata.reserve(d_last_left.size() + data.size());
+    encdata.insert(encdata.end(), d_last_left.begin(), d_last_left.end());
+    encdata.insert(encdata.end(), data.begin(), data.end());
+
+    const size_t ready = (encdata.size() / blockSize) * blockSize;
+    d_last_left.assign(encdata.begin() + ready, encdata.end());
+    if (ready == 0)
+    {
+        return;
+    }
+    encdata.resize(ready);
+
+    ByteVector decdata;
+    if (std::dynamic_pointer_cast<openssl::AESCipher>(d_cipher))
+    {
+        d_cipher->decipher(encdata, decdata,
+                           openssl::AESSymmetricKey::createFromData(d_sessionKey),
+                           openssl::AESInitializationVector::createFromData(d_lastIV),
+                           false);
+    }
+    else
+    {
+        d_cipher->decipher(encdata, decdata,
+                           openssl::DESSymmetricKey::createFromData(d_sessionKey),
+                           openssl::DESInitializationVector::createFromData(d_lastIV),
+                           false);
+    }
+    d_lastIV.assign(encdata.end() - blockSize, encdata.end());
+    d_buf.insert(d_buf.end(), decdata.begin(), decdata.end());
+
+    // The CRC and the padding are within the last block and 4 bytes.
+    if (d_buf.size() > d_decipherCrcLength + blockSize + 4)
+    {
+        const size_t end = d_buf.size() - blockSize - 4;
+        boost::crc_32_type crc;
+        crc.reset(d_decipherCrc);
+        crc.process_bytes(&d_buf[d_decipherCrcLength], end - d_decipherCrcLength);
+        d_decipherCrc       = crc.get_interim_remainder();
+        d_decipherCrcLength = end;
+    }
+}
+
+ByteVector DESFireCrypto::finishStreamedDecipher(size_t length)
+{
+    d_decipherStreamed = false;
+    EXCEPTION_ASSERT_WITH_LOG(d_last_left.empty(), LibLogicalAccessException,
+                              "The encrypted data are not block aligned.");
+
+    ByteVector decdata;
+    decdata.swap(d_buf);
+    size_t ll = iso_data_length(decdata, length);
+
+    uint32_t crc1;
+    if (ll >= d_decipherCrcLength)
+    {
+        boost::crc_32_type crc;
+        crc.reset(d_decipherCrc);
+        crc.process_bytes(decdata.data() + d_decipherCrcLength, ll - d_decipherCrcLength);
+        crc.process_byte(0x00); // SW_OPERATION_OK
+        crc1 = desfire_crc32_checksum(crc);
+    }
+    else
+    {
+        ByteVector crcbuf = ByteVector(decdata.begin(), decdata.begin() + ll);
+        crcbuf.push_back(0x00); // SW_OPERATION_OK
+        crc1 = desfire_crc32(&crcbuf[0], crcbuf.size());
+    }
+    iso_check_crc(decdata, ll, crc1);
+
+    decdata.resize(ll);
+    return decdata;
+}
+
 ByteVector DESFireCrypto::desfire_iso_decrypt(const ByteVector &data, size_t length)
 {
     return desfire_iso_decrypt(d_sessionKey, data, d_cipher, length);
@@ -1112,52 +1158,11 @@ ByteVector DESFireCrypto::desfire_iso_decrypt(
         d_lastIV = ByteVector(data.end() - cipher->getBlockSize(), data.end());
         iks_wrapper_->last_sig = signature_result;
     }
-    size_t ll;
-
-    if (datalen == 0)
-    {
-        // Lets analyse the padding and find crc ourself
-        ll = decdata.size() - 1;
-
-        while (ll > 0 && decdata[ll] == 0x00)
-        {
-            ll--;
-        }
-
-        EXCEPTION_ASSERT_WITH_LOG(decdata[ll] == 0x80, LibLogicalAccessException,
-                                  "Incorrect FLT result");
-
-        decdata[ll] = 0x00; // Remove 0x80 for padding check
-
-        EXCEPTION_ASSERT_WITH_LOG(ll >= 4, LibLogicalAccessException,
-                                  "Cannot find the crc in the encrypted data");
-
-        ll -= 4; // Move to crc start
-    }
-    else
-    {
-        ll = datalen;
-    }
+    size_t ll = iso_data_length(decdata, datalen);
 
     ByteVector crcbuf = ByteVector(decdata.begin(), decdata.begin() + ll);
     crcbuf.push_back(0x00); // SW_OPERATION_OK
-    uint32_t crc1 = desfire_crc32(&crcbuf[0], crcbuf.size());
-    uint32_t crc2 = decdata[ll] | (decdata[ll + 1] << 8) | (decdata[ll + 2] << 16) |
-                    (decdata[ll + 3] << 24);
-    size_t pad = decdata.size() - ll - 4;
-    ByteVector padding =
-        ByteVector(decdata.begin() + ll + 4, decdata.begin() + ll + 4 + pad);
-    ByteVector padding1;
-    for (size_t i = 0; i < pad; ++i)
-    {
-        padding1.push_back(0x00);
-    }
-    std::stringstream ss;
-    ss << "Error in crc computation: (crc1: " << std::hex << crc1;
-    ss << ", crc2: " << crc2 << ") or padding. Padding: " << padding
-       << ". padding1: " << padding1;
-    EXCEPTION_ASSERT_WITH_LOG(crc1 == crc2 && padding == padding1,
-                              LibLogicalAccessException, ss.str());
+    iso_check_crc(decdata, ll, desfire_crc32(&crcbuf[0], crcbuf.size()));
 
     decdata.resize(ll);
     return decdata;
@@ -10,6 +10,8 @@
 #include <logicalaccess/plugins/cards/desfire/desfireaccessinfo.hpp>
 #include <logicalaccess/plugins/crypto/des_cipher.hpp>
 #include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/plugins/crypto/des_engine.hpp>
 
 #include <memory>
 #include <string>
@@ -59,7 +61,8 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
     virtual ~DESFireCrypto();
 
     /**
-     * \brief Decipher data step 2.
+     * \brief Decipher data step 2. With ISO/AES authentication, the complete
+     * blocks are deciphered as they are received.
      * \param data The data buffer
      */
     void appendDecipherData(const ByteVector &data);
@@ -72,7 +75,8 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
     virtual ByteVector desfireDecrypt(size_t length);
 
     /**
-     * \brief Verify MAC into the buffer.
+     * \brief Verify MAC into the buffer. With ISO/AES authentication, each part
+     * is MACed as it is received.
      * \param end True if it's the last buffer, false otherwise
      * \param data The data buffer
      * \return True on success, false otherwise.
@@ -156,6 +160,13 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
     static ByteVector desfire_CBC_mac(const ByteVector &key, const ByteVector &iv,
                                       const ByteVector &data);
 
+    /**
+     * \brief Create a DES engine for a legacy DESFire key.
+     * \param key The DES key, 8 bytes or 16 bytes if the halves differ.
+     * \return The engine.
+     */
+    static std::shared_ptr<openssl::DESEngine> createDESEngine(const ByteVector &key);
+
     /**
      * \brief  Preform standard CBC encryption operation, which is used for DESFire SAM
      * cryptograms.
@@ -264,6 +275,17 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
      */
     ByteVector desfire_cmac(const ByteVector &data);
 
+    /**
+     * \brief Get a CMAC context for a key. The session key context is kept and
+     * reused while the session key does not change.
+     * \param key The key to use.
+     * \param cipherMAC The cipher to use.
+     * \return The CMAC context.
+     */
+    std::shared_ptr<openssl::CMACContext>
+    getCMACContext(const ByteVector &key,
+                   std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipherMAC);
+
     /**
      * \brief Authenticate on the card, step 1 for mutual authentication.
      * \param keyno The key number to use
@@ -551,6 +573,75 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
      * \brief The card identifier use for key diversification.
      */
     ByteVector d_identifier;
+
+    /**
+     * \brief The CMAC context of the session key, created at authentication.
+     */
+    std::shared_ptr<openssl::CMACContext> d_cmac;
+
+    /**
+     * \brief True when the received data are deciphered as they arrive. d_buf then
+     * holds the deciphered data and d_last_left the incomplete encrypted block.
+     */
+    bool d_decipherStreamed;
+
+    /**
+     * \brief The CRC32 remainder of the first d_decipherCrcLength deciphered bytes.
+     */
+    uint32_t d_decipherCrc;
+
+    size_t d_decipherCrcLength;
+
+    /**
+     * \brief True once the MAC of the received data is being calculated as it
+     * arrives. d_buf then holds the data not MACed yet.
+     */
+    bool d_macStreamed;
+
+  private:
+    /**
+     * \brief Get the DES engine of the session, created again only when the key
+     * changes.
+     * \param key The DES key.
+     * \return The engine.
+     */
+    openssl::DESEngine &getDESEngine(const ByteVector &key);
+
+    static ByteVector desfire_mac(openssl::DESEngine &engine, ByteVector data);
+
+    static ByteVector desfire_encrypt(openssl::DESEngine &engine, ByteVector data,
+                                      bool calccrc);
+
+    static ByteVector desfire_decrypt(openssl::DESEngine &engine,
+                                      const ByteVector &data, size_t datalen);
+
+    /**
+     * \brief The DES engine of the legacy session.
+     */
+    std::shared_ptr<openssl::DESEngine> d_desEngine;
+
+    /**
+     * \brief The key of d_desEngine.
+     */
+    ByteVector d_desEngineKey;
+
+    /**
+     * \brief Check if the received data can be deciphered / MACed as they arrive:
+     * ISO/AES authentication with a local session key.
+     */
+    bool canStreamData() const;
+
+    /**
+     * \brief Decipher the complete blocks received and update the CRC.
+     */
+    void streamDecipherData(const ByteVector &data);
+
+    /**
+     * \brief Check the CRC and padding of the deciphered data.
+     * \param length The excepted deciphared data length, or 0 to automatic.
+     * \return The deciphered data.
+     */
+    ByteVector finishStreamedDecipher(size_t length);
 };
 }
 
@@ -38,58 +38,98 @@ void NXPAV1KeyDiversification::initDiversification(ByteVector identifier,
         diversify.insert(diversify.end(), diversify.begin(), diversify.end());
 }
 
-ByteVector NXPAV1KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
-                                                       ByteVector diversify)
+namespace
 {
-    LOG(LogLevel::INFOS) << "Using key diversification NXP AV1 with div : "
-                         << BufferHelper::getHex(diversify);
-    std::shared_ptr<openssl::SymmetricKey> symkey;
-    std::shared_ptr<openssl::InitializationVector> iv;
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher;
-    ByteVector keycipher(key->getData(), key->getData() + key->getLength());
-    ByteVector divKey, divInputEncP1, divInputEncP2;
+/**
+ * \brief The cipher of an NXP AV1 master key, keyed once for all its inputs.
+ */
+class NXPAV1Cipher
+{
+  public:
+    explicit NXPAV1Cipher(const std::shared_ptr<Key> &key)
+        : d_keycipher(key->getData(), key->getData() + key->getLength())
+        , d_aes(std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_AES)
+    {
+        if (!d_aes)
+        {
+            d_symkey.reset(new openssl::DESSymmetricKey(
+                openssl::DESSymmetricKey::createFromData(d_keycipher)));
+            d_iv.reset(new openssl::DESInitializationVector(
+                openssl::DESInitializationVector::createFromData(ByteVector(8))));
+            d_cipher.reset(new openssl::DESCipher());
+        }
+        else
+        {
+            d_symkey.reset(new openssl::AESSymmetricKey(
+                openssl::AESSymmetricKey::createFromData(d_keycipher)));
+            d_iv.reset(new openssl::AESInitializationVector(
+                openssl::AESInitializationVector::createFromData(ByteVector(16))));
+            d_cipher.reset(new openssl::AESCipher());
+        }
+    }
 
-    if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() != DF_KEY_AES)
+    ByteVector diversify(ByteVector diversify)
     {
-        LOG(LogLevel::INFOS) << "Diversification NXP AV1 3DES";
-        for (int x       = 0; x < 8; ++x)
-            diversify[x] = diversify[x] ^ keycipher[x];
+        ByteVector divKey, divInputEncP1, divInputEncP2;
 
-        ByteVector emptyIV(8);
-        symkey.reset(new openssl::DESSymmetricKey(
-            openssl::DESSymmetricKey::createFromData(keycipher)));
-        iv.reset(new openssl::DESInitializationVector(
-            openssl::DESInitializationVector::createFromData(emptyIV)));
-        cipher.reset(new openssl::DESCipher());
+        if (!d_aes)
+        {
+            LOG(LogLevel::INFOS) << "Diversification NXP AV1 3DES";
+            for (int x       = 0; x < 8; ++x)
+                diversify[x] = diversify[x] ^ d_keycipher[x];
 
-        cipher->cipher(diversify, divInputEncP1, *symkey.get(), *iv.get(), false);
+            d_cipher->cipher(diversify, divInputEncP1, *d_symkey, *d_iv, false);
+            divKey.insert(divKey.end(), divInputEncP1.begin(), divInputEncP1.end());
 
-        divKey.insert(divKey.end(), divInputEncP1.begin(), divInputEncP1.end());
+            diversify = divInputEncP1;
+            for (int x       = 0; x < 8; ++x)
+                diversify[x] = diversify[x] ^ d_keycipher[x + 8];
 
-        diversify = divInputEncP1;
-        for (int x       = 0; x < 8; ++x)
-            diversify[x] = diversify[x] ^ keycipher[x + 8];
+            d_cipher->cipher(diversify, divInputEncP2, *d_symkey, *d_iv, false);
+            divKey.insert(divKey.end(), divInputEncP2.begin(), divInputEncP2.end());
+        }
+        else
+        {
+            LOG(LogLevel::INFOS) << "Diversification NXP AV1 AES";
+            for (int x       = 0; x < 16; ++x)
+                diversify[x] = diversify[x] ^ d_keycipher[x];
 
-        cipher->cipher(diversify, divInputEncP2, *symkey.get(), *iv.get(), false);
-        divKey.insert(divKey.end(), divInputEncP2.begin(), divInputEncP2.end());
+            d_cipher->cipher(diversify, divKey, *d_symkey, *d_iv, false);
+        }
+        return divKey;
     }
-    else if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_AES)
-    {
-        LOG(LogLevel::INFOS) << "Diversification NXP AV1 AES";
 
-        for (int x       = 0; x < 16; ++x)
-            diversify[x] = diversify[x] ^ keycipher[x];
+  private:
+    ByteVector d_keycipher;
+    bool d_aes;
+    std::shared_ptr<openssl::SymmetricKey> d_symkey;
+    std::shared_ptr<openssl::InitializationVector> d_iv;
+    std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_cipher;
+};
+}
 
-        ByteVector emptyIV(16);
-        symkey.reset(new openssl::AESSymmetricKey(
-            openssl::AESSymmetricKey::createFromData(keycipher)));
-        iv.reset(new openssl::AESInitializationVector(
-            openssl::AESInitializationVector::createFromData(emptyIV)));
-        cipher.reset(new openssl::AESCipher());
+ByteVector NXPAV1KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
+                                                       ByteVector diversify)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification NXP AV1 with div : "
+                         << BufferHelper::getHex(diversify);
+    return NXPAV1Cipher(key).diversify(diversify);
+}
 
-        cipher->cipher(diversify, divKey, *symkey.get(), *iv.get(), false);
-    }
-    return divKey;
+std::vector<ByteVector>
+NXPAV1KeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key,
+                                             const std::vector<ByteVector> &diversify,
+                                             unsigned int threads)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification NXP AV1 for " << diversify.size()
+                         << " inputs";
+    std::vector<ByteVector> ret(diversify.size());
+    forEachRange(diversify.size(), threads, [&](size_t begin, size_t end) {
+        NXPAV1Cipher cipher(key);
+        for (size_t i = begin; i < end; ++i)
+            ret[i] = cipher.diversify(diversify[i]);
+    });
+    return ret;
 }
 
 void NXPAV1KeyDiversification::serialize(boost::property_tree::ptree &parentNode)
@@ -17,6 +17,16 @@ class LLA_CARDS_DESFIRE_API NXPAV1KeyDiversification : public NXPKeyDiversificat
                              ByteVector &diversify) override;
     ByteVector getDiversifiedKey(std::shared_ptr<Key> key, ByteVector diversify) override;
 
+    /**
+     * \brief Diversify the same key for many inputs at once.
+     *
+     * Each worker thread keys one cipher with the master key and uses it for all of
+     * its inputs.
+     */
+    std::vector<ByteVector> getDiversifiedKeys(std::shared_ptr<Key> key,
+                                               const std::vector<ByteVector> &diversify,
+                                               unsigned int threads = 1) override;
+
     NXPAV1KeyDiversification()
     {
     }
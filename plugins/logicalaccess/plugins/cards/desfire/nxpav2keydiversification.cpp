@@ -66,67 +66,96 @@ void NXPAV2KeyDiversification::initDiversification(ByteVector identifier,
     }
 }
 
-ByteVector NXPAV2KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
-                                                       ByteVector diversify)
+/**
+ * \brief Get the DESFire key type of a master key, if NXP AV2 supports it.
+ */
+static DESFireKeyType getNXPAV2KeyType(const std::shared_ptr<Key> &key)
 {
-    LOG(LogLevel::INFOS) << "Using key diversification NXP AV2 with div : "
-                         << BufferHelper::getHex(diversify);
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_cipher;
-    ByteVector keycipher(key->getData(), key->getData() + key->getLength());
-    ByteVector emptyIV, keydiv;
-
-    if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_DES ||
-        std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_3K3DES)
-    {
-        d_cipher.reset(new openssl::DESCipher());
-    }
-    else if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_AES)
-    {
-        d_cipher.reset(new openssl::AESCipher());
-    }
-    else
+    std::shared_ptr<DESFireKey> dkey = std::dynamic_pointer_cast<DESFireKey>(key);
+    EXCEPTION_ASSERT_WITH_LOG(dkey, LibLogicalAccessException,
+                              "NXP Diversification needs a DESFire key");
+    DESFireKeyType keyType = dkey->getKeyType();
+    if (keyType != DF_KEY_DES && keyType != DF_KEY_3K3DES && keyType != DF_KEY_AES)
         THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
                                  "NXP Diversification don't support this security");
+    return keyType;
+}
+
+/**
+ * \brief Create the CMAC context of a master key.
+ */
+static std::shared_ptr<openssl::CMACContext>
+createNXPAV2Context(const std::shared_ptr<Key> &key, DESFireKeyType keyType)
+{
+    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher;
+    if (keyType == DF_KEY_AES)
+        cipher.reset(new openssl::AESCipher());
+    else
+        cipher.reset(new openssl::DESCipher());
+
+    ByteVector keycipher(key->getData(), key->getData() + key->getLength());
+    return std::make_shared<openssl::CMACContext>(keycipher, cipher);
+}
 
-    emptyIV.resize(d_cipher->getBlockSize());
-    if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_AES)
+/**
+ * \brief Diversify one input with an already keyed CMAC context.
+ */
+static ByteVector diversifyNXPAV2(openssl::CMACContext &context, DESFireKeyType keyType,
+                                  ByteVector diversify, bool forceK2Use)
+{
+    ByteVector keydiv;
+
+    if (keyType == DF_KEY_AES)
     {
         // const AES 128
         diversify.insert(diversify.begin(), 0x01);
-        ByteVector keydiv_tmp = openssl::CMACCrypto::cmac(keycipher, d_cipher,
-                                      diversify, emptyIV, 32, d_forceK2Use);
+        ByteVector keydiv_tmp = context.cmac(diversify, {}, 32, forceK2Use);
         keydiv.resize(16);
         copy(keydiv_tmp.begin(), keydiv_tmp.end(), keydiv.begin());
     }
-    else if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_DES)
-    {
-        diversify.insert(diversify.begin(), 0x21);
-        ByteVector keydiv_tmp_1 = openssl::CMACCrypto::cmac(
-            keycipher, d_cipher, diversify, emptyIV, 16, d_forceK2Use);
-        diversify[0]            = 0x22;
-        ByteVector keydiv_tmp_2 = openssl::CMACCrypto::cmac(
-            keycipher, d_cipher, diversify, emptyIV, 16, d_forceK2Use);
-        keydiv.insert(keydiv.end(), keydiv_tmp_1.begin(), keydiv_tmp_1.end());
-        keydiv.insert(keydiv.end(), keydiv_tmp_2.begin(), keydiv_tmp_2.end());
-    }
-    else if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_3K3DES)
+    else
     {
-        diversify.insert(diversify.begin(), 0x31);
-        ByteVector keydiv_tmp_1 = openssl::CMACCrypto::cmac(
-            keycipher, d_cipher, diversify, emptyIV, 16, d_forceK2Use);
-        diversify[0]            = 0x32;
-        ByteVector keydiv_tmp_2 = openssl::CMACCrypto::cmac(
-            keycipher, d_cipher, diversify, emptyIV, 16, d_forceK2Use);
-        diversify[0]            = 0x33;
-        ByteVector keydiv_tmp_3 = openssl::CMACCrypto::cmac(
-            keycipher, d_cipher, diversify, emptyIV, 16, d_forceK2Use);
-        keydiv.insert(keydiv.end(), keydiv_tmp_1.begin(), keydiv_tmp_1.end());
-        keydiv.insert(keydiv.end(), keydiv_tmp_2.begin(), keydiv_tmp_2.end());
-        keydiv.insert(keydiv.end(), keydiv_tmp_3.begin(), keydiv_tmp_3.end());
+        unsigned char prefix   = keyType == DF_KEY_DES ? 0x21 : 0x31;
+        unsigned char nbBlocks = keyType == DF_KEY_DES ? 2 : 3;
+        diversify.insert(diversify.begin(), prefix);
+        for (unsigned char i = 0; i < nbBlocks; ++i)
+        {
+            diversify[0]          = static_cast<unsigned char>(prefix + i);
+            ByteVector keydiv_tmp = context.cmac(diversify, {}, 16, forceK2Use);
+            keydiv.insert(keydiv.end(), keydiv_tmp.begin(), keydiv_tmp.end());
+        }
     }
     return keydiv;
 }
 
+ByteVector NXPAV2KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
+                                                       ByteVector diversify)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification NXP AV2 with div : "
+                         << BufferHelper::getHex(diversify);
+    DESFireKeyType keyType = getNXPAV2KeyType(key);
+    return diversifyNXPAV2(*createNXPAV2Context(key, keyType), keyType, diversify,
+                           d_forceK2Use);
+}
+
+std::vector<ByteVector>
+NXPAV2KeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key,
+                                             const std::vector<ByteVector> &diversify,
+                                             unsigned int threads)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification NXP AV2 for " << diversify.size()
+                         << " inputs";
+    DESFireKeyType keyType = getNXPAV2KeyType(key);
+
+    std::vector<ByteVector> ret(diversify.size());
+    forEachRange(diversify.size(), threads, [&](size_t begin, size_t end) {
+        auto context = createNXPAV2Context(key, keyType);
+        for (size_t i = begin; i < end; ++i)
+            ret[i] = diversifyNXPAV2(*context, keyType, diversify[i], d_forceK2Use);
+    });
+    return ret;
+}
+
 void NXPAV2KeyDiversification::serialize(boost::property_tree::ptree &parentNode)
 {
     boost::property_tree::ptree node;
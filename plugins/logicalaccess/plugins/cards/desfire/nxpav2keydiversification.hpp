@@ -17,6 +17,16 @@ class LLA_CARDS_DESFIRE_API NXPAV2KeyDiversification : public NXPKeyDiversificat
                              ByteVector &diversify) override;
     ByteVector getDiversifiedKey(std::shared_ptr<Key> key, ByteVector diversify) override;
 
+    /**
+     * \brief Diversify the same key for many inputs at once.
+     *
+     * The master key is expanded once per worker thread and its CMAC subkeys are
+     * shared by all the inputs of that worker.
+     */
+    std::vector<ByteVector> getDiversifiedKeys(std::shared_ptr<Key> key,
+                                               const std::vector<ByteVector> &diversify,
+                                               unsigned int threads = 1) override;
+
     NXPAV2KeyDiversification()
         : d_revertAID(false)
         , d_forceK2Use(false)
@@ -36,17 +36,11 @@ void OmnitechKeyDiversification::initDiversification(ByteVector identifier,
     }
 }
 
-ByteVector OmnitechKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
-                                                         ByteVector diversify)
+/**
+ * \brief Get the data of a master key, zeroes if it is empty.
+ */
+static ByteVector getOmnitechKeyData(const std::shared_ptr<DESFireKey> &desfirekey)
 {
-    LOG(LogLevel::INFOS) << "Using key diversification Omnitech with div : "
-                         << BufferHelper::getHex(diversify);
-    ByteVector keydiv;
-
-    std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
-
-    ByteVector iv;
-    // Two time, to have ECB and not CBC mode
     ByteVector vkeydata;
     if (desfirekey->isEmpty())
     {
@@ -57,16 +51,27 @@ ByteVector OmnitechKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> ke
         vkeydata.insert(vkeydata.end(), desfirekey->getData(),
                         desfirekey->getData() + desfirekey->getLength());
     }
+    return vkeydata;
+}
 
-    ByteVector r = DESFireCrypto::sam_CBC_send(
-        vkeydata, iv, ByteVector(diversify.begin(), diversify.begin() + 8));
-    ByteVector r2 = DESFireCrypto::sam_CBC_send(
-        vkeydata, iv, ByteVector(diversify.begin() + 8, diversify.begin() + 16));
+/**
+ * \brief Diversify one input with a DES engine keyed with the master key.
+ */
+static ByteVector diversifyOmnitech(openssl::DESEngine &engine, unsigned char keyVersion,
+                                    const ByteVector &diversify)
+{
+    ByteVector keydiv;
+    ByteVector iv;
+    // Two time, to have ECB and not CBC mode
+    ByteVector r =
+        engine.cbcEncrypt(iv, ByteVector(diversify.begin(), diversify.begin() + 8));
+    ByteVector r2 =
+        engine.cbcEncrypt(iv, ByteVector(diversify.begin() + 8, diversify.begin() + 16));
 
     for (unsigned char i = 0; i < 8; ++i)
     {
-        r[7 - i] = static_cast<unsigned char>(
-            (r[7 - i] & 0xFE) | ((desfirekey->getKeyVersion() >> i) & 0x01));
+        r[7 - i] =
+            static_cast<unsigned char>((r[7 - i] & 0xFE) | ((keyVersion >> i) & 0x01));
         r2[i] = static_cast<unsigned char>(r2[i] & 0xFE);
     }
 
@@ -75,6 +80,36 @@ ByteVector OmnitechKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> ke
     return keydiv;
 }
 
+ByteVector OmnitechKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
+                                                         ByteVector diversify)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification Omnitech with div : "
+                         << BufferHelper::getHex(diversify);
+    std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
+    auto engine = DESFireCrypto::createDESEngine(getOmnitechKeyData(desfirekey));
+    return diversifyOmnitech(*engine, desfirekey->getKeyVersion(), diversify);
+}
+
+std::vector<ByteVector>
+OmnitechKeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key,
+                                               const std::vector<ByteVector> &diversify,
+                                               unsigned int threads)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification Omnitech for " << diversify.size()
+                         << " inputs";
+    std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
+    ByteVector vkeydata                    = getOmnitechKeyData(desfirekey);
+    unsigned char keyVersion               = desfirekey->getKeyVersion();
+
+    std::vector<ByteVector> ret(diversify.size());
+    forEachRange(diversify.size(), threads, [&](size_t begin, size_t end) {
+        auto engine = DESFireCrypto::createDESEngine(vkeydata);
+        for (size_t i = begin; i < end; ++i)
+            ret[i] = diversifyOmnitech(*engine, keyVersion, diversify[i]);
+    });
+    return ret;
+}
+
 void OmnitechKeyDiversification::serialize(boost::property_tree::ptree &parentNode)
 {
     boost::property_tree::ptree node;
@@ -36,18 +36,11 @@ void SagemKeyDiversification::initDiversification(ByteVector identifier,
     }
 }
 
-ByteVector SagemKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
-                                                      ByteVector diversify)
+/**
+ * \brief Get the data of a master key, zeroes if it is empty.
+ */
+static ByteVector getSagemKeyData(const std::shared_ptr<DESFireKey> &desfirekey)
 {
-    LOG(LogLevel::INFOS) << "Using key diversification Sagem with div : "
-                         << BufferHelper::getHex(diversify);
-    ByteVector keydiv;
-
-    std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
-
-    // Sagem diversification algo. Should be an option with SAM diversification soon...
-    ByteVector iv;
-    // Two time, to have ECB and not CBC mode (laazzyyy to create new function :))
     ByteVector vkeydata;
     if (desfirekey->isEmpty())
     {
@@ -58,16 +51,55 @@ ByteVector SagemKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
         vkeydata.insert(vkeydata.end(), desfirekey->getData(),
                         desfirekey->getData() + desfirekey->getLength());
     }
+    return vkeydata;
+}
 
-    ByteVector r = DESFireCrypto::sam_CBC_send(
-        vkeydata, iv, ByteVector(diversify.begin(), diversify.begin() + 8));
+/**
+ * \brief Diversify one input with a DES engine keyed with the master key.
+ */
+static ByteVector diversifySagem(openssl::DESEngine &engine, const ByteVector &diversify)
+{
+    ByteVector keydiv;
+    ByteVector iv;
+    // Two time, to have ECB and not CBC mode (laazzyyy to create new function :))
+    ByteVector r =
+        engine.cbcEncrypt(iv, ByteVector(diversify.begin(), diversify.begin() + 8));
     keydiv.insert(keydiv.end(), r.begin(), r.end());
-    ByteVector r2 = DESFireCrypto::sam_CBC_send(
-        vkeydata, iv, ByteVector(diversify.begin() + 8, diversify.begin() + 16));
+    ByteVector r2 =
+        engine.cbcEncrypt(iv, ByteVector(diversify.begin() + 8, diversify.begin() + 16));
     keydiv.insert(keydiv.end(), r2.begin(), r2.end());
     return keydiv;
 }
 
+ByteVector SagemKeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
+                                                      ByteVector diversify)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification Sagem with div : "
+                         << BufferHelper::getHex(diversify);
+    // Sagem diversification algo. Should be an option with SAM diversification soon...
+    std::shared_ptr<DESFireKey> desfirekey = std::dynamic_pointer_cast<DESFireKey>(key);
+    auto engine = DESFireCrypto::createDESEngine(getSagemKeyData(desfirekey));
+    return diversifySagem(*engine, diversify);
+}
+
+std::vector<ByteVector>
+SagemKeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key,
+                                            const std::vector<ByteVector> &diversify,
+                                            unsigned int threads)
+{
+    LOG(LogLevel::INFOS) << "Using key diversification Sagem for " << diversify.size()
+                         << " inputs";
+    ByteVector vkeydata = getSagemKeyData(std::dynamic_pointer_cast<DESFireKey>(key));
+
+    std::vector<ByteVector> ret(diversify.size());
+    forEachRange(diversify.size(), threads, [&](size_t begin, size_t end) {
+        auto engine = DESFireCrypto::createDESEngine(vkeydata);
+        for (size_t i = begin; i < end; ++i)
+            ret[i] = diversifySagem(*engine, diversify[i]);
+    });
+    return ret;
+}
+
 void SagemKeyDiversification::serialize(boost::property_tree::ptree &parentNode)
 {
     boost::property_tree::ptree node;
@@ -31,6 +31,12 @@ class LLA_CARDS_ISO7816_API ISO7816FuzzingReaderCardAdapter
 
     ByteVector sendCommand(const ByteVector &command, long timeout = -1) override;
 
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long timeout = -1) override
+    {
+        return sendCommandsInSequence(commands, timeout);
+    }
+
   private:
     static int index;
     int currentIndex;
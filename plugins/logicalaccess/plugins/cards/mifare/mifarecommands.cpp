@@ -21,6 +21,7 @@ namespace logicalaccess
 void MifareCommands::authenticate(std::shared_ptr<Location> location,
                                   std::shared_ptr<AccessInfo> ai, bool write)
 {
+    LLA_LOG_CTX("MifareCommands::authenticate");
     EXCEPTION_ASSERT_WITH_LOG(location, std::invalid_argument,
                               "location cannot be null.");
     EXCEPTION_ASSERT_WITH_LOG(ai, std::invalid_argument, "ai cannot be null.");
@@ -295,6 +296,7 @@ MifareKeyType MifareCommands::getKeyType(const MifareAccessInfo::SectorAccessBit
 void MifareCommands::authenticate(MifareKeyType keytype, std::shared_ptr<MifareKey> key,
                                   int sector, int block, bool /*write*/)
 {
+    LLA_LOG_CTX("MifareCommands::authenticate");
     std::shared_ptr<MifareLocation> location(new MifareLocation());
     location->sector = sector;
     location->block  = block;
@@ -315,6 +317,7 @@ ByteVector MifareCommands::readSector(int sector, int start_block,
                                       const MifareAccessInfo::SectorAccessBits &sab,
                                       bool readtrailer)
 {
+    LLA_LOG_CTX("MifareCommands::readSector");
     ByteVector ret;
 
     int nbblocks = getNbBlocks(sector);
@@ -345,6 +348,7 @@ void MifareCommands::writeSector(
     unsigned char userbyte, MifareAccessInfo::SectorAccessBits *newsab,
     std::shared_ptr<MifareKey> newkeyA, std::shared_ptr<MifareKey> newkeyB)
 {
+    LLA_LOG_CTX("MifareCommands::writeSector");
     size_t retlen  = 0;
     ByteVector tmp = buf;
     MifareKeyType keytype, pkeytype = KT_KEY_A;
@@ -428,6 +432,7 @@ ByteVector MifareCommands::readSectors(int start_sector, int stop_sector, int st
                                        std::shared_ptr<MifareKey> keyB,
                                        const MifareAccessInfo::SectorAccessBits &sab)
 {
+    LLA_LOG_CTX("MifareCommands::readSectors");
     if (start_sector > stop_sector)
     {
         THROW_EXCEPTION_WITH_LOG(std::invalid_argument,
@@ -455,6 +460,7 @@ void MifareCommands::writeSectors(int start_sector, int stop_sector, int start_b
                                   std::shared_ptr<MifareKey> newkeyA,
                                   std::shared_ptr<MifareKey> newkeyB)
 {
+    LLA_LOG_CTX("MifareCommands::writeSectors");
     if (start_sector > stop_sector)
     {
         THROW_EXCEPTION_WITH_LOG(std::invalid_argument,
@@ -13,160 +13,213 @@
 #include <logicalaccess/bufferhelper.hpp>
 #include <logicalaccess/iks/IslogKeyServer.hpp>
 #include <logicalaccess/iks/RemoteCrypto.hpp>
+#include <openssl/crypto.h>
 
 namespace logicalaccess
 {
 namespace openssl
 {
-ByteVector CMACCrypto::cmac(const ByteVector &key, std::string crypto,
-                            const ByteVector &data, const ByteVector &iv,
-                            int padding_size)
+CMACContext::CMACContext(const ByteVector &key,
+                         std::shared_ptr<SymmetricCipher> cipherMAC)
+    : d_des(std::dynamic_pointer_cast<DESCipher>(cipherMAC) != nullptr)
+    , d_key(key)
+    , d_length(0)
 {
-    std::shared_ptr<OpenSSLSymmetricCipher> cipherMAC;
-    if (crypto == "des" || crypto == "3des")
-    {
-        cipherMAC.reset(new DESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
-    }
-    else if (crypto == "aes")
-    {
-        cipherMAC.reset(new AESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
-    }
-    else
-    {
-        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
-                                 "Wrong crypto mechanism: " + crypto);
-    }
+    OpenSSLInitializer::GetInstance();
 
-    return CMACCrypto::cmac(key, cipherMAC, data, iv, padding_size);
-}
-
-ByteVector CMACCrypto::cmac(const ByteVector &key,
-                            std::shared_ptr<SymmetricCipher> cipherMAC,
-                            const ByteVector &data, const ByteVector &lastIV,
-                            unsigned int padding_size, bool forceK2Use)
-{
-    std::shared_ptr<OpenSSLSymmetricCipher> cipherK1K2;
-
-    std::shared_ptr<SymmetricKey> symkey;
-    std::shared_ptr<InitializationVector> iv;
     // 3DES
-    if (std::dynamic_pointer_cast<DESCipher>(cipherMAC))
+    if (d_des)
     {
-        cipherK1K2.reset(new DESCipher(OpenSSLSymmetricCipher::ENC_MODE_ECB));
-
-        symkey.reset(new DESSymmetricKey(DESSymmetricKey::createFromData(key)));
-        iv.reset(new DESInitializationVector(DESInitializationVector::createNull()));
+        d_cipher.reset(new DESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
+        d_symkey.reset(new DESSymmetricKey(DESSymmetricKey::createFromData(key)));
     }
     // AES
     else
     {
-        cipherK1K2.reset(new AESCipher(OpenSSLSymmetricCipher::ENC_MODE_ECB));
-
-        symkey.reset(new AESSymmetricKey(AESSymmetricKey::createFromData(key)));
-        iv.reset(new AESInitializationVector(AESInitializationVector::createNull()));
+        d_cipher.reset(new AESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
+        d_symkey.reset(new AESSymmetricKey(AESSymmetricKey::createFromData(key)));
     }
 
-    unsigned char Rb;
-
     // TDES
-    if (cipherMAC->getBlockSize() == 8)
-    {
-        Rb = 0x1b;
-    }
+    unsigned char Rb = 0x1b;
     // AES
-    else
+    if (d_cipher->getBlockSize() != 8)
     {
         Rb = 0x87;
     }
 
-    ByteVector blankbuf;
-    blankbuf.resize(cipherK1K2->getBlockSize(), 0x00);
-    ByteVector L;
-    cipherK1K2->cipher(blankbuf, L, *symkey.get(), *iv.get(), false);
+    // One block with a null IV, same as ECB.
+    ByteVector L = encrypt(ByteVector(d_cipher->getBlockSize(), 0x00), {});
 
-    ByteVector K1;
     if ((L[0] & 0x80) == 0x00)
     {
-        K1 = shift_string(L);
+        d_k1 = CMACCrypto::shift_string(L);
     }
     else
     {
-        K1 = shift_string(L, Rb);
+        d_k1 = CMACCrypto::shift_string(L, Rb);
     }
 
-    ByteVector K2;
-    if ((K1[0] & 0x80) == 0x00)
+    if ((d_k1[0] & 0x80) == 0x00)
     {
-        K2 = shift_string(K1);
+        d_k2 = CMACCrypto::shift_string(d_k1);
     }
     else
     {
-        K2 = shift_string(K1, Rb);
+        d_k2 = CMACCrypto::shift_string(d_k1, Rb);
+    }
+    OPENSSL_cleanse(L.data(), L.size());
+}
+
+CMACContext::~CMACContext()
+{
+    OPENSSL_cleanse(d_key.data(), d_key.size());
+    OPENSSL_cleanse(d_k1.data(), d_k1.size());
+    OPENSSL_cleanse(d_k2.data(), d_k2.size());
+}
+
+bool CMACContext::matches(const ByteVector &key,
+                          const std::shared_ptr<SymmetricCipher> &cipherMAC) const
+{
+    return d_key == key &&
+           d_des == (std::dynamic_pointer_cast<DESCipher>(cipherMAC) != nullptr);
+}
+
+unsigned char CMACContext::getBlockSize() const
+{
+    return d_cipher->getBlockSize();
+}
+
+ByteVector CMACContext::cmac(const ByteVector &data, const ByteVector &lastIV,
+                             unsigned int padding_size, bool forceK2Use)
+{
+    ByteVector padded_data = data;
+    padLastBlock(padded_data, data.size(), padding_size, forceK2Use);
+
+    ByteVector ret = encrypt(padded_data, lastIV);
+    if (ret.size() > getBlockSize())
+    {
+        ret = ByteVector(ret.end() - getBlockSize(), ret.end());
     }
+    return ret;
+}
 
-	if (padding_size == 0)
+void CMACContext::start(const ByteVector &lastIV)
+{
+    d_chain = lastIV;
+    d_pending.clear();
+    d_length = 0;
+}
+
+void CMACContext::update(const ByteVector &data)
+{
+    d_pending.insert(d_pending.end(), data.begin(), data.end());
+    d_length += data.size();
+
+    // Keep the last block, even complete, it is XORed with K1 or K2 by stop().
+    const size_t blockSize = getBlockSize();
+    if (d_pending.size() > blockSize)
     {
-        padding_size = cipherMAC->getBlockSize();
+        const size_t ready = ((d_pending.size() - 1) / blockSize) * blockSize;
+        ByteVector blocks(d_pending.begin(), d_pending.begin() + ready);
+        d_pending.erase(d_pending.begin(), d_pending.begin() + ready);
+
+        ByteVector ret = encrypt(blocks, d_chain);
+        d_chain.assign(ret.end() - blockSize, ret.end());
     }
-    int pad = (padding_size - (data.size() % padding_size)) % padding_size;
-    if (data.size() == 0)
+}
+
+ByteVector CMACContext::stop(unsigned int padding_size, bool forceK2Use)
+{
+    ByteVector last;
+    last.swap(d_pending);
+    padLastBlock(last, d_length, padding_size, forceK2Use);
+
+    ByteVector ret = encrypt(last, d_chain);
+    if (ret.size() > getBlockSize())
+    {
+        ret = ByteVector(ret.end() - getBlockSize(), ret.end());
+    }
+    start();
+    return ret;
+}
+
+void CMACContext::padLastBlock(ByteVector &buf, size_t length, unsigned int padding_size,
+                               bool forceK2Use) const
+{
+    if (padding_size == 0)
+    {
+        padding_size = getBlockSize();
+    }
+    size_t pad = (padding_size - (length % padding_size)) % padding_size;
+    if (length == 0)
         pad = padding_size;
 
-    ByteVector padded_data = data;
     if (pad > 0)
     {
-        padded_data.push_back(0x80);
-        if (pad > 1)
-        {
-            for (int i = 0; i < (pad - 1); ++i)
-            {
-                padded_data.push_back(0x00);
-            }
-        }
+        buf.push_back(0x80);
+        buf.resize(buf.size() + pad - 1, 0x00);
     }
 
-    // XOR with K1
-    if (pad == 0 && !forceK2Use)
+    // XOR with K1, or K2 when padded
+    const ByteVector &K = (pad == 0 && !forceK2Use) ? d_k1 : d_k2;
+    for (size_t i = 0; i < K.size(); ++i)
     {
-        for (unsigned int i = 0; i < K1.size(); ++i)
-        {
-            padded_data[padded_data.size() - K1.size() + i] = static_cast<unsigned char>(
-                padded_data[padded_data.size() - K1.size() + i] ^ K1[i]);
-        }
+        buf[buf.size() - K.size() + i] =
+            static_cast<unsigned char>(buf[buf.size() - K.size() + i] ^ K[i]);
     }
-    // XOR with K2
+}
+
+ByteVector CMACContext::encrypt(const ByteVector &data, const ByteVector &iv)
+{
+    ByteVector ret;
+    // 3DES
+    if (d_des)
+    {
+        DESInitializationVector desiv = iv.size() > 0
+                                            ? DESInitializationVector::createFromData(iv)
+                                            : DESInitializationVector::createNull();
+        d_cipher->cipher(data, ret, *d_symkey, desiv, false);
+    }
+    // AES
     else
     {
-        for (unsigned int i = 0; i < K2.size(); ++i)
-        {
-            padded_data[padded_data.size() - K2.size() + i] = static_cast<unsigned char>(
-                padded_data[padded_data.size() - K2.size() + i] ^ K2[i]);
-        }
+        AESInitializationVector aesiv = iv.size() > 0
+                                            ? AESInitializationVector::createFromData(iv)
+                                            : AESInitializationVector::createNull();
+        d_cipher->cipher(data, ret, *d_symkey, aesiv, false);
     }
+    return ret;
+}
 
-    ByteVector ret;
-    if (lastIV.size() > 0)
-	{
-		// 3DES
-		if (std::dynamic_pointer_cast<DESCipher>(cipherMAC))
-		{
-			iv.reset(
-				new DESInitializationVector(DESInitializationVector::createFromData(lastIV)));
-		}
-		// AES
-		else
-		{
-			iv.reset(
-				new AESInitializationVector(AESInitializationVector::createFromData(lastIV)));
-		}
-	}
-    cipherMAC->cipher(padded_data, ret, *symkey.get(), *iv.get(), false);
-
-	if (ret.size() > cipherMAC->getBlockSize())
+ByteVector CMACCrypto::cmac(const ByteVector &key, std::string crypto,
+                            const ByteVector &data, const ByteVector &iv,
+                            int padding_size)
+{
+    std::shared_ptr<OpenSSLSymmetricCipher> cipherMAC;
+    if (crypto == "des" || crypto == "3des")
     {
-        ret = ByteVector(ret.end() - cipherMAC->getBlockSize(), ret.end());
+        cipherMAC.reset(new DESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
     }
-    return ret;
+    else if (crypto == "aes")
+    {
+        cipherMAC.reset(new AESCipher(OpenSSLSymmetricCipher::ENC_MODE_CBC));
+    }
+    else
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Wrong crypto mechanism: " + crypto);
+    }
+
+    return CMACCrypto::cmac(key, cipherMAC, data, iv, padding_size);
+}
+
+ByteVector CMACCrypto::cmac(const ByteVector &key,
+                            std::shared_ptr<SymmetricCipher> cipherMAC,
+                            const ByteVector &data, const ByteVector &lastIV,
+                            unsigned int padding_size, bool forceK2Use)
+{
+    return CMACContext(key, cipherMAC).cmac(data, lastIV, padding_size, forceK2Use);
 }
 
 ByteVector CMACCrypto::shift_string(const ByteVector &buf, unsigned char xorparam)
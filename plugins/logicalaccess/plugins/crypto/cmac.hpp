@@ -11,6 +11,115 @@ namespace logicalaccess
 {
 namespace openssl
 {
+/**
+ * \brief CMAC state for one key: the keyed cipher and the K1/K2 subkeys.
+ *
+ * The subkeys are derived once at construction, so a context created when the
+ * session key is established can be reused for every MAC of the session, either
+ * in one call with cmac() or incrementally with start(), update() and stop().
+ * A context must not be used by several threads at once.
+ */
+class LLA_CRYPTO_API CMACContext
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param key The key to use.
+     * \param cipherMAC A cipher of the MAC algorithm (DESCipher or AESCipher).
+     */
+    CMACContext(const ByteVector &key, std::shared_ptr<SymmetricCipher> cipherMAC);
+
+    ~CMACContext();
+
+    /**
+     * \brief Check if the context was created for a key and algorithm.
+     * \param key The key.
+     * \param cipherMAC A cipher of the MAC algorithm.
+     * \return True if the context can be used for this key and algorithm.
+     */
+    bool matches(const ByteVector &key,
+                 const std::shared_ptr<SymmetricCipher> &cipherMAC) const;
+
+    unsigned char getBlockSize() const;
+
+    const ByteVector &getK1() const
+    {
+        return d_k1;
+    }
+
+    const ByteVector &getK2() const
+    {
+        return d_k2;
+    }
+
+    /**
+     * \brief Calculate the MAC of a message, same as CMACCrypto::cmac.
+     * \param data The data buffer to calculate CMAC.
+     * \param lastIV The last initialisation vector.
+     * \param padding_size The padding size, the block size if 0.
+     * \param forceK2Use Use K2 even if no padding is needed.
+     * \return The last cipher block.
+     */
+    ByteVector cmac(const ByteVector &data, const ByteVector &lastIV = {},
+                    unsigned int padding_size = 0, bool forceK2Use = false);
+
+    /**
+     * \brief Start a new incremental MAC calculation.
+     * \param lastIV The last initialisation vector.
+     */
+    void start(const ByteVector &lastIV = {});
+
+    /**
+     * \brief Add data to the MAC calculation. Only complete blocks are ciphered,
+     * the last block is kept until stop().
+     * \param data The data.
+     */
+    void update(const ByteVector &data);
+
+    /**
+     * \brief Finish the MAC calculation started with start().
+     * \param padding_size The padding size, the block size if 0.
+     * \param forceK2Use Use K2 even if no padding is needed.
+     * \return The last cipher block.
+     */
+    ByteVector stop(unsigned int padding_size = 0, bool forceK2Use = false);
+
+  private:
+    /**
+     * \brief Pad the last block and XOR it with K1 or K2.
+     * \param buf The buffer ending with the last data block.
+     * \param length The total data length.
+     */
+    void padLastBlock(ByteVector &buf, size_t length, unsigned int padding_size,
+                      bool forceK2Use) const;
+
+    ByteVector encrypt(const ByteVector &data, const ByteVector &iv);
+
+    bool d_des;
+
+    ByteVector d_key;
+
+    ByteVector d_k1;
+
+    ByteVector d_k2;
+
+    std::shared_ptr<OpenSSLSymmetricCipher> d_cipher;
+
+    std::shared_ptr<SymmetricKey> d_symkey;
+
+    /**
+     * \brief The chaining value of the incremental calculation.
+     */
+    ByteVector d_chain;
+
+    /**
+     * \brief The data not ciphered yet, at most one block.
+     */
+    ByteVector d_pending;
+
+    size_t d_length;
+};
+
 /**
  * NIST SP 800-38B / ISO 9797-1:2011 MAC Algorithm 5
 */
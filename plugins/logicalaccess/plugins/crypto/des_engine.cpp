@@ -0,0 +1,155 @@
+/**
+ * \file des_engine.cpp
+ * \brief DES/3DES engine working on whole buffers.
+ */
+
+#include <logicalaccess/plugins/crypto/des_engine.hpp>
+#include <logicalaccess/plugins/crypto/openssl.hpp>
+#include <logicalaccess/plugins/crypto/openssl_exception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <cstring>
+#include <openssl/crypto.h>
+
+namespace logicalaccess
+{
+namespace openssl
+{
+DESEngine::DESEngine(const ByteVector &key)
+    : d_key(key)
+{
+    OpenSSLInitializer::GetInstance();
+
+    EXCEPTION_ASSERT_WITH_LOG(key.size() == 8 || key.size() == 16 || key.size() == 24,
+                              LibLogicalAccessException,
+                              "DES engine needs a 8, 16 or 24 bytes key.");
+    if (d_key.size() == 8)
+    {
+        d_key.insert(d_key.end(), key.begin(), key.end());
+    }
+
+    for (auto &ctx : d_contexts)
+    {
+        ctx = nullptr;
+    }
+}
+
+DESEngine::~DESEngine()
+{
+    for (auto &ctx : d_contexts)
+    {
+        if (ctx)
+        {
+            EVP_CIPHER_CTX_free(ctx);
+        }
+    }
+    OPENSSL_cleanse(d_key.data(), d_key.size());
+}
+
+EVP_CIPHER_CTX *DESEngine::getContext(ContextIndex index, const ByteVector &iv)
+{
+    unsigned char ivbuf[8] = {0};
+    if (iv.size() >= 8)
+    {
+        memcpy(ivbuf, iv.data(), 8);
+    }
+
+    EVP_CIPHER_CTX *&ctx = d_contexts[index];
+    int r;
+    if (ctx)
+    {
+        // Same key, only restart the chaining.
+        r = EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr,
+                              index == ECB_DECRYPT ? nullptr : ivbuf, -1);
+    }
+    else
+    {
+        const bool ede3 = d_key.size() == 24;
+        const EVP_CIPHER *evpCipher;
+        if (index == ECB_DECRYPT)
+            evpCipher = ede3 ? EVP_des_ede3_ecb() : EVP_des_ede_ecb();
+        else
+            evpCipher = ede3 ? EVP_des_ede3_cbc() : EVP_des_ede_cbc();
+
+        ctx = EVP_CIPHER_CTX_new();
+        EXCEPTION_ASSERT_WITH_LOG(ctx, OpenSSLException,
+                                  "Cannot allocate the cipher context.");
+        r = EVP_CipherInit_ex(ctx, evpCipher, nullptr, d_key.data(),
+                              index == ECB_DECRYPT ? nullptr : ivbuf,
+                              index == CBC_ENCRYPT ? 1 : 0);
+    }
+    if (r == 1)
+    {
+        r = EVP_CIPHER_CTX_set_padding(ctx, 0);
+    }
+
+    if (r != 1)
+    {
+        EVP_CIPHER_CTX_free(ctx);
+        ctx = nullptr;
+        THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
+    }
+    return ctx;
+}
+
+void DESEngine::update(EVP_CIPHER_CTX *ctx, const unsigned char *in, size_t len,
+                       unsigned char *out)
+{
+    int outlen = 0;
+    if (EVP_CipherUpdate(ctx, out, &outlen, in, static_cast<int>(len)) != 1 ||
+        static_cast<size_t>(outlen) != len)
+    {
+        THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
+    }
+}
+
+ByteVector DESEngine::cbcEncrypt(const ByteVector &iv, const ByteVector &data)
+{
+    ByteVector ret((data.size() / 8) * 8);
+    if (!ret.empty())
+    {
+        update(getContext(CBC_ENCRYPT, iv), data.data(), ret.size(), ret.data());
+    }
+    return ret;
+}
+
+ByteVector DESEngine::cbcDecrypt(const ByteVector &iv, const ByteVector &data)
+{
+    ByteVector ret((data.size() / 8) * 8);
+    if (!ret.empty())
+    {
+        update(getContext(CBC_DECRYPT, iv), data.data(), ret.size(), ret.data());
+    }
+    return ret;
+}
+
+ByteVector DESEngine::cbcSendDecipher(const ByteVector &iv, const ByteVector &data)
+{
+    ByteVector ret((data.size() / 8) * 8);
+    if (ret.empty())
+    {
+        return ret;
+    }
+
+    // Each block depends on the previous output, so they go one by one.
+    EVP_CIPHER_CTX *ctx = getContext(ECB_DECRYPT, iv);
+    unsigned char in[8];
+    const unsigned char *chain = iv.size() >= 8 ? iv.data() : nullptr;
+    for (size_t i = 0; i < ret.size(); i += 8)
+    {
+        memcpy(in, &data[i], 8);
+        if (chain)
+        {
+            for (size_t j = 0; j < 8; ++j)
+            {
+                in[j] ^= chain[j];
+            }
+        }
+        update(ctx, in, 8, &ret[i]);
+        chain = &ret[i];
+    }
+    return ret;
+}
+}
+}
@@ -0,0 +1,93 @@
+/**
+ * \file des_engine.hpp
+ * \brief DES/3DES engine working on whole buffers.
+ */
+
+#ifndef DES_ENGINE_HPP
+#define DES_ENGINE_HPP
+
+#include <logicalaccess/plugins/crypto/lla_crypto_api.hpp>
+#include <logicalaccess/lla_fwd.hpp>
+#include <openssl/evp.h>
+
+namespace logicalaccess
+{
+namespace openssl
+{
+/**
+ * \brief A DES/3DES engine keyed once, processing whole buffers.
+ *
+ * The key schedule is computed the first time a mode is used and kept for the
+ * life of the engine; each call then resets the IV and ciphers the buffer with a
+ * single OpenSSL call. Single DES keys (8 bytes) run as 2K3DES with K1 == K2, which
+ * gives the same result without the OpenSSL legacy DES cipher.
+ *
+ * Only complete 8 bytes blocks are processed, trailing bytes are ignored.
+ */
+class LLA_CRYPTO_API DESEngine
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param key The key, 8 (DES), 16 (2K3DES) or 24 (3K3DES) bytes.
+     */
+    explicit DESEngine(const ByteVector &key);
+
+    DESEngine(const DESEngine &) = delete;
+
+    DESEngine &operator=(const DESEngine &) = delete;
+
+    ~DESEngine();
+
+    /**
+     * \brief Encrypt in CBC mode.
+     * \param iv The initialization vector, null if empty.
+     * \param data The data.
+     * \return The encrypted data.
+     */
+    ByteVector cbcEncrypt(const ByteVector &iv, const ByteVector &data);
+
+    /**
+     * \brief Decrypt in CBC mode.
+     * \param iv The initialization vector, null if empty.
+     * \param data The data.
+     * \return The decrypted data.
+     */
+    ByteVector cbcDecrypt(const ByteVector &iv, const ByteVector &data);
+
+    /**
+     * \brief DESFire native send mode: each block is XORed with the previous
+     * output block, as in CBC encryption, then deciphered.
+     * \param iv The initialization vector, null if empty.
+     * \param data The data.
+     * \return The processed data.
+     */
+    ByteVector cbcSendDecipher(const ByteVector &iv, const ByteVector &data);
+
+  private:
+    enum ContextIndex
+    {
+        CBC_ENCRYPT = 0,
+        CBC_DECRYPT,
+        ECB_DECRYPT,
+        CONTEXT_COUNT
+    };
+
+    /**
+     * \brief Get a keyed context, ready for a new buffer.
+     * \param index The context.
+     * \param iv The initialization vector, ignored in ECB mode.
+     */
+    EVP_CIPHER_CTX *getContext(ContextIndex index, const ByteVector &iv);
+
+    void update(EVP_CIPHER_CTX *ctx, const unsigned char *in, size_t len,
+                unsigned char *out);
+
+    ByteVector d_key;
+
+    EVP_CIPHER_CTX *d_contexts[CONTEXT_COUNT];
+};
+}
+}
+
+#endif /* DES_ENGINE_HPP */
@@ -15,6 +15,7 @@
 #include <logicalaccess/plugins/crypto/openssl_exception.hpp>
 
 #include <cstring>
+#include <openssl/crypto.h>
 
 namespace logicalaccess
 {
@@ -24,6 +25,35 @@ SymmetricCipher::~SymmetricCipher()
 {
 }
 
+struct OpenSSLSymmetricCipher::KeyedContext
+{
+    KeyedContext()
+        : ctx(EVP_CIPHER_CTX_new())
+        , evpCipher(nullptr)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(ctx, OpenSSLException,
+                                  "Cannot allocate EVP cipher context.");
+    }
+
+    ~KeyedContext()
+    {
+        EVP_CIPHER_CTX_free(ctx);
+        if (!key.empty())
+            OPENSSL_cleanse(&key[0], key.size());
+    }
+
+    KeyedContext(const KeyedContext &) = delete;
+    KeyedContext &operator=(const KeyedContext &) = delete;
+
+    EVP_CIPHER_CTX *ctx;
+
+    /**
+     * \brief The cipher and key the context was initialized with.
+     */
+    const EVP_CIPHER *evpCipher;
+    ByteVector key;
+};
+
 OpenSSLSymmetricCipher::~OpenSSLSymmetricCipher()
 {
 }
@@ -34,6 +64,24 @@ OpenSSLSymmetricCipher::OpenSSLSymmetricCipher(EncMode _mode)
     OpenSSLInitializer::GetInstance();
 }
 
+OpenSSLSymmetricCipher::OpenSSLSymmetricCipher(const OpenSSLSymmetricCipher &other)
+    : SymmetricCipher(other)
+    , d_mode(other.d_mode)
+{
+}
+
+OpenSSLSymmetricCipher &OpenSSLSymmetricCipher::operator=(const OpenSSLSymmetricCipher &other)
+{
+    if (this != &other)
+    {
+        SymmetricCipher::operator=(other);
+        d_mode = other.d_mode;
+        d_contexts[M_ENCRYPT].reset();
+        d_contexts[M_DECRYPT].reset();
+    }
+    return *this;
+}
+
 OpenSSLSymmetricCipherContext
 OpenSSLSymmetricCipher::start(Method method, const SymmetricKey &key,
                               const InitializationVector &iv, bool padding) const
@@ -149,26 +197,69 @@ ByteVector OpenSSLSymmetricCipher::stop(OpenSSLSymmetricCipherContext &context)
     return data;
 }
 
+void OpenSSLSymmetricCipher::process(Method method, const ByteVector &src,
+                                     ByteVector &dest, const SymmetricKey &key,
+                                     const InitializationVector &iv, bool padding)
+{
+    const EVP_CIPHER *evpCipher = getEVPCipher(key);
+
+    EXCEPTION_ASSERT(evpCipher, std::invalid_argument,
+                     "No cipher found that can use the supplied key");
+
+    std::unique_ptr<KeyedContext> &context = d_contexts[method];
+    if (!context)
+        context.reset(new KeyedContext());
+
+    const int enc            = method == M_ENCRYPT ? 1 : 0;
+    const unsigned char *ivp = iv.data().empty() ? nullptr : &iv.data()[0];
+    int r;
+    if (context->evpCipher == evpCipher && context->key == key.data())
+    {
+        // Same key: keep the key schedule, only reset the IV and the context state.
+        r = EVP_CipherInit_ex(context->ctx, nullptr, nullptr, nullptr, ivp, enc);
+    }
+    else
+    {
+        r = EVP_CipherInit_ex(context->ctx, evpCipher, nullptr, &key.data()[0], ivp, enc);
+        context->evpCipher = r == 1 ? evpCipher : nullptr;
+        context->key       = key.data();
+    }
+    if (r != 1)
+    {
+        context.reset();
+        THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
+    }
+    EVP_CIPHER_CTX_set_padding(context->ctx, padding ? 1 : 0);
+
+    ByteVector out(src.size() + EVP_CIPHER_CTX_block_size(context->ctx));
+    int outlen   = 0;
+    int finallen = 0;
+    r = EVP_CipherUpdate(context->ctx, &out[0], &outlen, src.empty() ? nullptr : &src[0],
+                         static_cast<int>(src.size()));
+    if (r == 1)
+        r = EVP_CipherFinal_ex(context->ctx, &out[0] + outlen, &finallen);
+    if (r != 1)
+    {
+        context.reset();
+        THROW_EXCEPTION_WITH_LOG(OpenSSLException, "OpenSSL Error.");
+    }
+
+    out.resize(static_cast<size_t>(outlen + finallen));
+    dest.swap(out);
+}
+
 void OpenSSLSymmetricCipher::cipher(const ByteVector &src, ByteVector &dest,
                                     const SymmetricKey &key,
                                     const InitializationVector &iv, bool padding)
 {
-    OpenSSLSymmetricCipherContext context = start(M_ENCRYPT, key, iv, padding);
-
-    update(context, src);
-
-    dest = stop(context);
+    process(M_ENCRYPT, src, dest, key, iv, padding);
 }
 
 void OpenSSLSymmetricCipher::decipher(const ByteVector &src, ByteVector &dest,
                                       const SymmetricKey &key,
                                       const InitializationVector &iv, bool padding)
 {
-    OpenSSLSymmetricCipherContext context = start(M_DECRYPT, key, iv, padding);
-
-    update(context, src);
-
-    dest = stop(context);
+    process(M_DECRYPT, src, dest, key, iv, padding);
 }
 }
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include <logicalaccess/plugins/crypto/symmetric_cipher.hpp>
 #include <openssl/evp.h>
+#include <memory>
 
 namespace logicalaccess
 {
@@ -27,7 +28,10 @@ class OpenSSLSymmetricCipherContext;
  * data.
  *
  * OpenSSLSymmetricCipher also provides helper methods cipher() and decipher() to quickly
- * cipher or decipher a buffer.
+ * cipher or decipher a buffer. They keep one OpenSSL context per direction, keyed by the
+ * last key used: while the key does not change, only the IV is reset between calls and
+ * the key schedule is not computed again. An instance must therefore not be used by
+ * several threads at once.
  */
 class LLA_CRYPTO_API OpenSSLSymmetricCipher : public SymmetricCipher
 {
@@ -60,6 +64,13 @@ class LLA_CRYPTO_API OpenSSLSymmetricCipher : public SymmetricCipher
      */
     explicit OpenSSLSymmetricCipher(EncMode mode);
 
+    /**
+     * \brief Copy constructor. The cached contexts are not shared.
+     */
+    OpenSSLSymmetricCipher(const OpenSSLSymmetricCipher &other);
+
+    OpenSSLSymmetricCipher &operator=(const OpenSSLSymmetricCipher &other);
+
     virtual ~OpenSSLSymmetricCipher();
 
     /**
@@ -134,10 +145,26 @@ class LLA_CRYPTO_API OpenSSLSymmetricCipher : public SymmetricCipher
     }
 
   private:
+    /**
+     * \brief An OpenSSL context initialized with a key.
+     */
+    struct KeyedContext;
+
+    /**
+     * \brief Cipher or decipher a buffer with the cached context of the method.
+     */
+    void process(Method method, const ByteVector &src, ByteVector &dest,
+                 const SymmetricKey &key, const InitializationVector &iv, bool padding);
+
     /**
      * \brief The encryption mode.
      */
     EncMode d_mode;
+
+    /**
+     * \brief The cached contexts, indexed by method.
+     */
+    std::unique_ptr<KeyedContext> d_contexts[2];
 };
 }
 }
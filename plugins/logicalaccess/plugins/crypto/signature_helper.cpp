@@ -18,79 +18,112 @@ static void fail(const std::string &why)
 
 namespace
 {
-// Verification helper with RAII construct to not leak memory on error.
-struct VerificationHelper
+EVP_MD_CTX *new_md_ctx()
 {
-    explicit VerificationHelper(const std::string &pem_public_key)
-        : bio(nullptr)
-        , pkey(nullptr)
-    {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    EVP_MD_CTX *ctx = EVP_MD_CTX_create();
+#else
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+#endif
+    if (ctx == nullptr)
+        throw std::runtime_error("EVP_MD_CTX_new() failed");
+    return ctx;
+}
 
+void free_md_ctx(EVP_MD_CTX *ctx)
+{
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_MD_CTX_init(&ctx);
+    EVP_MD_CTX_destroy(ctx);
 #else
-        ctx = EVP_MD_CTX_new();
-        if (ctx == nullptr)
-            throw std::runtime_error("EVP_MD_CTX_new() failed");
+    EVP_MD_CTX_free(ctx);
 #endif
+}
 
-        // We cast away constness for older openssl version.
-        bio = BIO_new_mem_buf(const_cast<char *>(pem_public_key.c_str()),
-                              pem_public_key.size());
-        if (bio == nullptr)
-            fail("Cannot wrap public key in BIO object");
+EVP_PKEY *load_public_key(const std::string &pem_public_key)
+{
+    // We cast away constness for older openssl version.
+    BIO *bio = BIO_new_mem_buf(const_cast<char *>(pem_public_key.c_str()),
+                               static_cast<int>(pem_public_key.size()));
+    if (bio == nullptr)
+        fail("Cannot wrap public key in BIO object");
 
-        pkey = PEM_read_bio_PUBKEY(bio, NULL, NULL, NULL);
-        if (pkey == nullptr)
-            fail("Cannot load public key");
-    }
+    EVP_PKEY *pkey = PEM_read_bio_PUBKEY(bio, NULL, NULL, NULL);
+    BIO_free_all(bio);
+    if (pkey == nullptr)
+        fail("Cannot load public key");
+    return pkey;
+}
+}
 
-    EVP_MD_CTX *get_ctx()
+bool SignatureHelper::verify_sha512(const std::string &data, const std::string &signature,
+                                    const std::string &pem_pubkey)
+{
+    SignatureVerifier verifier(pem_pubkey);
+    return verifier.verify_sha512(data, signature);
+}
+
+SignatureVerifier::SignatureVerifier(const std::string &pem_pubkey)
+    : pkey_(nullptr)
+    , base_ctx_(nullptr)
+{
+    try
     {
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        return &ctx;
-#else
-        return ctx;
-#endif
+        pkey_     = load_public_key(pem_pubkey);
+        base_ctx_ = new_md_ctx();
+        if (1 != EVP_DigestVerifyInit(base_ctx_, NULL, EVP_sha512(), NULL, pkey_))
+        {
+            throw std::runtime_error("EVP_DigestVerifyInit");
+        }
     }
-
-    ~VerificationHelper()
+    catch (...)
     {
-        EVP_PKEY_free(pkey);
-        BIO_free_all(bio);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_MD_CTX_cleanup(&ctx);
-#else
-        EVP_MD_CTX_free(ctx);
-#endif
+        if (base_ctx_)
+            free_md_ctx(base_ctx_);
+        EVP_PKEY_free(pkey_);
+        throw;
     }
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_MD_CTX ctx;
-#else
-    EVP_MD_CTX *ctx;
-#endif
-    BIO *bio;
-    EVP_PKEY *pkey;
-};
 }
 
-bool SignatureHelper::verify_sha512(const std::string &data, const std::string &signature,
-                                    const std::string &pem_pubkey)
+SignatureVerifier::~SignatureVerifier()
 {
-    VerificationHelper helper(pem_pubkey);
+    free_md_ctx(base_ctx_);
+    EVP_PKEY_free(pkey_);
+}
 
-    if (1 !=
-        EVP_DigestVerifyInit(helper.get_ctx(), NULL, EVP_sha512(), NULL, helper.pkey))
+bool SignatureVerifier::verify_sha512(const std::string &data,
+                                      const std::string &signature)
+{
+    std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX *)> ctx(new_md_ctx(), free_md_ctx);
+    return verify(ctx.get(), data, signature);
+}
+
+std::vector<bool> SignatureVerifier::verify_sha512(
+    const std::vector<std::pair<std::string, std::string>> &signed_data)
+{
+    std::vector<bool> ret;
+    ret.reserve(signed_data.size());
+
+    std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX *)> ctx(new_md_ctx(), free_md_ctx);
+    for (const auto &sd : signed_data)
+        ret.push_back(verify(ctx.get(), sd.first, sd.second));
+    return ret;
+}
+
+bool SignatureVerifier::verify(EVP_MD_CTX *work_ctx, const std::string &data,
+                               const std::string &signature) const
+{
+    // Copying the initialized context is cheaper than a new EVP_DigestVerifyInit().
+    if (1 != EVP_MD_CTX_copy_ex(work_ctx, base_ctx_))
     {
-        throw std::runtime_error("EVP_DigestVerifyInit");
+        throw std::runtime_error("EVP_MD_CTX_copy_ex");
     }
 
-    if (1 != EVP_DigestVerifyUpdate(helper.get_ctx(), data.c_str(), data.size()))
+    if (1 != EVP_DigestVerifyUpdate(work_ctx, data.c_str(), data.size()))
     {
         throw std::runtime_error("EVP_DigestVerifyUpdate");
     }
 
-    return 1 == EVP_DigestVerifyFinal(helper.get_ctx(),
+    return 1 == EVP_DigestVerifyFinal(work_ctx,
                                       reinterpret_cast<unsigned char *>(
                                           const_cast<char *>(signature.c_str())),
                                       signature.size());
@@ -6,7 +6,13 @@
 #define LIBLOGICALACCESS_SIGNATURE_HELPER_HPP
 
 #include "logicalaccess/plugins/crypto/lla_crypto_api.hpp"
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+
+typedef struct evp_pkey_st EVP_PKEY;
+typedef struct evp_md_ctx_st EVP_MD_CTX;
 
 namespace logicalaccess
 {
@@ -32,6 +38,58 @@ class LLA_CRYPTO_API SignatureHelper
     static bool verify_sha512(const std::string &data, const std::string &signature,
                               const std::string &pem_pubkey);
 };
+
+/**
+ * RSA / SHA512 signature verification against one public key.
+ *
+ * The PEM public key is parsed once, and the digest context is initialized
+ * once then copied for each verification. Use it instead of
+ * SignatureHelper::verify_sha512() when checking many signatures from the same
+ * signer.
+ *
+ * This object is thread safe.
+ */
+class LLA_CRYPTO_API SignatureVerifier
+{
+  public:
+    /**
+     * @param pem_pubkey A text PEM encoded public key.
+     * @throw std::runtime_error if the key cannot be loaded.
+     */
+    explicit SignatureVerifier(const std::string &pem_pubkey);
+
+    ~SignatureVerifier();
+
+    SignatureVerifier(const SignatureVerifier &) = delete;
+    SignatureVerifier &operator=(const SignatureVerifier &) = delete;
+
+    /**
+     * Verify that the signature of `data` matches `signature`.
+     *
+     * @return true if signature is valid, false otherwise.
+     */
+    bool verify_sha512(const std::string &data, const std::string &signature);
+
+    /**
+     * Verify many (data, signature) pairs.
+     *
+     * @return One result per pair, in the same order.
+     */
+    std::vector<bool>
+    verify_sha512(const std::vector<std::pair<std::string, std::string>> &signed_data);
+
+  private:
+    /**
+     * Verify one signature, using `work_ctx` as a copy of base_ctx_.
+     */
+    bool verify(EVP_MD_CTX *work_ctx, const std::string &data,
+                const std::string &signature) const;
+
+    EVP_PKEY *pkey_;
+    // Initialized for verification with pkey_, never modified after construction.
+    // Each call copies it into its own context, so no lock is needed.
+    EVP_MD_CTX *base_ctx_;
+};
 }
 
 #endif // LIBLOGICALACCESS_SIGNATURE_HELPER_HPP
@@ -0,0 +1,142 @@
+#include "logicalaccess/plugins/iks/IKSAsyncClient.hpp"
+#include "logicalaccess/plugins/iks/RPCException.hpp"
+
+namespace logicalaccess
+{
+namespace iks
+{
+template <typename Reply>
+struct IKSAsyncClient::Call : public PendingCall
+{
+    explicit Call(IKSChannelPool &pool)
+        : pool(pool)
+    {
+    }
+
+    void complete(bool ok) override
+    {
+        if (!ok)
+        {
+            promise.set_exception(
+                std::make_exception_ptr(RPCException("IKS call was cancelled.")));
+            return;
+        }
+
+        pool.report(lease, status);
+        if (status.ok())
+        {
+            promise.set_value(std::move(reply));
+        }
+        else
+        {
+            promise.set_exception(std::make_exception_ptr(
+                RPCException(status.error_message() + ": " + status.error_details())));
+        }
+    }
+
+    IKSChannelPool &pool;
+    IKSChannelPool::Lease lease;
+    ::grpc::ClientContext context;
+    std::unique_ptr<::grpc::ClientAsyncResponseReader<Reply>> reader;
+    Reply reply;
+    ::grpc::Status status;
+    std::promise<Reply> promise;
+};
+
+IKSAsyncClient::IKSAsyncClient(IKSChannelPool &pool, size_t nb_threads)
+    : pool_(pool)
+{
+    if (nb_threads == 0)
+        nb_threads = 1;
+
+    for (size_t i = 0; i < nb_threads; ++i)
+        threads_.emplace_back(&IKSAsyncClient::run, this);
+}
+
+IKSAsyncClient::~IKSAsyncClient()
+{
+    cq_.Shutdown();
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+void IKSAsyncClient::run()
+{
+    void *tag;
+    bool ok;
+    while (cq_.Next(&tag, &ok))
+    {
+        std::unique_ptr<PendingCall> call(static_cast<PendingCall *>(tag));
+        call->complete(ok);
+    }
+}
+
+template <typename Request, typename Reply>
+std::future<Reply> IKSAsyncClient::start(PrepareAsync<Request, Reply> prepare,
+                                         const Request &req)
+{
+    auto call                 = new Call<Reply>(pool_);
+    std::future<Reply> future = call->promise.get_future();
+
+    call->lease  = pool_.acquire();
+    call->reader = ((*call->lease.stub).*prepare)(&call->context, req, &cq_);
+    call->reader->StartCall();
+    // The completion thread takes ownership of the call.
+    call->reader->Finish(&call->reply, &call->status, static_cast<PendingCall *>(call));
+    return future;
+}
+
+std::future<SMSG_GenRandom> IKSAsyncClient::gen_random(const CMSG_GenRandom &req)
+{
+    return start<CMSG_GenRandom, SMSG_GenRandom>(
+        &IKSService::Stub::PrepareAsyncGenRandom, req);
+}
+
+std::future<SMSG_AESResult> IKSAsyncClient::aes_encrypt(const CMSG_AESOperation &req)
+{
+    return start<CMSG_AESOperation, SMSG_AESResult>(
+        &IKSService::Stub::PrepareAsyncAESEncrypt, req);
+}
+
+std::future<SMSG_AESResult> IKSAsyncClient::aes_decrypt(const CMSG_AESOperation &req)
+{
+    return start<CMSG_AESOperation, SMSG_AESResult>(
+        &IKSService::Stub::PrepareAsyncAESDecrypt, req);
+}
+
+std::future<SMSG_DesfireISOAuth_Step1>
+IKSAsyncClient::desfire_auth_iso_step1(const CMSG_DesfireISOAuth_Step1 &req)
+{
+    return start<CMSG_DesfireISOAuth_Step1, SMSG_DesfireISOAuth_Step1>(
+        &IKSService::Stub::PrepareAsyncDESFireISOAuth1, req);
+}
+
+std::future<SMSG_DesfireAuth_Step2>
+IKSAsyncClient::desfire_auth_iso_step2(const CMSG_DesfireAuth_Step2 &req)
+{
+    return start<CMSG_DesfireAuth_Step2, SMSG_DesfireAuth_Step2>(
+        &IKSService::Stub::PrepareAsyncDESFireISOAuth2, req);
+}
+
+std::future<SMSG_DesfireAESAuth_Step1>
+IKSAsyncClient::desfire_auth_aes_step1(const CMSG_DesfireAESAuth_Step1 &req)
+{
+    return start<CMSG_DesfireAESAuth_Step1, SMSG_DesfireAESAuth_Step1>(
+        &IKSService::Stub::PrepareAsyncDESFireAESAuth1, req);
+}
+
+std::future<SMSG_DesfireAuth_Step2>
+IKSAsyncClient::desfire_auth_aes_step2(const CMSG_DesfireAuth_Step2 &req)
+{
+    return start<CMSG_DesfireAuth_Step2, SMSG_DesfireAuth_Step2>(
+        &IKSService::Stub::PrepareAsyncDESFireAESAuth2, req);
+}
+
+std::future<SMSG_DesfireChangeKey>
+IKSAsyncClient::desfire_change_key(const CMSG_DesfireChangeKey &req)
+{
+    return start<CMSG_DesfireChangeKey, SMSG_DesfireChangeKey>(
+        &IKSService::Stub::PrepareAsyncDESFireChangeKey, req);
+}
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <grpc++/completion_queue.h>
+#include "logicalaccess/plugins/iks/IKSChannelPool.hpp"
+#include "logicalaccess/plugins/iks/iks.grpc.pb.h"
+
+namespace logicalaccess
+{
+namespace iks
+{
+/**
+ * Asynchronous RPC client to IKS.
+ *
+ * Each call is started immediately and returns a future. Completions are
+ * handled by a few threads draining a single completion queue, so many
+ * operations can be in flight without one blocked thread per operation.
+ * A failed call sets an RPCException on its future.
+ *
+ * This object is thread safe.
+ */
+class IKSAsyncClient
+{
+  public:
+    /**
+     * \param pool The channels to use. Must outlive this object.
+     * \param nb_threads The number of threads handling completions.
+     */
+    explicit IKSAsyncClient(IKSChannelPool &pool, size_t nb_threads = 1);
+
+    /**
+     * Wait for the calls in flight and stop the completion threads.
+     */
+    ~IKSAsyncClient();
+
+    IKSAsyncClient(const IKSAsyncClient &) = delete;
+    IKSAsyncClient &operator=(const IKSAsyncClient &) = delete;
+
+    std::future<SMSG_GenRandom> gen_random(const CMSG_GenRandom &req);
+
+    std::future<SMSG_AESResult> aes_encrypt(const CMSG_AESOperation &req);
+    std::future<SMSG_AESResult> aes_decrypt(const CMSG_AESOperation &req);
+
+    std::future<SMSG_DesfireISOAuth_Step1>
+    desfire_auth_iso_step1(const CMSG_DesfireISOAuth_Step1 &req);
+    std::future<SMSG_DesfireAuth_Step2>
+    desfire_auth_iso_step2(const CMSG_DesfireAuth_Step2 &req);
+
+    std::future<SMSG_DesfireAESAuth_Step1>
+    desfire_auth_aes_step1(const CMSG_DesfireAESAuth_Step1 &req);
+    std::future<SMSG_DesfireAuth_Step2>
+    desfire_auth_aes_step2(const CMSG_DesfireAuth_Step2 &req);
+
+    std::future<SMSG_DesfireChangeKey>
+    desfire_change_key(const CMSG_DesfireChangeKey &req);
+
+  private:
+    /**
+     * A call in flight, used as completion queue tag.
+     */
+    struct PendingCall
+    {
+        virtual ~PendingCall() = default;
+
+        /**
+         * Resolve the future once the RPC is done.
+         */
+        virtual void complete(bool ok) = 0;
+    };
+
+    template <typename Reply>
+    struct Call;
+
+    template <typename Request, typename Reply>
+    using PrepareAsync = std::unique_ptr<::grpc::ClientAsyncResponseReader<Reply>> (
+        IKSService::Stub::*)(::grpc::ClientContext *, const Request &,
+                             ::grpc::CompletionQueue *);
+
+    template <typename Request, typename Reply>
+    std::future<Reply> start(PrepareAsync<Request, Reply> prepare, const Request &req);
+
+    void run();
+
+    IKSChannelPool &pool_;
+    ::grpc::CompletionQueue cq_;
+    std::vector<std::thread> threads_;
+};
+}
+}
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <grpc++/create_channel.h>
+#include <grpc++/support/channel_arguments.h>
+#include <grpc++/security/credentials.h>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include "logicalaccess/plugins/iks/IKSChannelPool.hpp"
+
+namespace logicalaccess
+{
+namespace iks
+{
+IKSChannelPool::IKSChannelPool(IslogKeyServer::IKSConfig config, size_t size,
+                               std::shared_ptr<::grpc::ChannelCredentials> credentials)
+    : config_(config)
+    , credentials_(credentials)
+    , next_(0)
+    , generation_(0)
+{
+    if (size == 0)
+        size = 1;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        Lease lease;
+        lease.index   = i;
+        lease.channel = create_channel(i);
+        lease.stub =
+            std::shared_ptr<IKSService::Stub>(IKSService::NewStub(lease.channel));
+        leases_.push_back(lease);
+    }
+
+    // Only wait for the first channel, the others connect in background.
+    auto deadline = std::chrono::system_clock::now() + std::chrono::milliseconds(10000);
+    leases_[0].channel->WaitForConnected(deadline);
+}
+
+std::shared_ptr<::grpc::ChannelInterface>
+IKSChannelPool::create_channel(size_t index)
+{
+    auto credentials = credentials_;
+    if (!credentials)
+    {
+        // Configure gRPC ssl from IKSConfig.
+        grpc::SslCredentialsOptions ssl_opts;
+        ssl_opts.pem_cert_chain  = config_.get_client_cert_pem();
+        ssl_opts.pem_private_key = config_.get_client_key_pem();
+        ssl_opts.pem_root_certs  = config_.get_root_ca_pem();
+        credentials              = grpc::SslCredentials(ssl_opts);
+    }
+
+    // gRPC shares a subchannel between channels with identical arguments: the
+    // index keeps the pooled channels on distinct connections, and the generation
+    // keeps a replaced channel from picking up the failed subchannel again.
+    grpc::ChannelArguments args;
+    args.SetInt("lla.iks_channel_index", static_cast<int>(index));
+    args.SetInt("lla.iks_channel_generation", ++generation_);
+#ifdef GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+#endif
+    auto channel = grpc::CreateCustomChannel(config_.get_target(), credentials, args);
+
+    // Start connecting now rather than on the first RPC.
+    channel->GetState(true);
+    return channel;
+}
+
+IKSChannelPool::Lease IKSChannelPool::acquire()
+{
+    std::lock_guard<std::mutex> lg(mutex_);
+    Lease lease = leases_[next_];
+    next_       = (next_ + 1) % leases_.size();
+    return lease;
+}
+
+void IKSChannelPool::report(const Lease &lease, const ::grpc::Status &status)
+{
+    if (status.error_code() != grpc::StatusCode::UNAVAILABLE)
+        return;
+
+    grpc_connectivity_state state = lease.channel->GetState(false);
+    if (state != GRPC_CHANNEL_TRANSIENT_FAILURE && state != GRPC_CHANNEL_SHUTDOWN)
+        return;
+
+    std::lock_guard<std::mutex> lg(mutex_);
+    // Another caller may already have replaced it.
+    if (leases_[lease.index].channel != lease.channel)
+        return;
+
+    LOG(LogLevel::WARNINGS) << "IKS channel " << lease.index
+                            << " is unavailable, reconnecting to "
+                            << config_.get_target();
+    leases_[lease.index].channel = create_channel(lease.index);
+    leases_[lease.index].stub    = std::shared_ptr<IKSService::Stub>(
+        IKSService::NewStub(leases_[lease.index].channel));
+}
+}
+}
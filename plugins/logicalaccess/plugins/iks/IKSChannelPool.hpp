@@ -0,0 +1,80 @@
+#pragma once
+
+#include "logicalaccess/iks/IslogKeyServer.hpp"
+#include <grpc++/channel.h>
+#include <grpc++/security/credentials.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "logicalaccess/plugins/iks/iks.grpc.pb.h"
+
+namespace logicalaccess
+{
+namespace iks
+{
+/**
+ * A fixed set of long-lived gRPC channels to one IKS instance.
+ *
+ * Channels are created once, with their TLS credentials, and shared by
+ * all the callers. Each channel has its own channel arguments, so gRPC gives it
+ * its own connection instead of sharing one subchannel between them. A channel
+ * that the server can no longer be reached through is replaced on the next
+ * failure.
+ *
+ * This object is thread safe.
+ */
+class IKSChannelPool
+{
+  public:
+    /**
+     * A channel and its stub, as handed out to one RPC.
+     */
+    struct Lease
+    {
+        size_t index;
+        std::shared_ptr<::grpc::ChannelInterface> channel;
+        std::shared_ptr<IKSService::Stub> stub;
+    };
+
+    /**
+     * \param config The IKS to connect to.
+     * \param size The number of channels.
+     * \param credentials The channel credentials, or null to use TLS with the
+     * certificates of the configuration.
+     */
+    IKSChannelPool(IslogKeyServer::IKSConfig config, size_t size,
+                   std::shared_ptr<::grpc::ChannelCredentials> credentials = nullptr);
+
+    /**
+     * Pick the next channel, round-robin.
+     */
+    Lease acquire();
+
+    /**
+     * Report the status of an RPC made through a lease.
+     *
+     * An UNAVAILABLE status on a channel in failure state recreates it.
+     */
+    void report(const Lease &lease, const ::grpc::Status &status);
+
+  private:
+    /**
+     * Create the channel of a pool slot, with its own subchannel.
+     * Called with mutex_ held, or from the constructor.
+     */
+    std::shared_ptr<::grpc::ChannelInterface> create_channel(size_t index);
+
+    IslogKeyServer::IKSConfig config_;
+    std::shared_ptr<::grpc::ChannelCredentials> credentials_;
+
+    std::mutex mutex_;
+    std::vector<Lease> leases_;
+    size_t next_;
+
+    /**
+     * Count of channels created, so a replacement never reuses a subchannel.
+     */
+    int generation_;
+};
+}
+}
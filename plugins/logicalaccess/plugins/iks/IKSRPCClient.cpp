@@ -1,4 +1,7 @@
-#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <logicalaccess/iks/IslogKeyServer.hpp>
 #include <logicalaccess/plugins/crypto/signature_helper.hpp>
 #include "logicalaccess/plugins/iks/IKSRPCClient.hpp"
@@ -10,23 +13,10 @@ namespace logicalaccess
 {
 namespace iks
 {
-IKSRPCClient::IKSRPCClient(IslogKeyServer::IKSConfig config)
-    : config_(config)
+IKSRPCClient::IKSRPCClient(IslogKeyServer::IKSConfig config, size_t pool_size,
+                           std::shared_ptr<::grpc::ChannelCredentials> credentials)
+    : pool_(config, pool_size, credentials)
 {
-    // Configure gRPC ssl from IKSConfig.
-    grpc::SslCredentialsOptions ssl_opts;
-    ssl_opts.pem_cert_chain  = config.get_client_cert_pem();
-    ssl_opts.pem_private_key = config.get_client_key_pem();
-    ssl_opts.pem_root_certs  = config.get_root_ca_pem();
-
-    channel = grpc::CreateChannel(config.get_target(), grpc::SslCredentials(ssl_opts));
-    // test only, no ssl.
-    // channel = grpc::CreateChannel(config.get_target(),
-    // grpc::InsecureChannelCredentials());
-
-    auto deadline = std::chrono::system_clock::now() + std::chrono::milliseconds(10000);
-    channel->WaitForConnected(deadline);
-    stub_ = std::unique_ptr<IKSService::Stub>(IKSService::NewStub(channel));
 }
 
 ByteVector IKSRPCClient::gen_random(int size)
@@ -36,7 +26,9 @@ ByteVector IKSRPCClient::gen_random(int size)
     req.set_size(size);
 
     SMSG_GenRandom rep;
-    grpc::Status rpc_status = stub_->GenRandom(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->GenRandom(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return ByteVector(rep.randombytes().begin(), rep.randombytes().end());
@@ -44,17 +36,43 @@ ByteVector IKSRPCClient::gen_random(int size)
     throw RPCException(rpc_status.error_message() + ": " + rpc_status.error_details());
 }
 
-ByteVector IKSRPCClient::aes_encrypt(const ByteVector &in, const std::string &key_name,
-                                     const ByteVector &iv)
+static CMSG_AESOperation make_aes_request(const ByteVector &in,
+                                          const std::string &key_name,
+                                          const ByteVector &iv, bool request_signature)
 {
-    grpc::ClientContext context;
     CMSG_AESOperation req;
     req.set_key_uuid(key_name);
     req.set_payload(std::string(in.begin(), in.end()));
     req.set_iv(std::string(iv.begin(), iv.end()));
+    req.set_request_signature(request_signature);
+    return req;
+}
+
+static void copy_signature(const SMSG_AESResult &rep, SignatureResult &out_signature)
+{
+    // copy signature and its description.
+    auto sig_str                 = rep.signature();
+    out_signature.signature      = ByteVector(sig_str.begin(), sig_str.end());
+    out_signature.desc.timestamp = rep.signaturedescription().timestamp();
+    out_signature.desc.nonce     = rep.signaturedescription().nonce();
+    out_signature.desc.run_uuid =
+        ByteVector(rep.signaturedescription().run_uuid().begin(),
+                   rep.signaturedescription().run_uuid().end());
+    out_signature.desc.payload =
+        ByteVector(rep.signaturedescription().payload().begin(),
+                   rep.signaturedescription().payload().end());
+}
+
+ByteVector IKSRPCClient::aes_encrypt(const ByteVector &in, const std::string &key_name,
+                                     const ByteVector &iv)
+{
+    grpc::ClientContext context;
+    CMSG_AESOperation req = make_aes_request(in, key_name, iv, false);
 
     SMSG_AESResult rep;
-    grpc::Status rpc_status = stub_->AESEncrypt(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->AESEncrypt(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return ByteVector(rep.payload().begin(), rep.payload().end());
@@ -66,42 +84,107 @@ ByteVector IKSRPCClient::aes_decrypt(const ByteVector &in, const std::string &ke
                                      const ByteVector &iv, SignatureResult *out_signature)
 {
     grpc::ClientContext context;
-    CMSG_AESOperation req;
-    req.set_key_uuid(key_name);
-    req.set_payload(std::string(in.begin(), in.end()));
-    req.set_iv(std::string(iv.begin(), iv.end()));
-    req.set_request_signature(!!out_signature);
+    CMSG_AESOperation req = make_aes_request(in, key_name, iv, !!out_signature);
 
     SMSG_AESResult rep;
-    grpc::Status rpc_status = stub_->AESDecrypt(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->AESDecrypt(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         if (out_signature)
         {
-            // copy signature and its description.
-            auto sig_str                  = rep.signature();
-            out_signature->signature      = ByteVector(sig_str.begin(), sig_str.end());
-            out_signature->desc.timestamp = rep.signaturedescription().timestamp();
-            out_signature->desc.nonce     = rep.signaturedescription().nonce();
-            out_signature->desc.run_uuid =
-                ByteVector(rep.signaturedescription().run_uuid().begin(),
-                           rep.signaturedescription().run_uuid().end());
-            out_signature->desc.payload =
-                ByteVector(rep.signaturedescription().payload().begin(),
-                           rep.signaturedescription().payload().end());
+            copy_signature(rep, *out_signature);
         }
         return ByteVector(rep.payload().begin(), rep.payload().end());
     }
     throw RPCException(rpc_status.error_message() + ": " + rpc_status.error_details());
 }
 
+std::future<ByteVector> IKSRPCClient::aes_encrypt_async(const ByteVector &in,
+                                                        const std::string &key_name,
+                                                        const ByteVector &iv)
+{
+    // The call is in flight already, only the conversion waits for get().
+    return std::async(std::launch::deferred,
+                      [rep = async().aes_encrypt(make_aes_request(in, key_name, iv,
+                                                                  false))]() mutable {
+                          SMSG_AESResult result = rep.get();
+                          return ByteVector(result.payload().begin(),
+                                            result.payload().end());
+                      });
+}
+
+std::future<ByteVector> IKSRPCClient::aes_decrypt_async(const ByteVector &in,
+                                                        const std::string &key_name,
+                                                        const ByteVector &iv,
+                                                        SignatureResult *out_signature)
+{
+    return std::async(
+        std::launch::deferred,
+        [rep = async().aes_decrypt(make_aes_request(in, key_name, iv, !!out_signature)),
+         out_signature]() mutable {
+            SMSG_AESResult result = rep.get();
+            if (out_signature)
+                copy_signature(result, *out_signature);
+            return ByteVector(result.payload().begin(), result.payload().end());
+        });
+}
+
+std::vector<ByteVector>
+IKSRPCClient::aes_encrypt_batch(const std::vector<AESOperation> &ops)
+{
+    return aes_batch(ops, false, nullptr);
+}
+
+std::vector<ByteVector>
+IKSRPCClient::aes_decrypt_batch(const std::vector<AESOperation> &ops,
+                                std::vector<SignatureResult> *out_signatures)
+{
+    return aes_batch(ops, true, out_signatures);
+}
+
+std::vector<ByteVector>
+IKSRPCClient::aes_batch(const std::vector<AESOperation> &ops, bool decrypt,
+                        std::vector<SignatureResult> *out_signatures)
+{
+    IKSAsyncClient &client = async();
+    std::vector<ByteVector> ret(ops.size());
+    if (out_signatures)
+        out_signatures->resize(ops.size());
+
+    std::deque<std::future<SMSG_AESResult>> in_flight;
+    size_t next = 0, done = 0;
+    while (done < ops.size())
+    {
+        while (next < ops.size() && in_flight.size() < MAX_IN_FLIGHT)
+        {
+            const AESOperation &op = ops[next++];
+            CMSG_AESOperation req =
+                make_aes_request(op.payload, op.key_name, op.iv, !!out_signatures);
+            in_flight.push_back(decrypt ? client.aes_decrypt(req)
+                                        : client.aes_encrypt(req));
+        }
+
+        SMSG_AESResult rep = in_flight.front().get();
+        in_flight.pop_front();
+        ret[done] = ByteVector(rep.payload().begin(), rep.payload().end());
+        if (out_signatures)
+            copy_signature(rep, (*out_signatures)[done]);
+        ++done;
+    }
+    return ret;
+}
+
 SMSG_DesfireISOAuth_Step1
 IKSRPCClient::desfire_auth_iso_step1(CMSG_DesfireISOAuth_Step1 req)
 {
     grpc::ClientContext context;
 
     SMSG_DesfireISOAuth_Step1 rep;
-    grpc::Status rpc_status = stub_->DESFireISOAuth1(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->DESFireISOAuth1(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return rep;
@@ -114,7 +197,9 @@ SMSG_DesfireAuth_Step2 IKSRPCClient::desfire_auth_iso_step2(CMSG_DesfireAuth_Ste
     grpc::ClientContext context;
 
     SMSG_DesfireAuth_Step2 rep;
-    grpc::Status rpc_status = stub_->DESFireISOAuth2(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->DESFireISOAuth2(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return rep;
@@ -128,7 +213,9 @@ IKSRPCClient::desfire_auth_aes_step1(CMSG_DesfireAESAuth_Step1 req)
     grpc::ClientContext context;
 
     SMSG_DesfireAESAuth_Step1 rep;
-    grpc::Status rpc_status = stub_->DESFireAESAuth1(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->DESFireAESAuth1(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return rep;
@@ -141,7 +228,9 @@ SMSG_DesfireAuth_Step2 IKSRPCClient::desfire_auth_aes_step2(CMSG_DesfireAuth_Ste
     grpc::ClientContext context;
 
     SMSG_DesfireAuth_Step2 rep;
-    grpc::Status rpc_status = stub_->DESFireAESAuth2(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->DESFireAESAuth2(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return rep;
@@ -154,7 +243,9 @@ SMSG_DesfireChangeKey IKSRPCClient::desfire_change_key(CMSG_DesfireChangeKey req
     grpc::ClientContext context;
 
     SMSG_DesfireChangeKey rep;
-    grpc::Status rpc_status = stub_->DESFireChangeKey(&context, req, &rep);
+    auto lease              = pool_.acquire();
+    grpc::Status rpc_status = lease.stub->DESFireChangeKey(&context, req, &rep);
+    pool_.report(lease, rpc_status);
     if (rpc_status.ok())
     {
         return rep;
@@ -162,23 +253,98 @@ SMSG_DesfireChangeKey IKSRPCClient::desfire_change_key(CMSG_DesfireChangeKey req
     throw RPCException(rpc_status.error_message() + ": " + rpc_status.error_details());
 }
 
-RemoteCryptoIKSProvider::RemoteCryptoIKSProvider(IslogKeyServer::IKSConfig config)
-    : iks_rpc_client_(config)
+IKSAsyncClient &IKSRPCClient::async()
 {
+    std::call_once(async_once_, [this]() { async_.reset(new IKSAsyncClient(pool_)); });
+    return *async_;
 }
 
-bool RemoteCryptoIKSProvider::verify_signature(const SignatureResult &sr,
-                                               const std::string &pubkey_pem)
+const size_t RemoteCryptoIKSProvider::CHANNEL_POOL_SIZE;
+
+RemoteCryptoIKSProvider::RemoteCryptoIKSProvider(
+    IslogKeyServer::IKSConfig config, size_t pool_size,
+    std::shared_ptr<::grpc::ChannelCredentials> credentials)
+    : iks_rpc_client_(config, pool_size, credentials)
+{
+}
+
+std::shared_ptr<RemoteCryptoIKSProvider>
+RemoteCryptoIKSProvider::get_shared(const IslogKeyServer::IKSConfig &config)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<RemoteCryptoIKSProvider>> providers;
+
+    std::stringstream key;
+    key << config.get_target() << '\n'
+        << config.client_cert << '\n'
+        << config.client_key << '\n'
+        << config.root_ca;
+
+    {
+        std::lock_guard<std::mutex> lg(mutex);
+        auto it = providers.find(key.str());
+        if (it != providers.end())
+            return it->second;
+    }
+
+    // Connecting may take a while: do not block the other configurations meanwhile.
+    auto provider = std::make_shared<RemoteCryptoIKSProvider>(config, CHANNEL_POOL_SIZE);
+
+    std::lock_guard<std::mutex> lg(mutex);
+    // Keep the provider of a concurrent first call if it won the race.
+    return providers.emplace(key.str(), provider).first->second;
+}
+
+std::string RemoteCryptoIKSProvider::signed_data(const SignatureResult &sr)
 {
     SignatureDescription sigdesc;
     sigdesc.set_run_uuid(BufferHelper::getStdString(sr.desc.run_uuid));
     sigdesc.set_timestamp(sr.desc.timestamp);
     sigdesc.set_nonce(sr.desc.nonce);
     sigdesc.set_payload(BufferHelper::getStdString(sr.desc.payload));
+    return sigdesc.SerializeAsString();
+}
 
-    return SignatureHelper::verify_sha512(
-        sigdesc.SerializeAsString(),
-        std::string(sr.signature.begin(), sr.signature.end()), pubkey_pem);
+std::shared_ptr<SignatureVerifier>
+RemoteCryptoIKSProvider::get_verifier(const std::string &pubkey_pem)
+{
+    std::lock_guard<std::mutex> lg(verifiers_mutex_);
+    auto &verifier = verifiers_[pubkey_pem];
+    if (!verifier)
+    {
+        try
+        {
+            verifier = std::make_shared<SignatureVerifier>(pubkey_pem);
+        }
+        catch (...)
+        {
+            // Do not keep an empty slot for a key that failed to load.
+            verifiers_.erase(pubkey_pem);
+            throw;
+        }
+    }
+    return verifier;
+}
+
+bool RemoteCryptoIKSProvider::verify_signature(const SignatureResult &sr,
+                                               const std::string &pubkey_pem)
+{
+    return get_verifier(pubkey_pem)->verify_sha512(
+        signed_data(sr), std::string(sr.signature.begin(), sr.signature.end()));
+}
+
+std::vector<bool>
+RemoteCryptoIKSProvider::verify_signatures(const std::vector<SignatureResult> &srs,
+                                           const std::string &pubkey_pem)
+{
+    std::vector<std::pair<std::string, std::string>> to_verify;
+    to_verify.reserve(srs.size());
+    for (const auto &sr : srs)
+    {
+        to_verify.emplace_back(signed_data(sr),
+                               std::string(sr.signature.begin(), sr.signature.end()));
+    }
+    return get_verifier(pubkey_pem)->verify_sha512(to_verify);
 }
 
 ByteVector RemoteCryptoIKSProvider::aes_encrypt(const ByteVector &in,
@@ -196,6 +362,36 @@ ByteVector RemoteCryptoIKSProvider::aes_decrypt(const ByteVector &in,
     return iks_rpc_client_.aes_decrypt(in, key_name, iv, out_signature);
 }
 
+std::future<ByteVector>
+RemoteCryptoIKSProvider::aes_encrypt_async(const ByteVector &in,
+                                           const std::string &key_name,
+                                           const ByteVector &iv)
+{
+    return iks_rpc_client_.aes_encrypt_async(in, key_name, iv);
+}
+
+std::future<ByteVector>
+RemoteCryptoIKSProvider::aes_decrypt_async(const ByteVector &in,
+                                           const std::string &key_name,
+                                           const ByteVector &iv,
+                                           SignatureResult *out_signature)
+{
+    return iks_rpc_client_.aes_decrypt_async(in, key_name, iv, out_signature);
+}
+
+std::vector<ByteVector>
+RemoteCryptoIKSProvider::aes_encrypt_batch(const std::vector<AESOperation> &ops)
+{
+    return iks_rpc_client_.aes_encrypt_batch(ops);
+}
+
+std::vector<ByteVector>
+RemoteCryptoIKSProvider::aes_decrypt_batch(const std::vector<AESOperation> &ops,
+                                           std::vector<SignatureResult> *out_signatures)
+{
+    return iks_rpc_client_.aes_decrypt_batch(ops, out_signatures);
+}
+
 void RemoteCryptoIKSProvider::iso_authenticate_step1(
     const std::string &key_identity, const ByteVector &random_picc,
     const MyDivInfo &div_info, bool &out_success, ByteVector &out_random2,
@@ -9,19 +9,35 @@
 #include <logicalaccess/iks/RemoteCrypto.hpp>
 #include "logicalaccess/lla_fwd.hpp"
 #include "logicalaccess/plugins/iks/iks.grpc.pb.h"
+#include "logicalaccess/plugins/iks/IKSAsyncClient.hpp"
+#include "logicalaccess/plugins/iks/IKSChannelPool.hpp"
+#include <map>
+#include <mutex>
 
 namespace logicalaccess
 {
+class SignatureVerifier;
+
 namespace iks
 {
 
 /**
  * Wraps a RPC client to IKS.
+ *
+ * Calls are spread over a pool of channels and may be made from any thread.
  */
 class IKSRPCClient
 {
   public:
-    explicit IKSRPCClient(IslogKeyServer::IKSConfig config);
+    /**
+     * \param config The IKS to connect to.
+     * \param pool_size The number of channels.
+     * \param credentials The channel credentials, or null to use TLS with the
+     * certificates of the configuration.
+     */
+    explicit IKSRPCClient(
+        IslogKeyServer::IKSConfig config, size_t pool_size = 1,
+        std::shared_ptr<::grpc::ChannelCredentials> credentials = nullptr);
 
     ByteVector gen_random(int size);
 
@@ -32,6 +48,38 @@ class IKSRPCClient
                            const ByteVector &iv,
                            ::logicalaccess::SignatureResult *out_signature = nullptr);
 
+    /**
+     * Start an encryption on the asynchronous client.
+     */
+    std::future<ByteVector> aes_encrypt_async(const ByteVector &in,
+                                              const std::string &key_name,
+                                              const ByteVector &iv);
+
+    /**
+     * Start a decryption on the asynchronous client.
+     */
+    std::future<ByteVector>
+    aes_decrypt_async(const ByteVector &in, const std::string &key_name,
+                      const ByteVector &iv,
+                      ::logicalaccess::SignatureResult *out_signature = nullptr);
+
+    /**
+     * Encrypt many payloads, keeping up to MAX_IN_FLIGHT calls in flight.
+     */
+    std::vector<ByteVector> aes_encrypt_batch(const std::vector<AESOperation> &ops);
+
+    /**
+     * Decrypt many payloads, keeping up to MAX_IN_FLIGHT calls in flight.
+     */
+    std::vector<ByteVector>
+    aes_decrypt_batch(const std::vector<AESOperation> &ops,
+                      std::vector<::logicalaccess::SignatureResult> *out_signatures);
+
+    /**
+     * Maximum number of calls a batch keeps in flight.
+     */
+    static const size_t MAX_IN_FLIGHT = 64;
+
     SMSG_DesfireISOAuth_Step1 desfire_auth_iso_step1(CMSG_DesfireISOAuth_Step1 req);
     SMSG_DesfireAuth_Step2 desfire_auth_iso_step2(CMSG_DesfireAuth_Step2 req);
 
@@ -40,10 +88,25 @@ class IKSRPCClient
 
     SMSG_DesfireChangeKey desfire_change_key(CMSG_DesfireChangeKey req);
 
+    /**
+     * Asynchronous client sharing the channels of this client.
+     *
+     * It is created, with its completion thread, on first use.
+     */
+    IKSAsyncClient &async();
+
   private:
-    IslogKeyServer::IKSConfig config_;
-    std::shared_ptr<::grpc::ChannelInterface> channel;
-    std::unique_ptr<IKSService::Stub> stub_;
+    /**
+     * Run AES operations through the async client, a window at a time.
+     */
+    std::vector<ByteVector>
+    aes_batch(const std::vector<AESOperation> &ops, bool decrypt,
+              std::vector<::logicalaccess::SignatureResult> *out_signatures);
+
+    IKSChannelPool pool_;
+
+    std::once_flag async_once_;
+    std::unique_ptr<IKSAsyncClient> async_;
 };
 
 /**
@@ -52,17 +115,61 @@ class IKSRPCClient
 class RemoteCryptoIKSProvider : public RemoteCrypto
 {
   public:
-    explicit RemoteCryptoIKSProvider(IslogKeyServer::IKSConfig config);
+    /**
+     * Number of channels opened by the shared providers.
+     */
+    static const size_t CHANNEL_POOL_SIZE = 2;
+
+    /**
+     * \param config The IKS to connect to.
+     * \param pool_size The number of channels.
+     * \param credentials The channel credentials, or null to use TLS with the
+     * certificates of the configuration.
+     */
+    explicit RemoteCryptoIKSProvider(
+        IslogKeyServer::IKSConfig config, size_t pool_size = 1,
+        std::shared_ptr<::grpc::ChannelCredentials> credentials = nullptr);
 
+    /**
+     * Retrieve the provider shared by everyone using the same configuration.
+     *
+     * It is created on first use and kept for the lifetime of the process,
+     * so the channels and their TLS sessions are set up only once.
+     */
+    static std::shared_ptr<RemoteCryptoIKSProvider>
+    get_shared(const IslogKeyServer::IKSConfig &config);
+
+    /**
+     * The public key is parsed on first use and kept for the next calls.
+     */
     bool verify_signature(const SignatureResult &sr,
                           const std::string &pubkey_pem) override;
 
+    std::vector<bool> verify_signatures(const std::vector<SignatureResult> &srs,
+                                        const std::string &pubkey_pem) override;
+
     ByteVector aes_encrypt(const ByteVector &in, const std::string &key_name,
                            const ByteVector &iv) override;
 
     ByteVector aes_decrypt(const ByteVector &in, const std::string &key_name,
                            const ByteVector &iv, SignatureResult *out_signature) override;
 
+    std::future<ByteVector> aes_encrypt_async(const ByteVector &in,
+                                              const std::string &key_name,
+                                              const ByteVector &iv) override;
+
+    std::future<ByteVector> aes_decrypt_async(const ByteVector &in,
+                                              const std::string &key_name,
+                                              const ByteVector &iv,
+                                              SignatureResult *out_signature) override;
+
+    std::vector<ByteVector>
+    aes_encrypt_batch(const std::vector<AESOperation> &ops) override;
+
+    std::vector<ByteVector>
+    aes_decrypt_batch(const std::vector<AESOperation> &ops,
+                      std::vector<SignatureResult> *out_signatures) override;
+
     void iso_authenticate_step1(const std::string &key_identity,
                                 const ByteVector &random_picc, const MyDivInfo &div_info,
                                 bool &out_success, ByteVector &out_random2,
@@ -102,7 +209,20 @@ class RemoteCryptoIKSProvider : public RemoteCrypto
      */
     KeyDiversificationInfo convert_div_info(const MyDivInfo &);
 
+    /**
+     * Retrieve the verifier for a public key, parsing the key on first use.
+     */
+    std::shared_ptr<SignatureVerifier> get_verifier(const std::string &pubkey_pem);
+
+    /**
+     * Build the data IKS signed for a signature result.
+     */
+    static std::string signed_data(const SignatureResult &sr);
+
     IKSRPCClient iks_rpc_client_;
+
+    std::mutex verifiers_mutex_;
+    std::map<std::string, std::shared_ptr<SignatureVerifier>> verifiers_;
 };
 }
 }
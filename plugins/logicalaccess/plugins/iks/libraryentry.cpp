@@ -14,6 +14,6 @@ LLA_IKS_API void
 getRemoteCrypto(const logicalaccess::iks::IslogKeyServer::IKSConfig &cfg,
                 logicalaccess::RemoteCryptoPtr &remoteCrypto)
 {
-    remoteCrypto = std::make_shared<logicalaccess::iks::RemoteCryptoIKSProvider>(cfg);
+    remoteCrypto = logicalaccess::iks::RemoteCryptoIKSProvider::get_shared(cfg);
 }
 }
@@ -0,0 +1,70 @@
+/**
+ * \file loglinearhistogram.cpp
+ * \brief Bucketing of a log-linear latency histogram.
+ */
+
+#include <logicalaccess/plugins/llacommon/loglinearhistogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace logicalaccess
+{
+const unsigned int LogLinearHistogram::SUB_BUCKET_BITS;
+const unsigned int LogLinearHistogram::MAX_VALUE_BITS;
+const size_t LogLinearHistogram::BUCKET_COUNT;
+
+size_t LogLinearHistogram::getBucketIndex(uint64_t value)
+{
+    const uint64_t maxValue = (static_cast<uint64_t>(1) << MAX_VALUE_BITS) - 1;
+    if (value > maxValue)
+        value = maxValue;
+    if (value < (1u << SUB_BUCKET_BITS))
+        return static_cast<size_t>(value);
+
+    unsigned int msb = 0;
+    for (uint64_t v = value; v > 1; v >>= 1)
+        ++msb;
+    const unsigned int shift = msb - (SUB_BUCKET_BITS - 1);
+    return (static_cast<size_t>(shift) << (SUB_BUCKET_BITS - 1)) +
+           static_cast<size_t>(value >> shift);
+}
+
+uint64_t LogLinearHistogram::getBucketValue(size_t index)
+{
+    const size_t half = static_cast<size_t>(1) << (SUB_BUCKET_BITS - 1);
+    if (index < 2 * half)
+        return index;
+    const size_t shift = index / half - 1;
+    return static_cast<uint64_t>(index % half + half) << shift;
+}
+
+uint64_t LogLinearHistogram::getPercentile(const uint64_t *counts, double percentile,
+                                           uint64_t max)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        total += counts[i];
+    if (total == 0)
+        return 0;
+
+    percentile    = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            // Report the highest value of the bucket, never above the recorded max.
+            const uint64_t value =
+                i + 1 < BUCKET_COUNT ? getBucketValue(i + 1) - 1 : getBucketValue(i);
+            return std::min(value, max);
+        }
+    }
+    return max;
+}
+}
@@ -0,0 +1,67 @@
+/**
+ * \file loglinearhistogram.hpp
+ * \brief Bucketing of a log-linear latency histogram.
+ */
+
+#ifndef LOGICALACCESS_LOGLINEARHISTOGRAM_HPP
+#define LOGICALACCESS_LOGLINEARHISTOGRAM_HPP
+
+#include <logicalaccess/plugins/llacommon/lla_common_api.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace logicalaccess
+{
+/**
+ * \brief Bucketing of a log-linear histogram (HDR style).
+ *
+ * Values are bucketed on their 5 most significant bits, that is 16 buckets per
+ * power of two, so any recorded value is known within 6.25%. Values below 32
+ * are exact, values of 2^36 and above are recorded as 2^36 - 1.
+ * The owner keeps the BUCKET_COUNT counters, with whatever synchronization it
+ * needs.
+ */
+class LLA_COMMON_API LogLinearHistogram
+{
+  public:
+    /**
+     * \brief Significant bits kept per value.
+     */
+    static const unsigned int SUB_BUCKET_BITS = 5;
+
+    /**
+     * \brief Values of 2^36 and above are recorded as 2^36 - 1.
+     */
+    static const unsigned int MAX_VALUE_BITS = 36;
+
+    static const size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2)
+                                       << (SUB_BUCKET_BITS - 1);
+
+    /**
+     * \brief Get the bucket of a value.
+     * \param value The value.
+     * \return The bucket index.
+     */
+    static size_t getBucketIndex(uint64_t value);
+
+    /**
+     * \brief Get the lowest value falling in a bucket.
+     * \param index The bucket index.
+     * \return The value.
+     */
+    static uint64_t getBucketValue(size_t index);
+
+    /**
+     * \brief Get a percentile from the bucket counters.
+     * \param counts The BUCKET_COUNT bucket counters.
+     * \param percentile The percentile, between 0 and 100.
+     * \param max The highest recorded value, never exceeded by the result.
+     * \return The highest value of the percentile bucket, 0 if nothing was recorded.
+     */
+    static uint64_t getPercentile(const uint64_t *counts, double percentile,
+                                  uint64_t max);
+};
+}
+
+#endif /* LOGICALACCESS_LOGLINEARHISTOGRAM_HPP */
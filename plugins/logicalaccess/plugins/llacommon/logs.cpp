@@ -5,9 +5,12 @@
  */
 
 #include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/logsink.hpp>
+#include <logicalaccess/plugins/llacommon/spanprofiler.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 #include <logicalaccess/colorize.hpp>
 #include <boost/date_time.hpp>
+#include <mutex>
 
 #ifdef WIN32
 // For now the additional context for the logger wont be thread safe,
@@ -24,15 +27,30 @@ namespace logicalaccess
 {
 bool Logs::logToStderr = false;
 std::ofstream Logs::logfile;
+std::atomic<bool> Logs::logfileGood(true);
+std::shared_ptr<AsyncLogSink> Logs::asyncSink;
 std::map<LogLevel, std::string> Logs::logLevelMsg;
 
+bool Logs::isEnabled(enum LogLevel level)
+{
+    if (level == NONE || !logfileGood.load(std::memory_order_acquire))
+        return false;
+
+    // No snapshot yet while the settings are being initialized.
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    if (!settings || !settings->IsLogEnabled)
+        return false;
+    if (level == COMS)
+        return settings->SeeCommunicationLog;
+    if (level == PLUGINS || level == PLUGINS_ERROR)
+        return settings->SeePluginLog;
+    return true;
+}
+
 Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
     : d_level(level)
 {
-    if (!Settings::getInstance()->IsLogEnabled ||
-        (d_level == COMS && !Settings::getInstance()->SeeCommunicationLog) ||
-        ((d_level == PLUGINS || d_level == PLUGINS_ERROR) &&
-         !Settings::getInstance()->SeePluginLog))
+    if (!isEnabled(d_level))
         d_level = NONE;
 
     if (logLevelMsg.empty())
@@ -49,8 +67,9 @@ Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
         logLevelMsg[PLUGINS]    = "PLUGIN";
     }
 
-    if (logfile && d_level != NONE)
+    if (d_level != NONE)
     {
+        std::shared_ptr<const Settings> settings = Settings::getSnapshot();
         boost::posix_time::ptime now;
         try
         {
@@ -59,7 +78,7 @@ Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
         catch (std::exception)
         {
         }
-        if (Settings::getInstance()->ColorizeLog)
+        if (settings->ColorizeLog)
         {
             _stream << Colorize::underline(to_simple_string(now)) << " - "
                     << Colorize::red(logLevelMsg[d_level]) << ": \t{" << line << "}\t{"
@@ -70,19 +89,19 @@ Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
             _stream << to_simple_string(now) << " - " << logLevelMsg[d_level] << ": \t{"
                     << line << "}\t{" << func << "}\t{" << file << "}:" << std::endl;
         }
-        if (Settings::getInstance()->ContextLog)
-            _stream << pretty_context_infos();
+        if (settings->ContextLog)
+            _stream << pretty_context_infos(settings->ColorizeLog);
     }
 }
 
-std::string Logs::pretty_context_infos()
+std::string Logs::pretty_context_infos(bool colorize)
 {
     using namespace Colorize;
     if (context_.size() == 0)
         return "";
 
     std::string ret;
-    if (Settings::getInstance()->ColorizeLog)
+    if (colorize)
         ret = green(underline("Context:")) + ' ';
     else
         ret   = "Context: ";
@@ -94,7 +113,7 @@ std::string Logs::pretty_context_infos()
             ret += std::string(9, ' ');
         std::stringstream ss;
         ss << count << ") ";
-        if (Settings::getInstance()->ColorizeLog)
+        if (colorize)
             ret += yellow(ss.str()) + itr + '\n';
         else
             ret += ss.str() + itr + '\n';
@@ -105,11 +124,21 @@ std::string Logs::pretty_context_infos()
 
 Logs::~Logs()
 {
-    if (logfile && d_level != NONE)
+    if (d_level != NONE)
     {
         _stream << std::endl;
+        std::shared_ptr<AsyncLogSink> sink = std::atomic_load(&asyncSink);
+        if (sink)
+        {
+            sink->push(_stream.str());
+            return;
+        }
+
+        static std::mutex syncMutex;
+        std::lock_guard<std::mutex> lock(syncMutex);
         logfile << _stream.rdbuf();
         logfile.flush();
+        logfileGood = static_cast<bool>(logfile);
 
         if (logToStderr)
             std::cerr << _stream.str();
@@ -150,13 +179,15 @@ std::ostream &operator<<(std::ostream &ss, const std::vector<bool> &bytebuff)
 
 LogDisabler::LogDisabler()
 {
-    old_                                  = Settings::getInstance()->IsLogEnabled;
-    Settings::getInstance()->IsLogEnabled = false;
+    Settings::update([this](Settings &settings) {
+        old_                  = settings.IsLogEnabled;
+        settings.IsLogEnabled = false;
+    });
 }
 
 LogDisabler::~LogDisabler()
 {
-    Settings::getInstance()->IsLogEnabled = old_;
+    Settings::update([this](Settings &settings) { settings.IsLogEnabled = old_; });
 }
 
 std::string get_nth_param_name(const char *param_names, int idx)
@@ -189,12 +220,27 @@ void trace_print_helper(std::stringstream &ss, const char *param_names, int /*id
 }
 
 LogContext::LogContext(const std::string &msg)
+    : d_timed(SpanProfiler::isEnabled())
 {
     context_.push_back(msg);
+    if (d_timed)
+        d_start = std::chrono::steady_clock::now();
 }
 
 LogContext::~LogContext()
 {
+    if (d_timed)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - d_start;
+        std::string path;
+        for (const auto &itr : context_)
+        {
+            if (!path.empty())
+                path += ';';
+            path += itr;
+        }
+        SpanProfiler::record(path, elapsed);
+    }
     context_.pop_back();
 }
 }
@@ -30,7 +30,10 @@
 #include <sstream>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 
 namespace logicalaccess
 {
@@ -76,6 +79,9 @@ std::ostream &operator<<(std::ostream &ss, const std::array<uint8_t, Size> &byte
  * A class that push a string into the current logger's context at
  * construction, and pop it at deletion.
  *
+ * When the SpanProfiler is enabled, it also measures its lifetime and
+ * reports it as a span named after the whole context.
+ *
  * The direct use of this class is discouraged and the macro
  * LLA_LOG_CTX(...) should be used to push some context to the logger.
  */
@@ -84,13 +90,27 @@ class LLA_COMMON_API LogContext
   public:
     explicit LogContext(const std::string &);
     ~LogContext();
+
+  private:
+    bool d_timed;
+    std::chrono::steady_clock::time_point d_start;
 };
 
+class AsyncLogSink;
+
 class LLA_COMMON_API Logs
 {
   public:
     Logs(const char *file, const char *func, int line, enum LogLevel level);
 
+    /**
+     * Check if a log level would be written, given the current settings.
+     *
+     * LOG(x) calls it before building anything, so the arguments of a
+     * disabled log line are never evaluated.
+     */
+    static bool isEnabled(enum LogLevel level);
+
     ~Logs();
 
     template <class T>
@@ -102,23 +122,49 @@ class LLA_COMMON_API Logs
 
     static std::ofstream logfile;
 
+    /**
+    * Is logfile in a good state? Updated by whoever opens, closes or writes
+    * logfile. isEnabled() reads this flag rather than the stream state, which
+    * the background writer updates while it writes.
+    */
+    static std::atomic<bool> logfileGood;
+
     /**
     * Do we duplicate the log to stderr?
     * Defaults to false.
     */
     static bool logToStderr;
 
+    /**
+    * The background writer, when asynchronous logging is enabled.
+    * Records are written synchronously to logfile otherwise.
+    * Always read and replaced with std::atomic_load / std::atomic_store, a
+    * logging thread keeps the sink alive until its record is pushed.
+    */
+    static std::shared_ptr<AsyncLogSink> asyncSink;
+
   private:
     /**
      * Build a string containing some contextual information.
      */
-    static std::string pretty_context_infos();
+    static std::string pretty_context_infos(bool colorize);
 
     enum LogLevel d_level;
     std::stringstream _stream;
     static std::map<LogLevel, std::string> logLevelMsg;
 };
 
+/**
+ * Turn a log statement into a void expression, so LOG(x) can be the
+ * right-hand side of a conditional operator.
+ */
+struct LogVoidify
+{
+    void operator&(const Logs &)
+    {
+    }
+};
+
 /**
  * A RAII object that disable logging in its constructor, and restore
  * the old value in its destructor.
@@ -157,7 +203,15 @@ LLA_COMMON_API std::ostream &operator<<(std::ostream &ss,
 LLA_COMMON_API std::ostream &operator<<(std::ostream &ss,
                                         const std::vector<bool> &bytebuff);
 
-#define LOG(x) logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__, x)
+/**
+ * Log a line: LOG(level) << args. When the level is disabled, neither the
+ * logger nor the arguments are evaluated.
+ */
+#define LOG(x)                                                                           \
+    !logicalaccess::Logs::isEnabled(x)                                                   \
+        ? (void)0                                                                        \
+        : logicalaccess::LogVoidify() &                                                  \
+              logicalaccess::Logs(__FILE__, __FUNCTION__, __LINE__, x)
 
 LLA_COMMON_API void trace_print_helper(std::stringstream &ss, const char *param_names,
                                        int idx);
@@ -215,9 +269,15 @@ void trace_print(std::stringstream &ss, const char *param_names, T &&... params)
  * parameters types and will output something like [param_name -> param_value]
  */
 #define TRACE(...)                                                                       \
-    std::stringstream trace_stringstream;                                                \
-    trace_print(trace_stringstream, #__VA_ARGS__, ##__VA_ARGS__);                        \
-    LOG(TRACE) << trace_stringstream.str();
+    do                                                                                   \
+    {                                                                                    \
+        if (logicalaccess::Logs::isEnabled(logicalaccess::LogLevel::TRACE))              \
+        {                                                                                \
+            std::stringstream trace_stringstream;                                        \
+            trace_print(trace_stringstream, #__VA_ARGS__, ##__VA_ARGS__);                \
+            LOG(logicalaccess::LogLevel::TRACE) << trace_stringstream.str();             \
+        }                                                                                \
+    } while (0)
 
 LLA_COMMON_API void trace_print_helper(std::stringstream &ss, const char *param_names,
                                        int idx);
@@ -0,0 +1,236 @@
+/**
+ * \file logsink.cpp
+ * \brief Asynchronous log writer.
+ */
+
+#include <logicalaccess/plugins/llacommon/logsink.hpp>
+
+#include <boost/date_time.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
+namespace logicalaccess
+{
+const size_t AsyncLogSink::MAX_CAPACITY;
+
+/**
+ * \brief Maximum count of records gathered in a single write.
+ */
+static const size_t LOG_SINK_BATCH = 256;
+
+/**
+ * \brief Longest sleep of the writer thread, so a missed wake-up only delays
+ * the output.
+ */
+static const long int LOG_SINK_IDLE_WAIT = 100;
+
+AsyncLogSink::AsyncLogSink(std::ostream &out, size_t capacity, long int flushInterval,
+                           bool toStderr)
+    : d_out(out)
+    , d_toStderr(toStderr)
+    , d_flushInterval(flushInterval)
+    , d_enqueuePos(0)
+    , d_dequeuePos(0)
+    , d_dropped(0)
+    , d_written(0)
+    , d_idle(false)
+    , d_stop(false)
+    , d_flushRequests(0)
+    , d_flushDone(0)
+{
+    size_t size = 2;
+    while (size < capacity && size < MAX_CAPACITY)
+        size <<= 1;
+    d_mask = size - 1;
+
+    d_cells.reset(new Cell[size]);
+    for (size_t i = 0; i < size; ++i)
+        d_cells[i].sequence.store(i, std::memory_order_relaxed);
+
+    d_thread = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_cond.notify_one();
+    d_thread.join();
+
+    // Records pushed while the writer was stopping.
+    std::string record;
+    while (pop(record))
+    {
+        d_out << record;
+        if (d_toStderr)
+            std::cerr << record;
+    }
+    d_out.flush();
+}
+
+bool AsyncLogSink::push(std::string &&record)
+{
+    Cell *cell;
+    size_t pos = d_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell             = &d_cells[pos & d_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (d_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // The writer has not released this cell yet: the ring is full.
+            d_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = d_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (d_idle.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_cond.notify_one();
+    }
+    return true;
+}
+
+bool AsyncLogSink::pop(std::string &record)
+{
+    Cell &cell = d_cells[d_dequeuePos & d_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != d_dequeuePos + 1)
+        return false;
+
+    record = std::move(cell.record);
+    cell.record.clear();
+    cell.sequence.store(d_dequeuePos + d_mask + 1, std::memory_order_release);
+    ++d_dequeuePos;
+    return true;
+}
+
+void AsyncLogSink::flush()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    const uint64_t ticket = ++d_flushRequests;
+    d_cond.notify_one();
+    d_flushCond.wait(lock, [this, ticket]() { return d_flushDone >= ticket || d_stop; });
+}
+
+uint64_t AsyncLogSink::getDroppedCount() const
+{
+    return d_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t AsyncLogSink::getWrittenCount() const
+{
+    return d_written.load(std::memory_order_relaxed);
+}
+
+void AsyncLogSink::run()
+{
+    std::string batch;
+    std::string record;
+    bool dirty        = false;
+    uint64_t reported = 0;
+    auto lastFlush    = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        uint64_t requested;
+        bool stop;
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            requested = d_flushRequests;
+            stop      = d_stop;
+        }
+
+        size_t count;
+        do
+        {
+            batch.clear();
+            count = 0;
+            while (count < LOG_SINK_BATCH && pop(record))
+            {
+                batch += record;
+                ++count;
+            }
+
+            const uint64_t dropped = d_dropped.load(std::memory_order_relaxed);
+            if (dropped != reported)
+            {
+                std::ostringstream oss;
+                oss << boost::posix_time::to_simple_string(
+                           boost::posix_time::microsec_clock::local_time())
+                    << " - WARNING: " << (dropped - reported)
+                    << " log record(s) dropped, the log queue is full." << std::endl;
+                batch += oss.str();
+                reported = dropped;
+            }
+
+            if (!batch.empty())
+            {
+                d_out.write(batch.data(), batch.size());
+                if (d_toStderr)
+                    std::cerr << batch;
+                d_written.fetch_add(count, std::memory_order_relaxed);
+                dirty = true;
+            }
+        } while (count == LOG_SINK_BATCH);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (dirty &&
+            (d_flushInterval <= 0 || requested != d_flushDone || stop ||
+             now - lastFlush >= std::chrono::milliseconds(d_flushInterval)))
+        {
+            d_out.flush();
+            dirty     = false;
+            lastFlush = now;
+        }
+
+        if (requested != d_flushDone)
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_flushDone = requested;
+            d_flushCond.notify_all();
+        }
+
+        if (stop)
+            break;
+
+        long int wait = LOG_SINK_IDLE_WAIT;
+        if (dirty && d_flushInterval < wait)
+            wait = d_flushInterval;
+
+        std::unique_lock<std::mutex> lock(d_mutex);
+        d_idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const bool pending = d_cells[d_dequeuePos & d_mask].sequence.load(
+                                 std::memory_order_acquire) == d_dequeuePos + 1;
+        if (!pending && !d_stop && d_flushRequests == d_flushDone)
+            d_cond.wait_for(lock, std::chrono::milliseconds(wait));
+        d_idle.store(false, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_flushDone = d_flushRequests;
+    d_flushCond.notify_all();
+}
+}
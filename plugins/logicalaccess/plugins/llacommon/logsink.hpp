@@ -0,0 +1,133 @@
+/**
+ * \file logsink.hpp
+ * \brief Asynchronous log writer.
+ */
+
+#ifndef LOGICALACCESS_LOGSINK_HPP
+#define LOGICALACCESS_LOGSINK_HPP
+
+#include <logicalaccess/plugins/llacommon/lla_common_api.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace logicalaccess
+{
+/**
+ * \brief Write log records from a background thread.
+ *
+ * Producers enqueue formatted records in a bounded lock-free multi producer /
+ * single consumer ring. The writer thread drains it in batches and writes each
+ * batch at once. When the ring is full, records are dropped and counted rather
+ * than blocking the caller.
+ */
+class LLA_COMMON_API AsyncLogSink
+{
+  public:
+    /**
+     * \brief Largest ring capacity, in records.
+     */
+    static const size_t MAX_CAPACITY = 1 << 20;
+
+    /**
+     * \brief Constructor. Start the writer thread.
+     * \param out The stream to write to. Must outlive the sink.
+     * \param capacity The ring capacity in records, rounded up to a power of two
+     * and clamped to MAX_CAPACITY.
+     * \param flushInterval Flush the stream at most every flushInterval
+     * milliseconds, 0 to flush after each batch.
+     * \param toStderr Also write the records to stderr.
+     */
+    AsyncLogSink(std::ostream &out, size_t capacity, long int flushInterval,
+                 bool toStderr);
+
+    /**
+     * \brief Destructor. Write the pending records and stop the writer thread.
+     */
+    ~AsyncLogSink();
+
+    AsyncLogSink(const AsyncLogSink &) = delete;
+    AsyncLogSink &operator=(const AsyncLogSink &) = delete;
+
+    /**
+     * \brief Enqueue a record. Never blocks.
+     * \param record The record, including its line feed.
+     * \return False if the ring was full and the record dropped.
+     */
+    bool push(std::string &&record);
+
+    /**
+     * \brief Block until every record enqueued so far is written and flushed.
+     */
+    void flush();
+
+    /**
+     * \brief Get the count of records dropped because the ring was full.
+     * \return The dropped records count.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * \brief Get the count of records written.
+     * \return The written records count.
+     */
+    uint64_t getWrittenCount() const;
+
+    /**
+     * \brief Get the ring capacity.
+     * \return The capacity in records.
+     */
+    size_t getCapacity() const
+    {
+        return d_mask + 1;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::string record;
+    };
+
+    void run();
+
+    /**
+     * \brief Pop a record. Writer thread only.
+     */
+    bool pop(std::string &record);
+
+    std::ostream &d_out;
+    bool d_toStderr;
+    long int d_flushInterval;
+
+    std::unique_ptr<Cell[]> d_cells;
+    size_t d_mask;
+    std::atomic<size_t> d_enqueuePos;
+    size_t d_dequeuePos;
+
+    std::atomic<uint64_t> d_dropped;
+    std::atomic<uint64_t> d_written;
+
+    /**
+     * \brief Wake-up of the writer thread. Producers only take the mutex when the
+     * writer is idle.
+     */
+    std::mutex d_mutex;
+    std::condition_variable d_cond;
+    std::atomic<bool> d_idle;
+    bool d_stop;
+    uint64_t d_flushRequests;
+    uint64_t d_flushDone;
+    std::condition_variable d_flushCond;
+
+    std::thread d_thread;
+};
+}
+
+#endif /* LOGICALACCESS_LOGSINK_HPP */
@@ -9,11 +9,15 @@
 #endif
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/logsink.hpp>
+#include <logicalaccess/plugins/llacommon/spanprofiler.hpp>
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
+#include <atomic>
+#include <mutex>
 #include <string>
 
 #ifdef __APPLE__
@@ -31,8 +35,21 @@ __declspec(dllexport) HMODULE __hLibLogicalAccessModule;
 namespace logicalaccess
 {
 Settings *Settings::instance = nullptr;
+std::shared_ptr<const Settings> Settings::snapshot;
+
+/**
+ * Last published settings version.
+ */
+static std::atomic<uint64_t> settingsVersion(0);
+
+/**
+ * Serialize the publications, so versions are published in order, and the
+ * updates of the instance made through update() and reload().
+ */
+static std::mutex publishMutex;
 
 Settings::Settings()
+    : d_version(0)
 {
     reset();
 }
@@ -48,6 +65,7 @@ void Settings::Initialize()
     try
     {
         LoadSettings();
+        publish();
 
         LOG(LogLevel::INFOS) << "Log [enabled " << IsLogEnabled << " filename "
                              << LogFileName << " seewaitinsertion " << SeeWaitInsertionLog
@@ -58,6 +76,8 @@ void Settings::Initialize()
                              << IsConfigurationRetryEnabled << " timeout "
                              << ConfigurationRetryTimeout << "]";
 
+        SpanProfiler::setEnabled(SpanProfiling);
+
         if (IsLogEnabled && !Logs::logfile.is_open())
         {
 #ifdef _MSC_VER
@@ -67,19 +87,44 @@ void Settings::Initialize()
             Logs::logToStderr = LogToStderr;
             Logs::logfile.open(LogFileName, std::ios::out | std::ios::app);
 #endif
+            Logs::logfileGood = static_cast<bool>(Logs::logfile);
+            if (LogAsync && Logs::logfile)
+            {
+                if (LogQueueSize <= 0 ||
+                    static_cast<unsigned long>(LogQueueSize) > AsyncLogSink::MAX_CAPACITY)
+                {
+                    LOG(LogLevel::WARNINGS)
+                        << "Invalid log queue size " << LogQueueSize
+                        << ", expected 1 to " << AsyncLogSink::MAX_CAPACITY << ".";
+                    if (LogQueueSize <= 0)
+                        LogQueueSize = 8192;
+                    else
+                        LogQueueSize = static_cast<long int>(AsyncLogSink::MAX_CAPACITY);
+                }
+                std::atomic_store(&Logs::asyncSink,
+                                  std::make_shared<AsyncLogSink>(
+                                      Logs::logfile, static_cast<size_t>(LogQueueSize),
+                                      LogFlushInterval, Logs::logToStderr));
+            }
         }
     }
     catch (...)
     {
         reset();
     }
+
+    publish();
 }
 
 void Settings::Uninitialize()
 {
+    // Write the pending records before closing the file. A thread still pushing a
+    // record keeps the sink alive, that record is lost once the file is closed.
+    std::atomic_store(&Logs::asyncSink, std::shared_ptr<AsyncLogSink>());
     if (Logs::logfile)
     {
         Logs::logfile.close();
+        Logs::logfileGood = static_cast<bool>(Logs::logfile);
     }
 }
 
@@ -94,6 +139,67 @@ Settings *Settings::getInstance()
     return instance;
 }
 
+std::shared_ptr<const Settings> Settings::getSnapshot()
+{
+    static thread_local std::shared_ptr<const Settings> cached;
+
+    if (!cached || cached->d_version != settingsVersion.load(std::memory_order_acquire))
+    {
+        cached = std::atomic_load(&snapshot);
+        if (!cached)
+        {
+            // The first snapshot is published at initialization.
+            getInstance();
+            cached = std::atomic_load(&snapshot);
+        }
+    }
+    return cached;
+}
+
+void Settings::publish()
+{
+    std::lock_guard<std::mutex> lock(publishMutex);
+    publishLocked();
+}
+
+void Settings::update(const std::function<void(Settings &)> &change)
+{
+    Settings *settings = getInstance();
+    std::lock_guard<std::mutex> lock(publishMutex);
+    change(*settings);
+    settings->publishLocked();
+}
+
+void Settings::publishLocked()
+{
+    std::shared_ptr<Settings> next(new Settings(*this));
+    d_version = next->d_version = settingsVersion.load(std::memory_order_relaxed) + 1;
+    std::atomic_store(&snapshot, std::shared_ptr<const Settings>(next));
+    settingsVersion.store(d_version, std::memory_order_release);
+}
+
+void Settings::reload()
+{
+    Settings *settings = getInstance();
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        // Load a copy, so the instance never holds a partially loaded configuration.
+        Settings loaded(*settings);
+        loaded.LoadSettings();
+        SpanProfiler::setEnabled(loaded.SpanProfiling);
+        *settings = loaded;
+        settings->publishLocked();
+        version = settings->getVersion();
+    }
+    LOG(LogLevel::INFOS) << "Settings reloaded (version " << version << ").";
+}
+
+uint64_t Settings::getVersion() const
+{
+    return d_version;
+}
+
 // Loads log settings structure from the specified XML file
 void Settings::LoadSettings()
 {
@@ -140,6 +246,10 @@ void Settings::LoadSettings()
         SeePluginLog        = pt.get("config.log.seeplugin", false);
         ColorizeLog         = pt.get("config.log.colorize", false);
         ContextLog          = pt.get("config.log.context", false);
+        LogAsync            = pt.get("config.log.async", false);
+        LogQueueSize        = pt.get("config.log.queuesize", 8192);
+        LogFlushInterval    = pt.get("config.log.flushinterval", 0);
+        SpanProfiling       = pt.get("config.log.spans", false);
 
         IsAutoDetectEnabled  = pt.get("config.autodetect.enabled", false);
         AutoDetectionTimeout = pt.get<long int>("config.autodetect.timeout", 400);
@@ -152,6 +262,8 @@ void Settings::LoadSettings()
         DefaultReader = pt.get<std::string>("config.reader.default", "PCSC");
 
         DataTransportTimeout = pt.get<int>("config.dataTransportTimeout", 3000);
+        TransportReactorThreads = pt.get<int>("config.transportReactor.threads", 2);
+        TransportWorkerThreads  = pt.get<int>("config.transportReactor.workers", 4);
 
         PluginFolders.clear();
         BOOST_FOREACH (ptree::value_type const &v, pt.get_child("config.PluginFolders"))
@@ -198,6 +310,10 @@ void Settings::SaveSettings() const
         pt.put("config.log.seeplugin", SeePluginLog);
         pt.put("config.log.colorize", ColorizeLog);
         pt.put("config.log.context", ContextLog);
+        pt.put("config.log.async", LogAsync);
+        pt.put("config.log.queuesize", LogQueueSize);
+        pt.put("config.log.flushinterval", LogFlushInterval);
+        pt.put("config.log.spans", SpanProfiling);
 
         pt.put("config.autodetect.enabled", IsAutoDetectEnabled);
         pt.put("config.autodetect.timeout", AutoDetectionTimeout);
@@ -208,6 +324,8 @@ void Settings::SaveSettings() const
         pt.put("config.reader.default", "PCSC");
 
         pt.put("config.dataTransportTimeout", DataTransportTimeout);
+        pt.put("config.transportReactor.threads", TransportReactorThreads);
+        pt.put("config.transportReactor.workers", TransportWorkerThreads);
 
         // Write the property tree to the XML file.
         write_xml((getDllPath() + "/liblogicalaccess.config"), pt);
@@ -228,6 +346,10 @@ void Settings::reset()
     SeePluginLog        = false;
     ColorizeLog         = false;
     ContextLog          = false;
+    LogAsync            = false;
+    LogQueueSize        = 8192;
+    LogFlushInterval    = 0;
+    SpanProfiling       = false;
 
     IsAutoDetectEnabled  = false;
     AutoDetectionTimeout = 400;
@@ -238,7 +360,9 @@ void Settings::reset()
     PluginFolders.clear();
     PluginFolders.push_back(getDllPath());
 
-    DataTransportTimeout = 3000;
+    DataTransportTimeout    = 3000;
+    TransportReactorThreads = 2;
+    TransportWorkerThreads  = 4;
 }
 
 std::string Settings::getDllPath()
@@ -7,6 +7,9 @@
 #ifndef LOGICALACCESS_SETTINGS_HPP
 #define LOGICALACCESS_SETTINGS_HPP
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -17,8 +20,54 @@ namespace logicalaccess
 class LLA_COMMON_API Settings
 {
   public:
+    /**
+     * \brief Get the settings instance, to change the settings.
+     *
+     * Readers should use getSnapshot() instead. Values written here are only
+     * seen by the readers once publish() is called.
+     * \return The settings instance.
+     */
     static Settings *getInstance();
 
+    /**
+     * \brief Get an immutable copy of the settings.
+     *
+     * Hot paths should capture the snapshot once per transaction and read it
+     * from there: the values cannot change under them, even if the settings are
+     * reloaded in the meantime. The snapshot is cached per thread, so this is
+     * cheap unless the settings changed.
+     * \return The last published settings.
+     */
+    static std::shared_ptr<const Settings> getSnapshot();
+
+    /**
+     * \brief Publish the current values of the settings instance as the new
+     * snapshot. Readers holding the previous snapshot are not affected.
+     *
+     * Call it once done writing through getInstance(); the writes must not be
+     * concurrent with it. Prefer update(), which serializes both.
+     */
+    void publish();
+
+    /**
+     * \brief Change the settings instance and publish it.
+     * \param change The function writing the new values.
+     *
+     * Updates are serialized with each other, with publish() and with reload().
+     */
+    static void update(const std::function<void(Settings &)> &change);
+
+    /**
+     * \brief Read the configuration file again and publish it.
+     */
+    static void reload();
+
+    /**
+     * \brief Get the version of the settings, increased on each publication.
+     * \return The version.
+     */
+    uint64_t getVersion() const;
+
     void Initialize();
     static void Uninitialize();
 
@@ -33,6 +82,36 @@ class LLA_COMMON_API Settings
     bool ColorizeLog;
     bool ContextLog;
 
+    /**
+     * Write the log from a background thread instead of the logging thread.
+     *
+     * If not specified, use false.
+     */
+    bool LogAsync;
+
+    /**
+     * Count of log records the asynchronous writer can queue. Records are
+     * dropped (and counted) beyond that.
+     *
+     * If not specified, use 8192.
+     */
+    long int LogQueueSize;
+
+    /**
+     * Minimum delay in milliseconds between two flushes of the log file by the
+     * asynchronous writer, 0 to flush after each batch of records.
+     *
+     * If not specified, use 0.
+     */
+    long int LogFlushInterval;
+
+    /**
+     * Measure the duration of the log contexts, see SpanProfiler.
+     *
+     * If not specified, use false.
+     */
+    bool SpanProfiling;
+
     /* Auto-Detection */
     bool IsAutoDetectEnabled;
     long int AutoDetectionTimeout;
@@ -54,6 +133,20 @@ class LLA_COMMON_API Settings
      */
     int DataTransportTimeout;
 
+    /**
+     * Number of threads multiplexing the sockets of network transports.
+     *
+     * If not specified, use 2.
+     */
+    int TransportReactorThreads;
+
+    /**
+     * Number of threads executing asynchronous transport commands.
+     *
+     * If not specified, use 4.
+     */
+    int TransportWorkerThreads;
+
     static std::string getDllPath();
 
   protected:
@@ -65,7 +158,16 @@ class LLA_COMMON_API Settings
     static Settings *instance;
 
   private:
+    /**
+     * \brief Publish the settings instance, the publication lock held.
+     */
+    void publishLocked();
+
     void reset();
+
+    uint64_t d_version;
+
+    static std::shared_ptr<const Settings> snapshot;
 };
 }
 
@@ -0,0 +1,159 @@
+/**
+ * \file spanprofiler.cpp
+ * \brief Timing statistics of the log context scopes.
+ */
+
+#include <logicalaccess/plugins/llacommon/spanprofiler.hpp>
+#include <logicalaccess/plugins/llacommon/loglinearhistogram.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace logicalaccess
+{
+namespace
+{
+struct SpanHistogram
+{
+    SpanHistogram()
+        : count(0)
+        , total(0)
+        , min(std::numeric_limits<uint64_t>::max())
+        , max(0)
+        , buckets(LogLinearHistogram::BUCKET_COUNT, 0)
+    {
+    }
+
+    uint64_t percentile(double percentile) const
+    {
+        return LogLinearHistogram::getPercentile(buckets.data(), percentile, max);
+    }
+
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    std::vector<uint64_t> buckets;
+};
+
+struct SpanRegistry
+{
+    std::mutex mutex;
+    std::map<std::string, SpanHistogram> spans;
+};
+
+SpanRegistry &registry()
+{
+    static SpanRegistry instance;
+    return instance;
+}
+
+std::atomic<bool> spansEnabled(false);
+}
+
+void SpanProfiler::setEnabled(bool enabled)
+{
+    spansEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool SpanProfiler::isEnabled()
+{
+    return spansEnabled.load(std::memory_order_relaxed);
+}
+
+void SpanProfiler::record(const std::string &path,
+                          std::chrono::steady_clock::duration duration)
+{
+    const int64_t us =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    const uint64_t value = us > 0 ? static_cast<uint64_t>(us) : 0;
+
+    SpanRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    SpanHistogram &span = reg.spans[path];
+    ++span.count;
+    span.total += value;
+    span.min = std::min(span.min, value);
+    span.max = std::max(span.max, value);
+    ++span.buckets[LogLinearHistogram::getBucketIndex(value)];
+}
+
+std::vector<SpanStatistics> SpanProfiler::getStatistics()
+{
+    std::vector<SpanStatistics> ret;
+    SpanRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    ret.reserve(reg.spans.size());
+    for (const auto &it : reg.spans)
+    {
+        SpanStatistics stats;
+        stats.path  = it.first;
+        stats.count = it.second.count;
+        stats.total = it.second.total;
+        stats.min   = it.second.min;
+        stats.max   = it.second.max;
+        stats.p50   = it.second.percentile(50);
+        stats.p99   = it.second.percentile(99);
+        ret.push_back(stats);
+    }
+    return ret;
+}
+
+std::string SpanProfiler::dump()
+{
+    std::ostringstream oss;
+    oss << std::setw(10) << "count" << std::setw(14) << "total(us)" << std::setw(12)
+        << "p50(us)" << std::setw(12) << "p99(us)" << std::setw(12) << "max(us)"
+        << "  span" << std::endl;
+
+    for (const auto &stats : getStatistics())
+    {
+        // Indent by depth and only print the innermost name.
+        const size_t depth = static_cast<size_t>(
+            std::count(stats.path.begin(), stats.path.end(), ';'));
+        const size_t sep = stats.path.rfind(';');
+        oss << std::setw(10) << stats.count << std::setw(14) << stats.total
+            << std::setw(12) << stats.p50 << std::setw(12) << stats.p99 << std::setw(12)
+            << stats.max << "  " << std::string(depth * 2, ' ')
+            << (sep == std::string::npos ? stats.path : stats.path.substr(sep + 1))
+            << std::endl;
+    }
+    return oss.str();
+}
+
+std::string SpanProfiler::dumpFoldedStacks()
+{
+    std::vector<SpanStatistics> statistics = getStatistics();
+
+    // flamegraph.pl expects the time spent in the span itself, not in its children.
+    std::map<std::string, uint64_t> self;
+    for (const auto &stats : statistics)
+        self[stats.path] = stats.total;
+    for (const auto &stats : statistics)
+    {
+        const size_t sep = stats.path.rfind(';');
+        if (sep == std::string::npos)
+            continue;
+        auto parent = self.find(stats.path.substr(0, sep));
+        if (parent != self.end())
+            parent->second -= std::min(parent->second, stats.total);
+    }
+
+    std::ostringstream oss;
+    for (const auto &it : self)
+        oss << it.first << " " << it.second << std::endl;
+    return oss.str();
+}
+
+void SpanProfiler::reset()
+{
+    SpanRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.spans.clear();
+}
+}
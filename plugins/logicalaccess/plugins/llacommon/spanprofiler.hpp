@@ -0,0 +1,93 @@
+/**
+ * \file spanprofiler.hpp
+ * \brief Timing statistics of the log context scopes.
+ */
+
+#ifndef LOGICALACCESS_SPANPROFILER_HPP
+#define LOGICALACCESS_SPANPROFILER_HPP
+
+#include <logicalaccess/plugins/llacommon/lla_common_api.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Aggregated timings of a span. All durations are in microseconds.
+ */
+struct SpanStatistics
+{
+    /**
+     * \brief The span path: the names of the enclosing spans and the span
+     * itself, separated by ';'.
+     */
+    std::string path;
+
+    uint64_t count;
+
+    uint64_t total;
+
+    uint64_t min;
+
+    uint64_t max;
+
+    uint64_t p50;
+
+    uint64_t p99;
+};
+
+/**
+ * \brief Collect the duration of the LLA_LOG_CTX scopes.
+ *
+ * When enabled, each LogContext measures its lifetime with a monotonic clock
+ * and reports it here under its path, so nested contexts give nested spans.
+ * Durations are kept in a LogLinearHistogram per path (within 6.25%).
+ * Disabled by default, see Settings::SpanProfiling.
+ */
+class LLA_COMMON_API SpanProfiler
+{
+  public:
+    /**
+     * \brief Enable or disable the spans measurement.
+     * \param enabled True to measure the spans.
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled();
+
+    /**
+     * \brief Record a span duration.
+     * \param path The span path.
+     * \param duration The span duration.
+     */
+    static void record(const std::string &path, std::chrono::steady_clock::duration duration);
+
+    /**
+     * \brief Get the statistics of all the recorded spans.
+     * \return The statistics, sorted by path.
+     */
+    static std::vector<SpanStatistics> getStatistics();
+
+    /**
+     * \brief Get the statistics as a human readable table.
+     * \return The table, one span per line, nested spans are indented.
+     */
+    static std::string dump();
+
+    /**
+     * \brief Get the statistics in the folded stacks format of flamegraph.pl.
+     * \return One "path self-time" line per span, in microseconds.
+     */
+    static std::string dumpFoldedStacks();
+
+    /**
+     * \brief Forget all the recorded spans.
+     */
+    static void reset();
+};
+}
+
+#endif /* LOGICALACCESS_SPANPROFILER_HPP */
@@ -76,11 +76,12 @@ void AdmittoReaderUnit::setCardType(const std::string cardType)
 
 bool AdmittoReaderUnit::waitInsertion(const unsigned int maxwait)
 {
-    const bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    const bool oldValue                      = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitInsertionLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -136,25 +137,26 @@ bool AdmittoReaderUnit::waitInsertion(const unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
     LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted
                          << "} function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return inserted;
 }
 
 bool AdmittoReaderUnit::waitRemoval(const unsigned int maxwait)
 {
-    const bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    const bool oldValue                      = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitRemovalLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -220,7 +222,7 @@ bool AdmittoReaderUnit::waitRemoval(const unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
@@ -228,7 +230,7 @@ bool AdmittoReaderUnit::waitRemoval(const unsigned int maxwait)
                          << "} - function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return removed;
 }
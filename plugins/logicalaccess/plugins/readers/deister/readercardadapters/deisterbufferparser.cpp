@@ -4,7 +4,11 @@
  * \brief Deister buffer parser.
  */
 
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/plugins/readers/deister/readercardadapters/deisterbufferparser.hpp>
+#include <logicalaccess/plugins/readers/deister/readercardadapters/deisterreadercardadapter.hpp>
+
+#include <algorithm>
 
 namespace logicalaccess
 {
@@ -12,21 +16,45 @@ ByteVector DeisterBufferParser::getValidBuffer(
     boost::circular_buffer<unsigned char> &circular_buffer)
 {
     ByteVector result;
-    const unsigned char STOP = 0xFE;
 
-    if (circular_buffer.size() >= 10)
+    // A frame is Dummy Dummy SOM src dst cmd status data STOP. SOM and STOP
+    // are escaped inside the frame, so they always delimit a frame.
+    while (circular_buffer.size() >= 3)
     {
-        for (size_t i = 7; i < circular_buffer.size(); ++i)
+        if (circular_buffer[0] != DeisterReaderCardAdapter::Dummy ||
+            circular_buffer[1] != DeisterReaderCardAdapter::Dummy ||
+            circular_buffer[2] != DeisterReaderCardAdapter::SOM)
         {
-            if (circular_buffer[i] == STOP)
-            {
-                result.assign(circular_buffer.begin(), circular_buffer.begin() + i + 1);
-                circular_buffer.erase(circular_buffer.begin(),
-                                      circular_buffer.begin() + i + 1);
+            circular_buffer.pop_front();
+            continue;
+        }
+
+        size_t i = 3;
+        for (; i < circular_buffer.size(); ++i)
+        {
+            if (circular_buffer[i] == DeisterReaderCardAdapter::SOM ||
+                circular_buffer[i] == DeisterReaderCardAdapter::STOP)
                 break;
-            }
         }
+        if (i == circular_buffer.size())
+            break;
+
+        if (circular_buffer[i] == DeisterReaderCardAdapter::SOM || i < 9)
+        {
+            // Keep the dummy bytes in front of the next SOM.
+            LOG(LogLevel::WARNINGS) << "Drop truncated Deister frame.";
+            const size_t dropped = std::max<size_t>(1, i - 2);
+            circular_buffer.erase(circular_buffer.begin(),
+                                  circular_buffer.begin() +
+                                      static_cast<std::ptrdiff_t>(dropped));
+            continue;
+        }
+
+        const auto end = circular_buffer.begin() + static_cast<std::ptrdiff_t>(i + 1);
+        result.assign(circular_buffer.begin(), end);
+        circular_buffer.erase(circular_buffer.begin(), end);
+        break;
     }
     return result;
 }
-}
\ No newline at end of file
+}
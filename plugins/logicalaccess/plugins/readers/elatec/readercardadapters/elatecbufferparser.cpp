@@ -4,6 +4,7 @@
  * \brief Elatec buffer parser.
  */
 
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/plugins/readers/elatec/readercardadapters/elatecbufferparser.hpp>
 
 namespace logicalaccess
@@ -13,16 +14,34 @@ ElatecBufferParser::getValidBuffer(boost::circular_buffer<unsigned char> &circul
 {
     ByteVector result;
 
-    if (circular_buffer.size() >= 5)
+    // A frame is length cmd? status data checksum, where length counts the whole
+    // frame and checksum is the XOR of all preceding bytes.
+    while (circular_buffer.size() >= 5)
     {
         unsigned char buflength = circular_buffer[0];
-        if (circular_buffer.size() >= buflength)
+        if (buflength < 5)
         {
-            result.assign(circular_buffer.begin(), circular_buffer.begin() + buflength);
-            circular_buffer.erase(circular_buffer.begin(),
-                                  circular_buffer.begin() + buflength);
+            circular_buffer.pop_front();
+            continue;
         }
+        if (circular_buffer.size() < buflength)
+            break;
+
+        unsigned char checksum = 0x00;
+        for (size_t i = 0; i < static_cast<size_t>(buflength - 1); ++i)
+            checksum ^= circular_buffer[i];
+        if (checksum != circular_buffer[buflength - 1])
+        {
+            LOG(LogLevel::WARNINGS) << "Wrong checksum, resynchronizing.";
+            circular_buffer.pop_front();
+            continue;
+        }
+
+        result.assign(circular_buffer.begin(), circular_buffer.begin() + buflength);
+        circular_buffer.erase(circular_buffer.begin(),
+                              circular_buffer.begin() + buflength);
+        break;
     }
     return result;
 }
-}
\ No newline at end of file
+}
@@ -59,6 +59,19 @@ class LLA_READERS_ELATEC_API ElatecReaderCardAdapter : public ReaderCardAdapter
     virtual ByteVector sendCommand(unsigned char cmdcode, const ByteVector &command,
                                    long int timeout = 2000);
 
+    /**
+     * \brief Send a batch of commands, one at a time: adaptAnswer() checks each
+     * answer against the last command code.
+     * \param commands The command buffers.
+     * \param timeout The timeout of each command.
+     * \return The results, in the commands order.
+     */
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long timeout = -1) override
+    {
+        return sendCommandsInSequence(commands, timeout);
+    }
+
   protected:
     /**
      * \brief Calculate the buffer checksum.
@@ -83,11 +83,12 @@ bool GunneboReaderUnit::waitInsertion(unsigned int maxwait)
 {
     std::chrono::system_clock::time_point wait_until(std::chrono::system_clock::now() +
                                                      std::chrono::milliseconds(maxwait));
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitInsertionLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -145,7 +146,7 @@ bool GunneboReaderUnit::waitInsertion(unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
@@ -156,7 +157,7 @@ bool GunneboReaderUnit::waitInsertion(unsigned int maxwait)
                          << (std::chrono::system_clock::now() > wait_until &&
                              maxwait != 0)
                          << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return inserted;
 }
@@ -166,11 +167,12 @@ bool GunneboReaderUnit::waitRemoval(unsigned int maxwait)
     std::chrono::steady_clock::time_point wait_until(std::chrono::steady_clock::now() +
                                                      std::chrono::milliseconds(maxwait));
 
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitRemovalLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -221,7 +223,7 @@ bool GunneboReaderUnit::waitRemoval(unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
@@ -231,7 +233,7 @@ bool GunneboReaderUnit::waitRemoval(unsigned int maxwait)
                              maxwait != 0)
                          << "}";
 
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return removed;
 }
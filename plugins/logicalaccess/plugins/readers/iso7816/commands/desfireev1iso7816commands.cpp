@@ -294,6 +294,7 @@ void DESFireEV1ISO7816Commands::createCyclicRecordFile(
 void DESFireEV1ISO7816Commands::authenticate(unsigned char keyno,
                                              std::shared_ptr<DESFireKey> key)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::authenticate");
     if (!key)
     {
         key = DESFireCrypto::getDefaultKey(DF_KEY_DES);
@@ -752,6 +753,7 @@ void DESFireEV1ISO7816Commands::iso_authenticate(std::shared_ptr<DESFireKey> cur
 void DESFireEV1ISO7816Commands::authenticateISO(unsigned char keyno,
                                                 DESFireISOAlgorithm algorithm)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::authenticateISO");
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
     crypto->d_auth_method                 = CM_LEGACY; // To prevent CMAC checking
 
@@ -872,6 +874,7 @@ void DESFireEV1ISO7816Commands::iks_authenticateAES(std::shared_ptr<DESFireKey>
 
 void DESFireEV1ISO7816Commands::authenticateAES(unsigned char keyno)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::authenticateAES");
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
     crypto->d_auth_method                 = CM_LEGACY; // To prevent CMAC checking
 
@@ -934,73 +937,78 @@ ByteVector DESFireEV1ISO7816Commands::handleReadData(unsigned char err,
                                                      unsigned int length,
                                                      EncryptionMode mode)
 {
-    ByteVector ret, data;
+    ByteVector ret;
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
+    // Each frame is deciphered or MACed as soon as it is received.
+    const bool checkMAC =
+        mode == CM_MAC || (mode == CM_PLAIN && crypto->d_auth_method != CM_LEGACY);
 
     if ((err == DF_INS_ADDITIONAL_FRAME || err == 0x00))
     {
+        crypto->initBuf();
         if (mode == CM_ENCRYPT)
         {
-            crypto->initBuf();
             crypto->appendDecipherData(firstMsg);
         }
         else
         {
-            ret = data = firstMsg;
-            crypto->initBuf();
+            ret = firstMsg;
+            if (checkMAC)
+                crypto->verifyMAC(false, firstMsg);
         }
     }
 
-    while (err == DF_INS_ADDITIONAL_FRAME)
+    try
     {
-        auto result = transmit_plain(DF_INS_ADDITIONAL_FRAME);
-        err         = result.getSW2();
-        if (mode == CM_ENCRYPT)
-        {
-            crypto->appendDecipherData(result.getData());
-        }
-        else
+        while (err == DF_INS_ADDITIONAL_FRAME)
         {
-            ret.insert(ret.end(), result.getData().begin(), result.getData().end());
+            auto result = transmit_plain(DF_INS_ADDITIONAL_FRAME);
+            err         = result.getSW2();
+            if (mode == CM_ENCRYPT)
+            {
+                crypto->appendDecipherData(result.getData());
+            }
+            else
+            {
+                ret.insert(ret.end(), result.getData().begin(), result.getData().end());
+                if (checkMAC)
+                    crypto->verifyMAC(false, result.getData());
+            }
         }
-    }
 
-    switch (mode)
-    {
-    case CM_PLAIN:
-    {
-        if (crypto->d_auth_method != CM_LEGACY)
+        switch (mode)
+        {
+        case CM_PLAIN:
+        case CM_MAC:
         {
-            if (!crypto->verifyMAC(true, ret))
+            if (checkMAC)
             {
-                THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
-                                         "MAC data doesn't match.");
+                if (!crypto->verifyMAC(true, ByteVector()))
+                {
+                    THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                             "MAC data doesn't match.");
+                }
+                ret.resize(ret.size() - crypto->d_mac_size);
             }
-            ret.resize(ret.size() - crypto->d_mac_size);
         }
-    }
-    break;
-
-    case CM_MAC:
-    {
-        if (!crypto->verifyMAC(true, ret))
+        break;
+        case CM_ENCRYPT:
         {
-            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
-                                     "MAC data doesn't match.");
+            ret                        = crypto->desfireDecrypt(length);
+            handle_read_data_last_sig_ = crypto->get_last_signature();
+        }
+        break;
+        case CM_UNKNOWN:
+        {
+        }
+        break;
         }
-        ret.resize(ret.size() - crypto->d_mac_size);
-    }
-    break;
-    case CM_ENCRYPT:
-    {
-        ret                        = crypto->desfireDecrypt(length);
-        handle_read_data_last_sig_ = crypto->get_last_signature();
     }
-    break;
-    case CM_UNKNOWN:
+    catch (...)
     {
-    }
-    break;
+        // Do not leave a partial stream for the next MAC verification.
+        crypto->initBuf();
+        throw;
     }
 
     return ret;
@@ -1108,6 +1116,7 @@ void DESFireEV1ISO7816Commands::handleWriteData(unsigned char cmd,
 ByteVector DESFireEV1ISO7816Commands::readData(unsigned char fileno, unsigned int offset,
                                                unsigned int length, EncryptionMode mode)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::readData");
     ByteVector command(7), ret;
     ISO7816Response result = ISO7816Response();
 
@@ -1153,6 +1162,7 @@ ByteVector DESFireEV1ISO7816Commands::readRecords(unsigned char fileno,
                                                   unsigned int length,
                                                   EncryptionMode mode)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::readRecords");
     ByteVector command;
 
     command.push_back(fileno);
@@ -1238,6 +1248,7 @@ void DESFireEV1ISO7816Commands::changeKeySettings(DESFireKeySettings settings)
 void DESFireEV1ISO7816Commands::changeKey(unsigned char keyno,
                                           std::shared_ptr<DESFireKey> newkey)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::changeKey");
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
     std::shared_ptr<DESFireKey> key       = std::make_shared<DESFireKey>(*newkey);
     auto oldkey                           = crypto->getKey(0, keyno);
@@ -1385,6 +1396,7 @@ ByteVector DESFireEV1ISO7816Commands::getFileIDs()
 void DESFireEV1ISO7816Commands::getValue(unsigned char fileno, EncryptionMode mode,
                                          unsigned int &value)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::getValue");
     ByteVector command;
     command.push_back(fileno);
 
@@ -1676,6 +1688,7 @@ void DESFireEV1ISO7816Commands::iks_iso_authenticate(std::shared_ptr<DESFireKey>
 
 void DESFireEV1ISO7816Commands::selectApplication(unsigned int aid)
 {
+    LLA_LOG_CTX("DESFireEV1ISO7816Commands::selectApplication");
     DESFireISO7816Commands::selectApplication(aid);
 }
 
@@ -24,6 +24,8 @@ namespace logicalaccess
 {
 SAMAV2ISO7816Commands::SAMAV2ISO7816Commands()
     : SAMISO7816Commands<KeyEntryAV2Information, SETAV2>(CMD_SAMAV2ISO7816)
+    , d_sessionCipher(std::make_shared<openssl::AESCipher>())
+    , d_macCipher(std::make_shared<openssl::AESCipher>())
     , d_cmdCtr(0)
 {
     d_lastMacIV.resize(16);
@@ -31,6 +33,8 @@ SAMAV2ISO7816Commands::SAMAV2ISO7816Commands()
 
 SAMAV2ISO7816Commands::SAMAV2ISO7816Commands(std::string ct)
     : SAMISO7816Commands<KeyEntryAV2Information, SETAV2>(ct)
+    , d_sessionCipher(std::make_shared<openssl::AESCipher>())
+    , d_macCipher(std::make_shared<openssl::AESCipher>())
     , d_cmdCtr(0)
 {
     d_lastMacIV.resize(16);
@@ -71,10 +75,11 @@ void SAMAV2ISO7816Commands::generateSessionKey(ByteVector rnda, ByteVector rndb)
     std::shared_ptr<openssl::InitializationVector> iv(
         new openssl::AESInitializationVector(
             openssl::AESInitializationVector::createFromData(emptyIV)));
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher(new openssl::AESCipher());
 
-    cipher->cipher(SV1a, d_sessionKey, *symkey.get(), *iv.get(), false);
-    cipher->cipher(SV2a, d_macSessionKey, *symkey.get(), *iv.get(), false);
+    openssl::AESCipher cipher;
+    cipher.cipher(SV1a, d_sessionKey, *symkey.get(), *iv.get(), false);
+    cipher.cipher(SV2a, d_macSessionKey, *symkey.get(), *iv.get(), false);
+    d_macContext = std::make_shared<openssl::CMACContext>(d_macSessionKey, d_macCipher);
 }
 
 void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
@@ -106,7 +111,9 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
 
     ByteVector keycipher(key->getData(), key->getData() + key->getLength());
     d_macSessionKey = keycipher;
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher(new openssl::AESCipher());
+    d_sessionCipher = std::make_shared<openssl::AESCipher>();
+    d_macCipher     = std::make_shared<openssl::AESCipher>();
+    d_macContext = std::make_shared<openssl::CMACContext>(d_macSessionKey, d_macCipher);
     ByteVector rnd1;
 
     /* Create rnd2 for p3 - CMAC: rnd2 | Host Mode | ZeroPad */
@@ -114,8 +121,7 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
     rnd2.push_back(hostmode); // Host Mode: Full Protection
     rnd2.resize(16);          // ZeroPad
 
-    ByteVector macHost =
-        openssl::CMACCrypto::cmac(d_macSessionKey, cipher, rnd2, d_lastMacIV, 16);
+    ByteVector macHost = d_macContext->cmac(rnd2, d_lastMacIV, 16);
     truncateMacBuffer(macHost);
 
     rnd1.resize(12);
@@ -138,8 +144,7 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
     /* Check CMAC - Create rnd1 for p3 - CMAC: rnd1 | P1 | other data */
     rnd1.insert(rnd1.end(), rnd2.begin() + 12, rnd2.end()); // p2 data without rnd2
 
-    macHost =
-        openssl::CMACCrypto::cmac(d_macSessionKey, cipher, rnd1, d_lastMacIV, 16);
+    macHost = d_macContext->cmac(rnd1, d_lastMacIV, 16);
     truncateMacBuffer(macHost);
 
     for (unsigned char x = 0; x < 8; ++x)
@@ -170,7 +175,8 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
     ByteVector encRndB(result.getData().begin() + 8, result.getData().end());
     ByteVector dencRndB;
 
-    cipher->decipher(encRndB, dencRndB, *symkey.get(), *iv.get(), false);
+    openssl::AESCipher cipher;
+    cipher.decipher(encRndB, dencRndB, *symkey.get(), *iv.get(), false);
 
     // create rndB'
     ByteVector rndB1;
@@ -184,7 +190,7 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
 
     iv.reset(new openssl::AESInitializationVector(
         openssl::AESInitializationVector::createFromData(d_lastMacIV)));
-    cipher->cipher(dataHost, encHost, *symkey.get(), *iv.get(), false);
+    cipher.cipher(dataHost, encHost, *symkey.get(), *iv.get(), false);
 
     result = getISO7816ReaderCardAdapter()->sendAPDUCommand(d_cla, 0xa4, 0x00, 0x00, 0x20,
                                                             encHost, 0x00);
@@ -195,7 +201,7 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
     ByteVector SAMrndA;
     iv.reset(new openssl::AESInitializationVector(
         openssl::AESInitializationVector::createFromData(d_lastMacIV)));
-    cipher->decipher(result.getData(), SAMrndA, *symkey.get(), *iv.get(), false);
+    cipher.decipher(result.getData(), SAMrndA, *symkey.get(), *iv.get(), false);
     SAMrndA.insert(SAMrndA.begin(), SAMrndA.end() - 2, SAMrndA.end());
 
     if (!equal(SAMrndA.begin(), SAMrndA.begin() + 16, rndA.begin()))
@@ -215,7 +221,6 @@ ByteVector SAMAV2ISO7816Commands::createfullProtectionCmd(ByteVector cmd)
     std::shared_ptr<openssl::InitializationVector> ivSession(
         new openssl::AESInitializationVector(
             openssl::AESInitializationVector::createFromData(d_LastSessionIV)));
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher(new openssl::AESCipher());
     ByteVector protectedCmd = cmd, cmdCtrVector, finalFullProtectedCmd = cmd, encData;
 
     getLcLe(cmd, lc, lcvalue, le);
@@ -247,7 +252,8 @@ ByteVector SAMAV2ISO7816Commands::createfullProtectionCmd(ByteVector cmd)
         ivSession.reset(new openssl::AESInitializationVector(
             openssl::AESInitializationVector::createFromData(d_LastSessionIV)));
 
-        cipher->cipher(data, encData, *symkeySession.get(), *ivSession.get(), false);
+        d_sessionCipher->cipher(data, encData, *symkeySession.get(), *ivSession.get(),
+                                false);
         protectedCmd.insert(protectedCmd.begin() + AV2_HEADER_LENGTH, encData.begin(),
                             encData.end());
         finalFullProtectedCmd.insert(finalFullProtectedCmd.begin() + AV2_HEADER_LENGTH,
@@ -275,12 +281,11 @@ ByteVector SAMAV2ISO7816Commands::createfullProtectionCmd(ByteVector cmd)
         ByteVector encMac(protectedCmd.begin(), protectedCmd.begin() + blockReady), tmp;
         protectedCmd.erase(protectedCmd.begin(), protectedCmd.begin() + blockReady);
 
-        cipher->cipher(encMac, tmp, *symkeyMac.get(), *ivMac.get(), false);
+        d_macCipher->cipher(encMac, tmp, *symkeyMac.get(), *ivMac.get(), false);
         d_lastMacIV.assign(tmp.end() - 16, tmp.end());
     }
 
-    ByteVector encProtectedCmd = openssl::CMACCrypto::cmac(d_macSessionKey, cipher,
-                                                           protectedCmd, d_lastMacIV, 16);
+    ByteVector encProtectedCmd = d_macContext->cmac(protectedCmd, d_lastMacIV, 16);
     truncateMacBuffer(encProtectedCmd);
 
     finalFullProtectedCmd.insert(finalFullProtectedCmd.begin() + AV2_HEADER_LENGTH +
@@ -338,7 +343,6 @@ ByteVector SAMAV2ISO7816Commands::verifyAndDecryptResponse(ByteVector response)
     std::shared_ptr<openssl::InitializationVector> ivSession(
         new openssl::AESInitializationVector(
             openssl::AESInitializationVector::createFromData(d_LastSessionIV)));
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher(new openssl::AESCipher());
 
     /* begin check mac */
     ByteVector myMac, cmdCtrVector, myEncMac, data;
@@ -363,13 +367,12 @@ ByteVector SAMAV2ISO7816Commands::verifyAndDecryptResponse(ByteVector response)
         ByteVector lastBlock(myMac.begin() + blockReady, myMac.end());
         myMac.erase(myMac.begin() + blockReady, myMac.end());
 
-        cipher->cipher(myMac, myEncMac, *symkeyMac.get(), *ivMac.get(), false);
+        d_macCipher->cipher(myMac, myEncMac, *symkeyMac.get(), *ivMac.get(), false);
         d_lastMacIV.assign(myEncMac.end() - 16, myEncMac.end());
         myMac = lastBlock;
     }
 
-    myEncMac =
-        openssl::CMACCrypto::cmac(d_macSessionKey, cipher, myMac, d_lastMacIV, 16);
+    myEncMac = d_macContext->cmac(myMac, d_lastMacIV, 16);
     truncateMacBuffer(myEncMac);
 
     if (!equal(myEncMac.begin(), myEncMac.begin() + 8, mac.begin()))
@@ -387,7 +390,8 @@ ByteVector SAMAV2ISO7816Commands::verifyAndDecryptResponse(ByteVector response)
             openssl::AESInitializationVector::createFromData(d_LastSessionIV)));
         ByteVector encData(response.begin(), response.end() - 2 - 8);
 
-        cipher->decipher(encData, data, *symkeySession.get(), *ivSession.get(), false);
+        d_sessionCipher->decipher(encData, data, *symkeySession.get(), *ivSession.get(),
+                                  false);
 
         int i = (int)data.size() - 1;
         for (; i >= 0 && data[i] != 0x80 && data[i] == 0x00; --i)
@@ -425,9 +429,8 @@ ByteVector SAMAV2ISO7816Commands::generateEncIV(bool encrypt) const
     std::shared_ptr<openssl::InitializationVector> iv(
         new openssl::AESInitializationVector(
             openssl::AESInitializationVector::createFromData(d_LastSessionIV)));
-    std::shared_ptr<openssl::OpenSSLSymmetricCipher> cipher(new openssl::AESCipher());
 
-    cipher->cipher(myIV, encIV, *symkeyMac.get(), *iv.get(), false);
+    d_sessionCipher->cipher(myIV, encIV, *symkeyMac.get(), *iv.get(), false);
     return encIV;
 }
 
@@ -446,6 +449,10 @@ ByteVector SAMAV2ISO7816Commands::transmit(ByteVector cmd, bool first, bool last
         {
             fill(d_sessionKey.begin(), d_sessionKey.end(), 0);
             fill(d_macSessionKey.begin(), d_macSessionKey.end(), 0);
+            d_sessionCipher = std::make_shared<openssl::AESCipher>();
+            d_macCipher     = std::make_shared<openssl::AESCipher>();
+            d_macContext =
+                std::make_shared<openssl::CMACContext>(d_macSessionKey, d_macCipher);
             fill(d_LastSessionIV.begin(), d_LastSessionIV.end(), 0);
             fill(d_lastMacIV.begin(), d_lastMacIV.end(), 0);
             throw;
@@ -104,6 +104,21 @@ class LLA_READERS_ISO7816_API SAMAV2ISO7816Commands
 
     ByteVector d_macSessionKey;
 
+    /**
+     * \brief The AES cipher keyed with the session key, renewed on authentication.
+     */
+    std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_sessionCipher;
+
+    /**
+     * \brief The AES cipher keyed with the MAC session key, renewed on authentication.
+     */
+    std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_macCipher;
+
+    /**
+     * \brief The CMAC context of the MAC session key.
+     */
+    std::shared_ptr<openssl::CMACContext> d_macContext;
+
     ByteVector d_lastMacIV;
 
     unsigned int d_cmdCtr;
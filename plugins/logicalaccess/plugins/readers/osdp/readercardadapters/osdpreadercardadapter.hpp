@@ -27,6 +27,12 @@ class LLA_READERS_OSDP_API OSDPReaderCardAdapter : public ISO7816ReaderCardAdapt
 
     ByteVector sendCommand(const ByteVector &command, long timeout = -1) override;
 
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long timeout = -1) override
+    {
+        return sendCommandsInSequence(commands, timeout);
+    }
+
   protected:
     std::shared_ptr<DataTransport> d_dataTransport;
 
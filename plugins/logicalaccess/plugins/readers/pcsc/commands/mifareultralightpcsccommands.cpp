@@ -32,6 +32,30 @@ MifareUltralightPCSCCommands::~MifareUltralightPCSCCommands()
 {
 }
 
+ByteVector MifareUltralightPCSCCommands::readPages(int start_page, int stop_page)
+{
+    if (start_page > stop_page)
+    {
+        THROW_EXCEPTION_WITH_LOG(std::invalid_argument,
+                                 "Start page can't be greater than stop page.");
+    }
+
+    // Every read returns 4 pages.
+    std::vector<ByteVector> commands;
+    for (int page = start_page; page <= stop_page; page += 4)
+    {
+        commands.push_back({0xFF, 0xB0, 0x00, static_cast<unsigned char>(page), 16});
+    }
+
+    ByteVector ret;
+    for (const auto &answer : getPCSCReaderCardAdapter()->sendCommands(commands))
+    {
+        ByteVector data = ISO7816Response(answer).getData();
+        ret.insert(ret.end(), data.begin(), data.end());
+    }
+    return ret;
+}
+
 ByteVector MifareUltralightPCSCCommands::readPage(int page)
 {
     return getPCSCReaderCardAdapter()->sendAPDUCommand(
@@ -45,6 +45,14 @@ class LLA_READERS_PCSC_API MifareUltralightPCSCCommands : public MifareUltraligh
         return std::dynamic_pointer_cast<PCSCReaderCardAdapter>(getReaderCardAdapter());
     }
 
+    /**
+     * \brief Read several pages, batching the reads.
+     * \param start_page The start page.
+     * \param stop_page The stop page.
+     * \return The data read, by blocks of 4 pages.
+     */
+    ByteVector readPages(int start_page, int stop_page) override;
+
     /**
      * \brief Read a whole page.
      * \param sector The page number, from 0 to 15.
@@ -52,28 +52,92 @@ void PCSCDataTransport::send(const ByteVector &data)
                               "is null. We cannot send.");
     if (!data.empty())
     {
-        std::array<uint8_t, 4096> responseBuffer{};
-        ULONG ulNoOfDataReceived = responseBuffer.size();
-        LPCSCARD_IO_REQUEST ior  = nullptr;
-        switch (getPCSCReaderUnit()->getActiveProtocol())
-        {
-        case SCARD_PROTOCOL_T0: ior = SCARD_PCI_T0; break;
+        d_response = transmit(data);
+    }
+}
 
-        case SCARD_PROTOCOL_T1: ior = SCARD_PCI_T1; break;
+ByteVector PCSCDataTransport::transmit(const ByteVector &data)
+{
+    std::array<uint8_t, 4096> responseBuffer{};
+    ULONG ulNoOfDataReceived = responseBuffer.size();
+    LPCSCARD_IO_REQUEST ior  = nullptr;
+    switch (getPCSCReaderUnit()->getActiveProtocol())
+    {
+    case SCARD_PROTOCOL_T0: ior = SCARD_PCI_T0; break;
 
-        case SCARD_PROTOCOL_RAW: ior = SCARD_PCI_RAW; break;
-        default:;
-        }
+    case SCARD_PROTOCOL_T1: ior = SCARD_PCI_T1; break;
+
+    case SCARD_PROTOCOL_RAW: ior = SCARD_PCI_RAW; break;
+    default:;
+    }
+
+    LOG(LogLevel::COMS) << "APDU command: " << BufferHelper::getHex(data);
+
+    unsigned int errorFlag = SCardTransmit(
+        getPCSCReaderUnit()->getHandle(), ior, &data[0],
+        static_cast<DWORD>(data.size()), nullptr, responseBuffer.data(), &ulNoOfDataReceived);
+
+    CheckCardError(errorFlag);
+    return ByteVector(responseBuffer.begin(), responseBuffer.begin() + ulNoOfDataReceived);
+}
+
+std::vector<ByteVector>
+PCSCDataTransport::sendCommands(const std::vector<ByteVector> &commands,
+                                long int /*timeout*/)
+{
+    LLA_LOG_CTX("PCSCDataTransport");
+    std::shared_ptr<PCSCReaderUnit> readerUnit = getPCSCReaderUnit();
+    EXCEPTION_ASSERT_WITH_LOG(readerUnit, LibLogicalAccessException,
+                              "The PCSC reader unit object"
+                              "is null. We cannot send.");
 
-        LOG(LogLevel::COMS) << "APDU command: " << BufferHelper::getHex(data);
+    std::vector<ByteVector> results;
+    results.reserve(commands.size());
 
-        unsigned int errorFlag = SCardTransmit(
-            getPCSCReaderUnit()->getHandle(), ior, &data[0],
-            static_cast<DWORD>(data.size()), nullptr, responseBuffer.data(), &ulNoOfDataReceived);
+    // Hold the card for the whole batch, so other PC/SC clients cannot
+    // interleave their APDUs and the resource manager is not re-entered each time.
+    readerUnit->beginTransaction();
+    try
+    {
+        for (const auto &command : commands)
+        {
+            if (command.empty())
+            {
+                results.emplace_back();
+                continue;
+            }
+            trace(TraceDirection::Command, command);
+            const std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+            results.push_back(transmit(command));
+            d_metrics->recordCommand(command.size(), results.back().size(),
+                                     std::chrono::steady_clock::now() - start);
+            trace(TraceDirection::Response, results.back());
+            LOG(LogLevel::COMS) << "APDU response: " << BufferHelper::getHex(results.back());
+        }
+    }
+    catch (...)
+    {
+        d_metrics->recordError();
+        traceCurrentException();
+        try
+        {
+            readerUnit->endTransaction();
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Cannot end the transaction: " << e.what();
+        }
+        throw;
+    }
+    readerUnit->endTransaction();
 
-        CheckCardError(errorFlag);
-        d_response = ByteVector(responseBuffer.begin(), responseBuffer.begin() + ulNoOfDataReceived);
+    if (!commands.empty())
+    {
+        d_lastCommand = commands.back();
+        d_lastResult  = results.back();
     }
+    return results;
 }
 
 ByteVector PCSCDataTransport::receive(long int /*timeout*/)
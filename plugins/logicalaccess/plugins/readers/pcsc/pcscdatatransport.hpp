@@ -100,7 +100,23 @@ class LLA_READERS_PCSC_API PCSCDataTransport : public DataTransport
 
     ByteVector receive(long int timeout) override;
 
+    /**
+     * \brief Send a batch of independent APDUs within a single card transaction.
+     * \param commands The APDUs.
+     * \param timeout Unused, PC/SC has its own timeouts.
+     * \return The responses, in the commands order.
+     */
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long int timeout = -1) override;
+
   protected:
+    /**
+     * \brief Transmit an APDU to the card.
+     * \param data The APDU.
+     * \return The response.
+     */
+    ByteVector transmit(const ByteVector &data);
+
     bool d_isConnected;
 
     ByteVector d_response;
@@ -270,7 +270,8 @@ bool PCSCReaderUnit::waitInsertion(unsigned int maxwait)
         disconnect();
     }
 
-    if (Settings::getInstance()->SeeWaitInsertionLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    if (settings->SeeWaitInsertionLog)
     {
         LOG(LogLevel::INFOS) << "Waiting card insertion...";
     }
@@ -318,7 +319,7 @@ bool PCSCReaderUnit::waitInsertion(unsigned int maxwait)
         }
         else if (r != SCARD_E_TIMEOUT)
         {
-            if (Settings::getInstance()->SeeWaitInsertionLog)
+            if (settings->SeeWaitInsertionLog)
             {
                 LOG(LogLevel::ERRORS) << "Cannot get status change: " << r << ".";
             }
@@ -353,7 +354,8 @@ bool PCSCReaderUnit::waitRemoval(unsigned int maxwait)
         THROW_EXCEPTION_WITH_LOG(CardException, EXCEPTION_MSG_CONNECTED);
     }
 
-    if (Settings::getInstance()->SeeWaitRemovalLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    if (settings->SeeWaitRemovalLog)
     {
         LOG(LogLevel::INFOS) << "Waiting card removal...";
     }
@@ -450,7 +452,7 @@ bool PCSCReaderUnit::waitRemoval(unsigned int maxwait)
                 {
                     if (r != SCARD_E_TIMEOUT)
                     {
-                        if (Settings::getInstance()->SeeWaitRemovalLog)
+                        if (settings->SeeWaitRemovalLog)
                         {
                             LOG(LogLevel::ERRORS)
                                 << "Cannot get status change: " << r << ".";
@@ -1370,7 +1372,7 @@ PCSCReaderUnit::prepare_poll_parameters()
     if (!getName().empty())
     {
         // use dedicated reader
-        if (Settings::getInstance()->SeeWaitInsertionLog)
+        if (Settings::getSnapshot()->SeeWaitInsertionLog)
         {
             LOG(LogLevel::INFOS) << "Use specific reader: " << getName() << ".";
         }
@@ -15,19 +15,27 @@ PromagBufferParser::getValidBuffer(boost::circular_buffer<unsigned char> &circul
 {
     ByteVector result;
 
+    // Skip noise up to the next frame start instead of dropping everything.
+    size_t skipped = 0;
+    while (!circular_buffer.empty() &&
+           circular_buffer[0] != PromagReaderCardAdapter::STX &&
+           circular_buffer[0] != PromagReaderCardAdapter::ESC &&
+           circular_buffer[0] != PromagReaderCardAdapter::BEL)
+    {
+        circular_buffer.pop_front();
+        ++skipped;
+    }
+    if (skipped > 0)
+    {
+        LOG(LogLevel::WARNINGS) << "Drop " << skipped
+                                << " byte(s). Bad command response. "
+                                   "STX byte doesn't match.";
+    }
+
     if (circular_buffer.size() >= 1)
     {
-        if (circular_buffer[0] != PromagReaderCardAdapter::ESC &&
-            circular_buffer[0] != PromagReaderCardAdapter::BEL)
+        if (circular_buffer[0] == PromagReaderCardAdapter::STX)
         {
-            if (circular_buffer[0] != PromagReaderCardAdapter::STX)
-            {
-                LOG(LogLevel::WARNINGS) << "Drop circular_buffer. Bad command response. "
-                                           "STX byte doesn't match.";
-                circular_buffer.clear();
-                return result;
-            }
-
             for (size_t i = 1; i < circular_buffer.size(); ++i)
             {
                 if (circular_buffer[i] == PromagReaderCardAdapter::CR)
@@ -48,4 +56,4 @@ PromagBufferParser::getValidBuffer(boost::circular_buffer<unsigned char> &circul
     }
     return result;
 }
-}
\ No newline at end of file
+}
@@ -7,6 +7,7 @@
 #include <logicalaccess/plugins/readers/rpleth/rplethdatatransport.hpp>
 #include <logicalaccess/cards/readercardadapter.hpp>
 #include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/readerproviders/lengthprefixbufferparser.hpp>
 #include <logicalaccess/plugins/readers/rpleth/rplethreaderunit.hpp>
 
 #include <boost/foreach.hpp>
@@ -24,6 +25,9 @@ namespace logicalaccess
 RplethDataTransport::RplethDataTransport()
     : TCPDataTransport()
 {
+    // Status, type, command, length, data, XOR checksum.
+    setCircularBufferParser(
+        new LengthPrefixBufferParser(3, 1, 4, 1, true, FrameChecksum::XOR8, 0xff));
 }
 
 RplethDataTransport::~RplethDataTransport()
@@ -74,11 +78,18 @@ void RplethDataTransport::sendPing()
     TCPDataTransport::send(data);
 }
 
+void RplethDataTransport::asyncSendCommand(const ByteVector &command, long int timeout,
+                                           CommandCallback callback)
+{
+    // The Rpleth framing lives in send() and receive(), not in a frame parser.
+    DataTransport::asyncSendCommand(command, timeout, callback);
+}
+
 ByteVector RplethDataTransport::receive(long int timeout)
 {
     ByteVector ret, buf;
     if (timeout == -1)
-        timeout = Settings::getInstance()->DataTransportTimeout;
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
     std::chrono::steady_clock::time_point const clock_timeout =
         std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
 
@@ -154,27 +165,4 @@ std::string RplethDataTransport::getDefaultXmlNodeName() const
 {
     return "RplethDataTransport";
 }
-
-ByteVector RplethDataTransport::sendCommand(const ByteVector &command, long int timeout)
-{
-    LOG(LogLevel::COMS) << "Sending command " << BufferHelper::getHex(command)
-                        << " command size {" << command.size() << "} timeout {" << timeout
-                        << "}...";
-
-    if (timeout == -1)
-        timeout = Settings::getInstance()->DataTransportTimeout;
-
-    d_lastCommand = command;
-    d_lastResult.clear();
-
-    if (command.size() > 0)
-        send(command);
-
-    ByteVector res = receive(timeout);
-    d_lastResult   = res;
-    LOG(LogLevel::COMS) << "Response received successfully ! Reponse: "
-                        << BufferHelper::getHex(res) << " size {" << res.size() << "}";
-
-    return res;
-}
 }
\ No newline at end of file
@@ -67,6 +67,17 @@ class LLA_READERS_RPLETH_API RplethDataTransport : public TCPDataTransport
      */
     ByteVector receive(long int timeout = -1) override;
 
+    /**
+     * \brief Send a command asynchronously through the blocking send() and receive().
+     * \param command The command to send.
+     * \param timeout The time to wait data.
+     * \param callback The callback invoked with the answer or the error.
+     */
+    void asyncSendCommand(const ByteVector &command, long int timeout,
+                          CommandCallback callback) override;
+
+    using TCPDataTransport::asyncSendCommand;
+
     /**
      * \brief Send the Ping packet.
      */
@@ -90,15 +101,25 @@ class LLA_READERS_RPLETH_API RplethDataTransport : public TCPDataTransport
         return d_badges;
     }
 
+  protected:
+    /**
+     * \brief The reader unit connects the transport once for the session.
+     * \return False.
+     */
+    bool connectBeforeCommand() const override
+    {
+        return false;
+    }
+
     /**
-     * \brief Send a command to the reader.
-     * \param command The command buffer.
-     * \param timeout The command timeout. If timeout is -1, use timeout from settings.
-     * \return the result of the command.
+     * \brief The reader pushes badge frames between commands.
+     * \return True.
      */
-    ByteVector sendCommand(const ByteVector &command, long int timeout = -1) override;
+    bool isUnsolicitedDataExpected() const override
+    {
+        return true;
+    }
 
-  protected:
     /**
      * \brief Calculate command checksum.
      * \param data The data to calculate checksum
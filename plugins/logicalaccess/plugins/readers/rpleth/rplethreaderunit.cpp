@@ -111,7 +111,7 @@ bool RplethReaderUnit::waitInsertion(unsigned int maxwait)
         ByteVector answer;
         try
         {
-            auto rpleth_maxwait = maxwait + Settings::getInstance()->DataTransportTimeout;
+            auto rpleth_maxwait = maxwait + Settings::getSnapshot()->DataTransportTimeout;
             answer              = getDefaultRplethReaderCardAdapter()->sendRplethCommand(
                 command, true, rpleth_maxwait);
         }
@@ -217,7 +217,7 @@ bool RplethReaderUnit::waitRemoval(unsigned int maxwait)
             try
             {
                 auto rpleth_maxwait =
-                    maxwait + Settings::getInstance()->DataTransportTimeout;
+                    maxwait + Settings::getSnapshot()->DataTransportTimeout;
                 getDefaultRplethReaderCardAdapter()->sendRplethCommand(command, true,
                                                                        rpleth_maxwait);
                 d_insertedChip.reset();
@@ -14,44 +14,29 @@ ScielBufferParser::getValidBuffer(boost::circular_buffer<unsigned char> &circula
 {
     ByteVector result;
 
-    if (circular_buffer.size() >= 2)
+    // Remove CR/LF (some response have it ?!) and noise before the next STX.
+    size_t skipped = 0;
+    while (!circular_buffer.empty() && circular_buffer[0] != SCIELReaderCardAdapter::STX)
     {
-        // Remove CR/LF (some response have it ?!)
-        while (circular_buffer.size() >= 2 && circular_buffer[0] == 0x0d)
-        {
-            int cuti = 1;
-            if (circular_buffer[1] == 0x0a)
-            {
-                cuti++;
-            }
-            result.assign(circular_buffer.begin() + cuti, circular_buffer.end());
-            circular_buffer.clear();
-            circular_buffer.insert(circular_buffer.end(), result.begin(), result.end());
-            result.clear();
-        }
+        if (circular_buffer[0] != 0x0d && circular_buffer[0] != 0x0a)
+            ++skipped;
+        circular_buffer.pop_front();
+    }
+    if (skipped > 0)
+    {
+        LOG(LogLevel::WARNINGS) << "Drop " << skipped << " byte(s), STX not found";
+    }
 
-        if (circular_buffer.size() >= 2)
+    for (size_t i = 1; i < circular_buffer.size(); ++i)
+    {
+        if (circular_buffer[i] == SCIELReaderCardAdapter::ETX)
         {
-            if (circular_buffer[0] != SCIELReaderCardAdapter::STX)
-            {
-                LOG(LogLevel::WARNINGS) << "Drop circular_buffer, STX not found";
-                circular_buffer.clear();
-                return result;
-            }
-
-            for (size_t i = 1; i < circular_buffer.size(); ++i)
-            {
-                if (circular_buffer[i] == SCIELReaderCardAdapter::ETX)
-                {
-                    result.assign(circular_buffer.begin(),
-                                  circular_buffer.begin() + i + 1);
-                    circular_buffer.erase(circular_buffer.begin(),
-                                          circular_buffer.begin() + i + 1);
-                    break;
-                }
-            }
+            const auto end = circular_buffer.begin() + static_cast<std::ptrdiff_t>(i + 1);
+            result.assign(circular_buffer.begin(), end);
+            circular_buffer.erase(circular_buffer.begin(), end);
+            break;
         }
     }
     return result;
 }
-}
\ No newline at end of file
+}
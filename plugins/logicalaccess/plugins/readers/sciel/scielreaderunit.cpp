@@ -67,11 +67,12 @@ void SCIELReaderUnit::setCardType(std::string cardType)
 
 bool SCIELReaderUnit::waitInsertion(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitInsertionLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
@@ -98,18 +99,19 @@ bool SCIELReaderUnit::waitInsertion(unsigned int maxwait)
     LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted
                          << "} function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return inserted;
 }
 
 bool SCIELReaderUnit::waitRemoval(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitRemovalLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -141,7 +143,7 @@ bool SCIELReaderUnit::waitRemoval(unsigned int maxwait)
                          << "} - function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return removed;
 }
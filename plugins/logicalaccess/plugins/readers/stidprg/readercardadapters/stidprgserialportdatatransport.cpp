@@ -16,6 +16,13 @@ ByteVector STidPRGSerialPortDataTransport::receive(long int /*timeout*/)
     return SerialPortDataTransport::receive(receiveTimeout_);
 }
 
+void STidPRGSerialPortDataTransport::asyncSendCommand(const ByteVector &command,
+                                                      long int /*timeout*/,
+                                                      CommandCallback callback)
+{
+    SerialPortDataTransport::asyncSendCommand(command, receiveTimeout_, callback);
+}
+
 STidPRGSerialPortDataTransport::STidPRGSerialPortDataTransport()
     : receiveTimeout_(3000)
 {
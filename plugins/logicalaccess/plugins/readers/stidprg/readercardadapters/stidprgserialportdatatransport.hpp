@@ -25,6 +25,14 @@ class LLA_READERS_STIDPRG_API STidPRGSerialPortDataTransport
      */
     ByteVector receive(long int timeout) override;
 
+    /**
+     * Like receive(), this overload waits receiveTimeout_ for the answer.
+     */
+    void asyncSendCommand(const ByteVector &command, long int timeout,
+                          CommandCallback callback) override;
+
+    using SerialPortDataTransport::asyncSendCommand;
+
     /**
     * \brief Serialize the current object to XML.
     * \param parentNode The parent node.
@@ -6,6 +6,8 @@
 
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/plugins/readers/stidstr/readercardadapters/stidstrreaderbufferparser.hpp>
+#include <logicalaccess/plugins/readers/stidstr/readercardadapters/stidstrreadercardadapter.hpp>
+#include <logicalaccess/plugins/crypto/tomcrypt.h>
 #include <logicalaccess/bufferhelper.hpp>
 
 namespace logicalaccess
@@ -15,23 +17,47 @@ ByteVector STidSTRBufferParser::getValidBuffer(
 {
     ByteVector result;
 
-    if (circular_buffer.size() >= 7)
+    while (circular_buffer.size() >= 7)
     {
-        unsigned short messageSize = (circular_buffer[1] << 8) | circular_buffer[2];
-        if (circular_buffer.size() >= static_cast<unsigned short>(messageSize + 7))
+        if (circular_buffer[0] != STidSTRReaderCardAdapter::SOF)
         {
-            result.assign(circular_buffer.begin(),
-                          circular_buffer.begin() + messageSize + 7);
-            circular_buffer.erase(circular_buffer.begin(),
-                                  circular_buffer.begin() + messageSize + 7);
-            LOG(LogLevel::COMS)
-                << "Header found with the data: " << BufferHelper::getHex(result)
-                << " Remaining on data on circular buffer: " << circular_buffer.size();
+            LOG(LogLevel::WARNINGS) << "Drop byte 0x" << std::hex
+                                    << static_cast<int>(circular_buffer[0]) << std::dec
+                                    << ", SOF expected.";
+            circular_buffer.pop_front();
+            continue;
         }
-        else
+
+        unsigned short messageSize = (circular_buffer[1] << 8) | circular_buffer[2];
+        size_t frameSize           = static_cast<size_t>(messageSize) + 7;
+        if (circular_buffer.size() < frameSize)
+        {
             LOG(LogLevel::COMS) << "Header found without the data size expected: "
                                 << messageSize;
+            break;
+        }
+
+        const auto end = circular_buffer.begin() + static_cast<std::ptrdiff_t>(frameSize);
+        ByteVector frame(circular_buffer.begin(), end);
+        unsigned char first, second;
+        ComputeCrcCCITT(0xFFFF, &frame[1], 4 + messageSize, &first, &second);
+        if (frame[5 + messageSize] != second || frame[6 + messageSize] != first)
+        {
+            // Not a frame start, most likely a SOF value inside stale data.
+            LOG(LogLevel::WARNINGS) << "CRC mismatch on " << BufferHelper::getHex(frame)
+                                    << ", resynchronizing.";
+            circular_buffer.pop_front();
+            continue;
+        }
+
+        circular_buffer.erase(circular_buffer.begin(), end);
+        result = std::move(frame);
+        LOG(LogLevel::COMS) << "Header found with the data: "
+                            << BufferHelper::getHex(result)
+                            << " Remaining on data on circular buffer: "
+                            << circular_buffer.size();
+        break;
     }
     return result;
 }
-}
\ No newline at end of file
+}
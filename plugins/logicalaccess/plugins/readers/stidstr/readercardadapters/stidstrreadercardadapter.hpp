@@ -84,6 +84,18 @@ class LLA_READERS_STIDSTR_API STidSTRReaderCardAdapter : public ISO7816ReaderCar
     */
     ByteVector sendCommand(const ByteVector &command, long timeout = -1) override;
 
+    /**
+    * \brief Send a batch of commands, one secured exchange at a time.
+    * \param commands The command buffers.
+    * \param timeout The timeout of each command.
+    * \return The results, in the commands order.
+    */
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long timeout = -1) override
+    {
+        return sendCommandsInSequence(commands, timeout);
+    }
+
     /**
      * \brief Calculate the message HMAC.
      * \param buf The message buffer.
@@ -89,11 +89,12 @@ void STidSTRReaderUnit::setCardType(std::string cardType)
 
 bool STidSTRReaderUnit::waitInsertion(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitInsertionLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     auto stidprgdt = std::dynamic_pointer_cast<STidSTRSerialPortDataTransport>(getDataTransport());
@@ -142,25 +143,26 @@ bool STidSTRReaderUnit::waitInsertion(unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
     LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted
                          << "} function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return inserted;
 }
 
 bool STidSTRReaderUnit::waitRemoval(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
+    std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+    bool oldValue                            = settings->IsLogEnabled;
+    if (oldValue && !settings->SeeWaitRemovalLog)
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Disable logs for this part (otherwise too much log output in file)
+        Settings::update([](Settings &s) { s.IsLogEnabled = false; });
     }
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
@@ -205,7 +207,7 @@ bool STidSTRReaderUnit::waitRemoval(unsigned int maxwait)
     }
     catch (...)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
+        Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
         throw;
     }
 
@@ -213,7 +215,7 @@ bool STidSTRReaderUnit::waitRemoval(unsigned int maxwait)
                          << "} - function timeout expired ? {"
                          << (std::chrono::steady_clock::now() < clock_timeout) << "}";
 
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    Settings::update([oldValue](Settings &s) { s.IsLogEnabled = oldValue; });
 
     return removed;
 }
@@ -9,6 +9,10 @@
 #include <logicalaccess/cards/keydiversification.hpp>
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 namespace logicalaccess
 {
 std::shared_ptr<KeyDiversification>
@@ -24,4 +28,63 @@ KeyDiversification::getKeyDiversificationFromType(std::string kdiv)
     }
     return ret;
 }
-}
\ No newline at end of file
+
+std::vector<ByteVector>
+KeyDiversification::getDiversifiedKeys(std::shared_ptr<Key> key,
+                                       const std::vector<ByteVector> &diversify,
+                                       unsigned int threads)
+{
+    std::vector<ByteVector> ret(diversify.size());
+    forEachRange(diversify.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            ret[i] = getDiversifiedKey(key, diversify[i]);
+    });
+    return ret;
+}
+
+void KeyDiversification::forEachRange(size_t count, unsigned int threads,
+                                      const std::function<void(size_t, size_t)> &fn)
+{
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (threads > count)
+    {
+        threads = static_cast<unsigned int>(count);
+    }
+    if (threads <= 1)
+    {
+        if (count > 0)
+            fn(0, count);
+        return;
+    }
+
+    const size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads && t * chunk < count; ++t)
+    {
+        size_t begin = t * chunk;
+        size_t end   = std::min(count, begin + chunk);
+        workers.emplace_back([&, t, begin, end]() {
+            try
+            {
+                fn(begin, end);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    for (const auto &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+}
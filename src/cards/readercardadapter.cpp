@@ -27,7 +27,7 @@ ByteVector ReaderCardAdapter::sendCommand(const ByteVector &command, long timeou
     ByteVector res;
 
     if (timeout == -1)
-        timeout = Settings::getInstance()->DataTransportTimeout;
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
 
     if (d_dataTransport)
     {
@@ -54,6 +54,75 @@ ByteVector ReaderCardAdapter::sendCommand(const ByteVector &command, long timeou
     return res;
 }
 
+std::vector<ByteVector>
+ReaderCardAdapter::sendCommands(const std::vector<ByteVector> &commands, long timeout)
+{
+    std::vector<ByteVector> results;
+
+    if (timeout == -1)
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+    if (d_dataTransport)
+    {
+        std::vector<ByteVector> adapted;
+        adapted.reserve(commands.size());
+        for (const auto &command : commands)
+        {
+            adapted.push_back(adaptCommand(command));
+        }
+
+        std::vector<ByteVector> answers = d_dataTransport->sendCommands(adapted, timeout);
+        EXCEPTION_ASSERT_WITH_LOG(answers.size() == commands.size(),
+                                  LibLogicalAccessException,
+                                  "The data transport did not answer every command.");
+
+        results.reserve(answers.size());
+        for (const auto &answer : answers)
+        {
+            results.push_back(adaptAnswer(answer));
+        }
+
+        if (getResultChecker())
+        {
+            for (auto &res : results)
+            {
+                if (res.size() > 0)
+                {
+                    LOG(LogLevel::DEBUGS) << "Call ResultChecker..."
+                                          << BufferHelper::getHex(res);
+                    getResultChecker()->CheckResult(&res[0], res.size());
+                }
+                else if (!getResultChecker()->AllowEmptyResult())
+                {
+                    THROW_EXCEPTION_WITH_LOG(
+                        LibLogicalAccessException,
+                        "ResultChecker is set but no data has been received !!!")
+                }
+            }
+        }
+    }
+    else
+    {
+        LOG(LogLevel::ERRORS)
+            << "Cannot transmit the commands, data transport is not set!";
+    }
+
+    return results;
+}
+
+std::vector<ByteVector>
+ReaderCardAdapter::sendCommandsInSequence(const std::vector<ByteVector> &commands,
+                                          long timeout)
+{
+    std::vector<ByteVector> results;
+    results.reserve(commands.size());
+    for (const auto &command : commands)
+    {
+        results.push_back(sendCommand(command, timeout));
+    }
+    return results;
+}
+
 ReaderCardAdapter::ReaderCardAdapter()
 {
 }
@@ -262,13 +262,13 @@ void LibraryManager::scanPlugins()
 {
     std::lock_guard<std::recursive_mutex> lg(mutex_);
     boost::filesystem::directory_iterator end_iter;
-    std::string extension = EXTENSION_LIB;
-    Settings *setting     = Settings::getInstance();
-    std::string fctname   = "getLibraryName";
+    std::string extension                   = EXTENSION_LIB;
+    std::shared_ptr<const Settings> setting = Settings::getSnapshot();
+    std::string fctname                     = "getLibraryName";
 
     LOG(LogLevel::PLUGINS) << "Will scan " << setting->PluginFolders.size()
                            << " folders.";
-    for (std::vector<std::string>::iterator it = setting->PluginFolders.begin();
+    for (std::vector<std::string>::const_iterator it = setting->PluginFolders.begin();
          it != setting->PluginFolders.end(); ++it)
     {
         boost::filesystem::path pluginDir(*it);
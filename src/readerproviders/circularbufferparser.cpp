@@ -15,4 +15,23 @@ ByteVector CircularBufferParser::getValidBuffer(
     circular_buffer.clear();
     return result;
 }
-}
\ No newline at end of file
+
+bool CircularBufferParser::isChecksumValid(FrameChecksum checksum,
+                                           const ByteVector &frame)
+{
+    if (checksum == FrameChecksum::NONE)
+        return true;
+    if (frame.empty())
+        return false;
+
+    unsigned char value = 0x00;
+    for (size_t i = 0; i + 1 < frame.size(); ++i)
+    {
+        if (checksum == FrameChecksum::XOR8)
+            value ^= frame[i];
+        else
+            value = static_cast<unsigned char>(value + frame[i]);
+    }
+    return value == frame.back();
+}
+}
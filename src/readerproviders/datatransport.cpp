@@ -11,11 +11,46 @@
 
 namespace logicalaccess
 {
+DataTransport::DataTransport()
+    : d_metrics(std::make_shared<TransportMetrics>())
+{
+}
+
 ByteVector DataTransport::sendCommand(const ByteVector &command, long int timeout)
 {
     if (timeout == -1)
-        timeout = Settings::getInstance()->DataTransportTimeout;
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+    commandStarted(command, timeout);
+
+    ByteVector res;
+    std::chrono::steady_clock::time_point start;
+    try
+    {
+        if (command.size() > 0)
+        {
+            if (connectBeforeCommand())
+                connect();
+
+            start = std::chrono::steady_clock::now();
+            send(command);
+        }
+        else
+            start = std::chrono::steady_clock::now();
 
+        res = receive(timeout);
+    }
+    catch (...)
+    {
+        commandFailed(std::current_exception());
+        throw;
+    }
+    commandCompleted(command, res, std::chrono::steady_clock::now() - start);
+    return res;
+}
+
+void DataTransport::commandStarted(const ByteVector &command, long int timeout)
+{
     LOG(LogLevel::COMS) << "Sending command " << BufferHelper::getHex(command)
                         << " command size {" << command.size() << "} timeout {" << timeout
                         << "}...";
@@ -23,18 +58,107 @@ ByteVector DataTransport::sendCommand(const ByteVector &command, long int timeou
     d_lastCommand = command;
     d_lastResult.clear();
 
-    if (command.size() > 0)
+    trace(TraceDirection::Command, command);
+}
+
+void DataTransport::commandCompleted(const ByteVector &command, const ByteVector &result,
+                                     std::chrono::steady_clock::duration latency)
+{
+    d_metrics->recordCommand(command.size(), result.size(), latency);
+    trace(TraceDirection::Response, result);
+    d_lastResult = result;
+
+    LOG(LogLevel::COMS) << "Response received successfully ! Response: "
+                        << BufferHelper::getHex(result) << " size {" << result.size()
+                        << "}";
+}
+
+void DataTransport::commandFailed(std::exception_ptr eptr)
+{
+    d_metrics->recordError();
+    try
+    {
+        std::rethrow_exception(eptr);
+    }
+    catch (...)
+    {
+        traceCurrentException();
+    }
+}
+
+std::vector<ByteVector> DataTransport::sendCommands(const std::vector<ByteVector> &commands,
+                                                   long int timeout)
+{
+    std::vector<ByteVector> results;
+    results.reserve(commands.size());
+    for (const auto &command : commands)
     {
-        connect();
+        results.push_back(sendCommand(command, timeout));
+    }
+    return results;
+}
+
+void DataTransport::trace(TraceDirection direction, const ByteVector &data) const
+{
+    if (!isTraced())
+        return;
+
+    std::shared_ptr<TraceRecorder> recorder = TraceRecorder::getGlobal();
+    if (recorder)
+        recorder->record(getTransportType() + ":" + getName(), direction, data);
+}
+
+void DataTransport::traceCurrentException() const
+{
+    std::shared_ptr<TraceRecorder> recorder = TraceRecorder::getGlobal();
+    if (!recorder || !isTraced())
+        return;
 
-        send(command);
+    std::string message;
+    try
+    {
+        throw;
     }
+    catch (std::exception &e)
+    {
+        message = e.what();
+    }
+    catch (...)
+    {
+    }
+    recorder->record(getTransportType() + ":" + getName(), TraceDirection::Error,
+                     ByteVector(message.begin(), message.end()));
+}
 
-    ByteVector res = receive(timeout);
-    d_lastResult   = res;
+void DataTransport::asyncSendCommand(const ByteVector &command, long int timeout,
+                                     CommandCallback callback)
+{
+    ByteVector res;
+    std::exception_ptr eptr;
+    try
+    {
+        res = sendCommand(command, timeout);
+    }
+    catch (...)
+    {
+        eptr = std::current_exception();
+    }
 
-    LOG(LogLevel::COMS) << "Response received successfully ! Response: "
-                        << BufferHelper::getHex(res) << " size {" << res.size() << "}";
-    return res;
+    if (callback)
+        callback(res, eptr);
+}
+
+std::future<ByteVector> DataTransport::asyncSendCommand(const ByteVector &command,
+                                                        long int timeout)
+{
+    auto promise = std::make_shared<std::promise<ByteVector>>();
+    asyncSendCommand(command, timeout,
+                     [promise](const ByteVector &res, std::exception_ptr eptr) {
+                         if (eptr)
+                             promise->set_exception(eptr);
+                         else
+                             promise->set_value(res);
+                     });
+    return promise->get_future();
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * \file delimiterbufferparser.cpp
+ * \brief A CircularBufferParser for STX/ETX delimited frames.
+ */
+
+#include <logicalaccess/readerproviders/delimiterbufferparser.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+#include <algorithm>
+
+namespace logicalaccess
+{
+DelimiterBufferParser::DelimiterBufferParser(unsigned char stx, unsigned char etx,
+                                             size_t trailerSize, FrameChecksum checksum)
+    : d_stx(stx)
+    , d_etx(etx)
+    , d_trailerSize(trailerSize)
+    , d_checksum(checksum)
+{
+    EXCEPTION_ASSERT_WITH_LOG(checksum == FrameChecksum::NONE || trailerSize >= 1,
+                              std::invalid_argument,
+                              "The checksum must be part of the trailer.");
+}
+
+ByteVector DelimiterBufferParser::getValidBuffer(
+    boost::circular_buffer<unsigned char> &circular_buffer)
+{
+    ByteVector result;
+
+    while (result.empty())
+    {
+        auto start = std::find(circular_buffer.begin(), circular_buffer.end(), d_stx);
+        if (start != circular_buffer.begin())
+        {
+            LOG(LogLevel::WARNINGS) << "Discarding "
+                                    << std::distance(circular_buffer.begin(), start)
+                                    << " byte(s) received before start of frame.";
+            circular_buffer.erase(circular_buffer.begin(), start);
+        }
+        if (circular_buffer.empty())
+            break;
+
+        auto end = std::find(circular_buffer.begin() + 1, circular_buffer.end(), d_etx);
+        size_t available = static_cast<size_t>(std::distance(end, circular_buffer.end()));
+        if (end == circular_buffer.end() || available <= d_trailerSize)
+            break;
+
+        auto frameEnd = end + 1 + d_trailerSize;
+        result.assign(circular_buffer.begin(), frameEnd);
+        if (isChecksumValid(d_checksum, result))
+        {
+            circular_buffer.erase(circular_buffer.begin(), frameEnd);
+        }
+        else
+        {
+            LOG(LogLevel::WARNINGS) << "Bad frame checksum. Resynchronizing...";
+            result.clear();
+            circular_buffer.pop_front();
+        }
+    }
+    return result;
+}
+}
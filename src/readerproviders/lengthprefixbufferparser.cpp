@@ -0,0 +1,76 @@
+/**
+ * \file lengthprefixbufferparser.cpp
+ * \brief A CircularBufferParser for length prefixed frames.
+ */
+
+#include <logicalaccess/readerproviders/lengthprefixbufferparser.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+namespace logicalaccess
+{
+LengthPrefixBufferParser::LengthPrefixBufferParser(size_t lengthOffset,
+                                                   size_t lengthSize,
+                                                   size_t headerSize,
+                                                   size_t trailerSize, bool bigEndian,
+                                                   FrameChecksum checksum,
+                                                   size_t maxLength)
+    : d_lengthOffset(lengthOffset)
+    , d_lengthSize(lengthSize)
+    , d_headerSize(headerSize)
+    , d_trailerSize(trailerSize)
+    , d_bigEndian(bigEndian)
+    , d_checksum(checksum)
+    , d_maxLength(maxLength)
+{
+    EXCEPTION_ASSERT_WITH_LOG(lengthSize >= 1 && lengthSize <= 4, std::invalid_argument,
+                              "The length field must be 1 to 4 bytes long.");
+    EXCEPTION_ASSERT_WITH_LOG(lengthOffset + lengthSize <= headerSize,
+                              std::invalid_argument,
+                              "The length field must be part of the header.");
+    EXCEPTION_ASSERT_WITH_LOG(checksum == FrameChecksum::NONE || trailerSize >= 1,
+                              std::invalid_argument,
+                              "The checksum must be part of the trailer.");
+}
+
+ByteVector LengthPrefixBufferParser::getValidBuffer(
+    boost::circular_buffer<unsigned char> &circular_buffer)
+{
+    ByteVector result;
+
+    while (circular_buffer.size() >= d_headerSize)
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < d_lengthSize; ++i)
+        {
+            size_t pos = d_bigEndian ? d_lengthOffset + i
+                                     : d_lengthOffset + d_lengthSize - 1 - i;
+            length = (length << 8) | circular_buffer[pos];
+        }
+
+        if (length <= d_maxLength)
+        {
+            size_t frameSize = d_headerSize + length + d_trailerSize;
+            if (circular_buffer.size() < frameSize)
+                break;
+
+            result.assign(circular_buffer.begin(), circular_buffer.begin() + frameSize);
+            if (isChecksumValid(d_checksum, result))
+            {
+                circular_buffer.erase(circular_buffer.begin(),
+                                      circular_buffer.begin() + frameSize);
+                break;
+            }
+            result.clear();
+            LOG(LogLevel::WARNINGS) << "Bad frame checksum. Resynchronizing...";
+        }
+        else
+        {
+            LOG(LogLevel::WARNINGS) << "Invalid frame length " << length
+                                    << ". Resynchronizing...";
+        }
+        circular_buffer.pop_front();
+    }
+    return result;
+}
+}
@@ -0,0 +1,177 @@
+/**
+ * \file replaydatatransport.cpp
+ * \brief Data transport replaying a recorded trace.
+ */
+
+#include <logicalaccess/readerproviders/replaydatatransport.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace logicalaccess
+{
+ReplayDataTransport::ReplayDataTransport()
+    : d_strict(true)
+    , d_connected(false)
+    , d_position(0)
+    , d_commandSent(false)
+{
+}
+
+ReplayDataTransport::ReplayDataTransport(const std::string &filename,
+                                         const std::string &transport)
+    : ReplayDataTransport()
+{
+    d_transportFilter = transport;
+    setTraceFile(filename);
+}
+
+bool ReplayDataTransport::connect()
+{
+    d_connected = true;
+    return true;
+}
+
+void ReplayDataTransport::disconnect()
+{
+    d_connected = false;
+}
+
+bool ReplayDataTransport::isConnected()
+{
+    return d_connected;
+}
+
+std::string ReplayDataTransport::getName() const
+{
+    return d_filename;
+}
+
+void ReplayDataTransport::setTraceFile(const std::string &filename)
+{
+    TraceReader reader(filename);
+    d_filename = filename;
+    d_records  = reader.getRecords();
+    rewind();
+}
+
+std::string ReplayDataTransport::getTraceFile() const
+{
+    return d_filename;
+}
+
+void ReplayDataTransport::setTransportFilter(const std::string &transport)
+{
+    d_transportFilter = transport;
+    rewind();
+}
+
+std::string ReplayDataTransport::getTransportFilter() const
+{
+    return d_transportFilter;
+}
+
+void ReplayDataTransport::setStrict(bool strict)
+{
+    d_strict = strict;
+}
+
+bool ReplayDataTransport::isStrict() const
+{
+    return d_strict;
+}
+
+void ReplayDataTransport::rewind()
+{
+    d_position    = 0;
+    d_commandSent = false;
+}
+
+bool ReplayDataTransport::isFinished() const
+{
+    for (size_t i = d_position; i < d_records.size(); ++i)
+    {
+        if (d_records[i].direction == TraceDirection::Command &&
+            (d_transportFilter.empty() || d_records[i].transport == d_transportFilter))
+            return false;
+    }
+    return true;
+}
+
+const TraceRecord *ReplayDataTransport::nextRecord()
+{
+    while (d_position < d_records.size())
+    {
+        const TraceRecord &record = d_records[d_position++];
+        if (d_transportFilter.empty() || record.transport == d_transportFilter)
+            return &record;
+    }
+    return nullptr;
+}
+
+void ReplayDataTransport::send(const ByteVector &data)
+{
+    const TraceRecord *record = nextRecord();
+    EXCEPTION_ASSERT_WITH_LOG(record && record->direction == TraceDirection::Command,
+                              LibLogicalAccessException,
+                              "No more recorded command to replay.");
+    if (d_strict && record->data != data)
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Replayed command " + BufferHelper::getHex(data) +
+                                     " differs from the recorded one " +
+                                     BufferHelper::getHex(record->data) + ".");
+    }
+    d_commandSent = true;
+}
+
+ByteVector ReplayDataTransport::receive(long int /*timeout*/)
+{
+    if (!d_commandSent)
+    {
+        // A receive without command was recorded with an empty command.
+        const TraceRecord *command = nextRecord();
+        EXCEPTION_ASSERT_WITH_LOG(command && command->direction == TraceDirection::Command,
+                                  LibLogicalAccessException,
+                                  "No more recorded command to replay.");
+    }
+    d_commandSent = false;
+
+    const TraceRecord *record = nextRecord();
+    EXCEPTION_ASSERT_WITH_LOG(record && record->direction != TraceDirection::Command,
+                              LibLogicalAccessException,
+                              "No recorded response for the replayed command.");
+    if (record->direction == TraceDirection::Error)
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 std::string(record->data.begin(), record->data.end()));
+    }
+    return record->data;
+}
+
+void ReplayDataTransport::serialize(boost::property_tree::ptree &parentNode)
+{
+    boost::property_tree::ptree node;
+
+    node.put("<xmlattr>.type", getTransportType());
+    node.put("TraceFile", d_filename);
+    node.put("Transport", d_transportFilter);
+    node.put("Strict", d_strict);
+
+    parentNode.add_child(getDefaultXmlNodeName(), node);
+}
+
+void ReplayDataTransport::unSerialize(boost::property_tree::ptree &node)
+{
+    d_transportFilter = node.get<std::string>("Transport", "");
+    d_strict          = node.get<bool>("Strict", true);
+    setTraceFile(node.get_child("TraceFile").get_value<std::string>());
+}
+
+std::string ReplayDataTransport::getDefaultXmlNodeName() const
+{
+    return "ReplayDataTransport";
+}
+}
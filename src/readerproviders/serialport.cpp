@@ -9,6 +9,7 @@
 #include <logicalaccess/readerproviders/serialport.hpp>
 #include <logicalaccess/bufferhelper.hpp>
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_serial_port.hpp>
 #include <boost/bind/bind.hpp>
@@ -195,11 +196,19 @@ void SerialPort::do_read(const boost::system::error_code &error,
     cond_var_mutex_.lock();
     if (m_circular_read_buffer.reserve() < bytes_transferred)
     {
-        LOG(LogLevel::WARNINGS)
-            << "Buffer Overflow, Size: " << m_circular_read_buffer.size()
-            << " reserve: " << m_circular_read_buffer.reserve()
-            << " bytes transferred: " << bytes_transferred;
-        m_circular_read_buffer.clear();
+        // Grow while the consumer lags behind, up to the maximum size.
+        m_circular_read_buffer.set_capacity(std::min<size_t>(
+            std::max(m_circular_read_buffer.capacity() * 2,
+                     m_circular_read_buffer.size() + bytes_transferred),
+            SERIAL_MAX_READ_BUFFER_SIZE));
+        if (m_circular_read_buffer.reserve() < bytes_transferred)
+        {
+            // Inserting into the full buffer overwrites its oldest bytes.
+            LOG(LogLevel::WARNINGS)
+                << "Buffer Overflow, dropping "
+                << bytes_transferred - m_circular_read_buffer.reserve()
+                << " bytes without a valid frame.";
+        }
     }
     m_circular_read_buffer.insert(m_circular_read_buffer.end(), m_read_buffer.begin(),
                                   m_read_buffer.begin() + bytes_transferred);
@@ -211,6 +220,8 @@ void SerialPort::do_read(const boost::system::error_code &error,
                          << " Size: " << bytes_transferred;
 
     data_flag_ = true;
+    if (m_data_handler)
+        m_data_handler();
     cond_var_mutex_.unlock();
     cond_var_.notify_all();
 
@@ -269,4 +280,10 @@ void SerialPort::dataConsumed()
 {
     data_flag_ = false;
 }
+
+void SerialPort::setDataHandler(std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> lg(cond_var_mutex_);
+    m_data_handler = handler;
+}
 }
\ No newline at end of file
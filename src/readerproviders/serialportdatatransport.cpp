@@ -12,10 +12,17 @@
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace logicalaccess
 {
 SerialPortDataTransport::SerialPortDataTransport(const std::string &portname)
     : d_isAutoDetected(false)
+    , d_asyncRunning(false)
+    , d_asyncAborted(false)
 {
     d_port.reset(new SerialPortXml(portname));
     d_portBaudRate = 9600;
@@ -102,14 +109,155 @@ ByteVector SerialPortDataTransport::receive(long int timeout)
 
     } while (std::chrono::steady_clock::now() < clock_timeout && res.size() == 0x00);
 
+    if (res.empty())
+        d_metrics->recordTimeout();
+
     LOG(LogLevel::COMS) << "Command response: " << BufferHelper::getHex(res);
 
     return res;
 }
 
+void SerialPortDataTransport::asyncSendCommand(const ByteVector &command,
+                                               long int timeout, CommandCallback callback)
+{
+    if (timeout == -1)
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+    std::call_once(d_asyncInit, [this]() {
+        boost::asio::io_service &ios = TransportReactor::getInstance()->getIOService();
+        d_ioStrand.reset(new boost::asio::io_service::strand(ios));
+        d_timer.reset(new boost::asio::deadline_timer(ios));
+        d_asyncCommands.reset(new AsyncCommandQueue(
+            *d_ioStrand,
+            [this](const AsyncCommandQueue::Command &cmd) { asyncStart(cmd); },
+            [this]() { asyncAbort(); }));
+    });
+
+    if (command.size() > 0 && !isConnected())
+    {
+        // Opening and configuring the port may block, do it before queuing.
+        try
+        {
+            connect();
+        }
+        catch (...)
+        {
+            std::exception_ptr eptr = std::current_exception();
+            commandFailed(eptr);
+            TransportReactor::getInstance()->start();
+            TransportReactor::getInstance()->getCommandService().post(
+                [callback, eptr]() { callback(ByteVector(), eptr); });
+            return;
+        }
+    }
+    d_asyncCommands->push(command, timeout, callback);
+}
+
+void SerialPortDataTransport::asyncStart(const AsyncCommandQueue::Command &command)
+{
+    d_asyncCommand = command.command;
+    d_asyncAborted = false;
+    d_asyncResult.clear();
+    commandStarted(d_asyncCommand, command.timeout);
+    d_asyncSendTime = std::chrono::steady_clock::now();
+
+    d_asyncPort = d_port->getSerialPort();
+    if (!d_asyncPort->isOpen())
+    {
+        std::exception_ptr eptr = std::make_exception_ptr(
+            LibLogicalAccessException("The serial port is not open."));
+        commandFailed(eptr);
+        d_asyncCommands->complete(ByteVector(), eptr);
+        return;
+    }
+
+    try
+    {
+        send(d_asyncCommand);
+    }
+    catch (...)
+    {
+        std::exception_ptr eptr = std::current_exception();
+        commandFailed(eptr);
+        d_asyncCommands->complete(ByteVector(), eptr);
+        return;
+    }
+    d_asyncRunning = true;
+    d_asyncPort->setDataHandler(
+        [this]() { d_asyncCommands->post([this]() { asyncRead(); }); });
+
+    boost::system::error_code ec;
+    d_timer->expires_from_now(boost::posix_time::milliseconds(command.timeout), ec);
+    d_timer->async_wait(d_asyncCommands->wrap([this](const boost::system::error_code &) {
+        if (d_asyncRunning)
+        {
+            // Expired, or aborted: no answer in time.
+            d_asyncRunning = false;
+            d_asyncPort->setDataHandler(nullptr);
+            if (!d_asyncAborted)
+                d_metrics->recordTimeout();
+        }
+
+        if (d_asyncAborted)
+        {
+            std::exception_ptr eptr = std::make_exception_ptr(
+                LibLogicalAccessException("The transport was closed."));
+            commandFailed(eptr);
+            d_asyncCommands->complete(ByteVector(), eptr);
+            return;
+        }
+
+        LOG(LogLevel::COMS) << "Command response: "
+                            << BufferHelper::getHex(d_asyncResult);
+        commandCompleted(d_asyncCommand, d_asyncResult,
+                         std::chrono::steady_clock::now() - d_asyncSendTime);
+        d_asyncCommands->complete(d_asyncResult, std::exception_ptr());
+    }));
+
+    // The answer may have arrived already.
+    asyncRead();
+}
+
+void SerialPortDataTransport::asyncAbort()
+{
+    d_asyncAborted = true;
+    boost::system::error_code ec;
+    d_timer->cancel(ec);
+}
+
+void SerialPortDataTransport::asyncRead()
+{
+    if (!d_asyncRunning)
+        return;
+
+    try
+    {
+        d_asyncPort->lockedExecute([&]() {
+            if (d_asyncPort->read(d_asyncResult) == 0)
+                d_asyncPort->dataConsumed();
+        });
+    }
+    catch (std::exception &e)
+    {
+        // Like a blocking receive() after a bad frame: keep waiting until the timeout.
+        LOG(LogLevel::WARNINGS) << "Cannot read the serial port answer: " << e.what();
+        d_asyncResult.clear();
+    }
+    if (d_asyncResult.size() > 0)
+        asyncFinish();
+}
+
+void SerialPortDataTransport::asyncFinish()
+{
+    d_asyncRunning = false;
+    d_asyncPort->setDataHandler(nullptr);
+    boost::system::error_code ec;
+    d_timer->cancel(ec);
+}
+
 void SerialPortDataTransport::configure() const
 {
-    configure(d_port, Settings::getInstance()->IsConfigurationRetryEnabled);
+    configure(d_port, Settings::getSnapshot()->IsConfigurationRetryEnabled);
 }
 
 void SerialPortDataTransport::configure(std::shared_ptr<SerialPortXml> port,
@@ -142,83 +290,165 @@ void SerialPortDataTransport::configure(std::shared_ptr<SerialPortXml> port,
             // Strange stuff is going here... by waiting and reopening the COM port (maybe
             // for system cleanup), it's working !
             std::string portn = port->getSerialPort()->deviceName();
+            const long int retryTimeout =
+                Settings::getSnapshot()->ConfigurationRetryTimeout;
             LOG(LogLevel::WARNINGS) << "Exception received " << e.what() << " ! Sleeping "
-                                    << Settings::getInstance()->ConfigurationRetryTimeout
+                                    << retryTimeout
                                     << " milliseconds -> Reopen serial port " << portn
                                     << " -> Finally retry  to configure...";
-            std::this_thread::sleep_for(std::chrono::milliseconds(
-                Settings::getInstance()->ConfigurationRetryTimeout));
+            std::this_thread::sleep_for(std::chrono::milliseconds(retryTimeout));
 
             port->getSerialPort()->reopen();
+            d_metrics->recordReconnect();
             configure(port, false);
         }
     }
 }
 
+/**
+ * \brief Serial ports found by auto-detection, by transport type.
+ */
+static std::mutex s_detectedPortsMutex;
+static std::map<std::string, std::string> s_detectedPorts;
+
+void SerialPortDataTransport::clearAutoDetectCache()
+{
+    std::lock_guard<std::mutex> lg(s_detectedPortsMutex);
+    s_detectedPorts.clear();
+}
+
+bool SerialPortDataTransport::probePort(std::shared_ptr<SerialPortXml> port,
+                                        const ByteVector &cmd,
+                                        std::shared_ptr<CircularBufferParser> parser,
+                                        long int timeout,
+                                        const std::atomic<bool> &cancelled) const
+{
+    bool answered = false;
+    std::shared_ptr<SerialPort> serialPort = port->getSerialPort();
+    try
+    {
+        LOG(LogLevel::INFOS) << "Processing port " << serialPort->deviceName() << "...";
+        serialPort->open();
+        configure(port, false);
+        if (parser)
+            serialPort->setCircularBufferParser(parser);
+
+        serialPort->write(cmd);
+        const std::chrono::steady_clock::time_point until =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        ByteVector res;
+        while (!cancelled && res.empty() && std::chrono::steady_clock::now() < until)
+        {
+            // Short waits, so a probe stops soon after another port answered.
+            serialPort->waitMoreData(
+                std::min(until, std::chrono::steady_clock::now() +
+                                    std::chrono::milliseconds(50)),
+                [&]() {
+                    if (serialPort->read(res) == 0)
+                        serialPort->dataConsumed();
+                });
+        }
+        answered = !res.empty();
+    }
+    catch (std::exception &e)
+    {
+        LOG(LogLevel::ERRORS) << "Exception " << e.what();
+    }
+
+    if (serialPort->isOpen())
+    {
+        serialPort->close();
+    }
+    return answered;
+}
+
 void SerialPortDataTransport::startAutoDetect()
 {
     if (d_port && d_port->getSerialPort()->deviceName() == "")
     {
-        if (!Settings::getInstance()->IsAutoDetectEnabled)
+        std::shared_ptr<const Settings> settings = Settings::getSnapshot();
+        if (!settings->IsAutoDetectEnabled)
         {
             LOG(LogLevel::INFOS) << "Auto detection is disabled through settings !";
             return;
         }
 
+        if (!getReaderUnit())
+            return;
+
+        ByteVector cmd = getReaderUnit()->getPingCommand();
+        if (cmd.size() == 0)
+            return;
+
+        std::shared_ptr<ReaderCardAdapter> rca =
+            getReaderUnit()->getDefaultReaderCardAdapter();
+        ByteVector wrappedcmd = rca->adaptCommand(cmd);
+        std::shared_ptr<CircularBufferParser> parser =
+            d_port->getSerialPort()->getCircularBufferParser();
+        const long int timeout      = settings->AutoDetectionTimeout;
+        std::atomic<bool> cancelled(false);
+
+        std::string cachedPort;
+        {
+            std::lock_guard<std::mutex> lg(s_detectedPortsMutex);
+            auto it = s_detectedPorts.find(getTransportType());
+            if (it != s_detectedPorts.end())
+                cachedPort = it->second;
+        }
+        if (!cachedPort.empty())
+        {
+            LOG(LogLevel::INFOS) << "Checking previously detected port " << cachedPort
+                                 << "...";
+            std::shared_ptr<SerialPortXml> port(new SerialPortXml(cachedPort));
+            if (probePort(port, wrappedcmd, parser, timeout, cancelled))
+            {
+                LOG(LogLevel::INFOS) << "Reader found ! Using this COM port !";
+                setSerialPort(port);
+                d_isAutoDetected = true;
+                return;
+            }
+        }
+
         LOG(LogLevel::INFOS)
             << "Serial port is empty ! Starting Auto COM Port Detection...";
         std::vector<std::shared_ptr<SerialPortXml>> ports;
-        if (SerialPortXml::EnumerateUsingCreateFile(ports) && !ports.empty() &&
-            getReaderUnit())
+        if (SerialPortXml::EnumerateUsingCreateFile(ports) && !ports.empty())
         {
-            ByteVector cmd = getReaderUnit()->getPingCommand();
-            if (cmd.size() > 0)
+            std::mutex foundMutex;
+            std::shared_ptr<SerialPortXml> found;
+            std::vector<std::thread> probes;
+            for (const auto &port : ports)
             {
-                std::shared_ptr<ReaderCardAdapter> rca =
-                    getReaderUnit()->getDefaultReaderCardAdapter();
-                ByteVector wrappedcmd = rca->adaptCommand(cmd);
-                bool found            = false;
-                for (std::vector<std::shared_ptr<SerialPortXml>>::iterator i =
-                         ports.begin();
-                     i != ports.end() && !found; ++i)
-                {
-                    try
+                probes.emplace_back([&, port]() {
+                    if (probePort(port, wrappedcmd, parser, timeout, cancelled))
                     {
-                        LOG(LogLevel::INFOS) << "Processing port "
-                                             << (*i)->getSerialPort()->deviceName()
-                                             << "...";
-                        (*i)->getSerialPort()->open();
-                        configure((*i), false);
-
-                        d_port       = (*i);
-                        ByteVector r = sendCommand(
-                            wrappedcmd, Settings::getInstance()->AutoDetectionTimeout);
-                        if (r.size() > 0)
+                        std::lock_guard<std::mutex> lg(foundMutex);
+                        if (!found)
                         {
-                            LOG(LogLevel::INFOS)
-                                << "Reader found ! Using this COM port !";
-                            found = true;
+                            found     = port;
+                            cancelled = true;
                         }
                     }
-                    catch (std::exception &e)
-                    {
-                        LOG(LogLevel::ERRORS) << "Exception " << e.what();
-                    }
+                });
+            }
+            for (auto &probe : probes)
+                probe.join();
 
-                    if ((*i)->getSerialPort()->isOpen())
-                    {
-                        (*i)->getSerialPort()->close();
-                    }
-                }
-
-                if (!found)
-                {
-                    LOG(LogLevel::INFOS) << "No reader found on COM port...";
-                }
-                else
-                {
-                    d_isAutoDetected = true;
-                }
+            if (!found)
+            {
+                LOG(LogLevel::INFOS) << "No reader found on COM port...";
+            }
+            else
+            {
+                LOG(LogLevel::INFOS) << "Reader found on "
+                                     << found->getSerialPort()->deviceName()
+                                     << " ! Using this COM port !";
+                setSerialPort(found);
+                d_isAutoDetected = true;
+
+                std::lock_guard<std::mutex> lg(s_detectedPortsMutex);
+                s_detectedPorts[getTransportType()] =
+                    found->getSerialPort()->deviceName();
             }
         }
         else
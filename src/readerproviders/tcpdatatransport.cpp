@@ -6,6 +6,7 @@
 
 #include <logicalaccess/myexception.hpp>
 #include <logicalaccess/readerproviders/tcpdatatransport.hpp>
+#include <logicalaccess/readerproviders/transportreactor.hpp>
 #include <logicalaccess/cards/readercardadapter.hpp>
 #include <logicalaccess/bufferhelper.hpp>
 #include <logicalaccess/boost_version_types.hpp>
@@ -17,15 +18,35 @@
 #include <boost/property_tree/ptree.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 
+#include <algorithm>
+
 namespace logicalaccess
 {
 TCPDataTransport::TCPDataTransport()
-    : d_socket(d_ios)
-    , d_timer(d_ios)
+    : d_ioStrand(TransportReactor::getInstance()->getIOService())
+    , d_socket(TransportReactor::getInstance()->getIOService())
+    , d_timer(TransportReactor::getInstance()->getIOService())
     , d_read_error(true)
     , d_bytes_transferred(0)
+    , d_persistentConnection(false)
+    , d_healthCheckInterval(0)
+    , d_pipelining(false)
+    , d_receiveBuffer(TCP_READ_CHUNK_SIZE)
+    , d_readBuffer(TCP_READ_CHUNK_SIZE)
     , d_ipAddress("127.0.0.1")
     , d_port(9559)
+    , d_asyncTimeout(0)
+    , d_asyncStep(AsyncStep::Connect)
+    , d_asyncWaiting(0)
+    , d_asyncTransferred(0)
+    , d_asyncTimedOut(false)
+    , d_asyncAborted(false)
+    , d_asyncFirstRead(true)
+    , d_asyncCommands(d_ioStrand,
+                      [this](const AsyncCommandQueue::Command &command) {
+                          asyncStart(command);
+                      },
+                      [this]() { asyncAbort(); })
 {
 }
 
@@ -53,36 +74,147 @@ void TCPDataTransport::setPort(int port)
     d_port = port;
 }
 
+bool TCPDataTransport::isPersistentConnection() const
+{
+    return d_persistentConnection;
+}
+
+void TCPDataTransport::setPersistentConnection(bool persistent)
+{
+    d_persistentConnection = persistent;
+}
+
+long int TCPDataTransport::getHealthCheckInterval() const
+{
+    return d_healthCheckInterval;
+}
+
+void TCPDataTransport::setHealthCheckInterval(long int interval)
+{
+    d_healthCheckInterval = interval;
+}
+
+bool TCPDataTransport::isPipelining() const
+{
+    return d_pipelining;
+}
+
+void TCPDataTransport::setPipelining(bool pipelining)
+{
+    d_pipelining = pipelining;
+}
+
+std::vector<ByteVector> TCPDataTransport::sendCommands(const std::vector<ByteVector> &commands,
+                                                       long int timeout)
+{
+    if (!d_pipelining || !d_circular_buffer_parser)
+        return DataTransport::sendCommands(commands, timeout);
+
+    if (timeout == -1)
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+
+    LOG(LogLevel::COMS) << "Pipelining " << commands.size() << " command(s)...";
+
+    ByteVector batch;
+    size_t expected = 0;
+    for (const auto &command : commands)
+    {
+        batch.insert(batch.end(), command.begin(), command.end());
+        if (command.size() > 0)
+            ++expected;
+    }
+
+    std::vector<ByteVector> results;
+    results.reserve(commands.size());
+    try
+    {
+        if (expected > 0 && connectBeforeCommand())
+            connect();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (expected > 0)
+            send(batch);
+
+        // Frames come back in order, receive() keeps any extra frame buffered.
+        for (const auto &command : commands)
+        {
+            trace(TraceDirection::Command, command);
+            results.push_back(command.size() > 0 ? receive(timeout) : ByteVector());
+            d_metrics->recordCommand(command.size(), results.back().size(),
+                                     std::chrono::steady_clock::now() - start);
+            trace(TraceDirection::Response, results.back());
+        }
+    }
+    catch (...)
+    {
+        d_metrics->recordError();
+        traceCurrentException();
+        throw;
+    }
+
+    if (!commands.empty())
+    {
+        d_lastCommand = commands.back();
+        d_lastResult  = results.back();
+    }
+    return results;
+}
+
 bool TCPDataTransport::connect()
 {
-    return connect(Settings::getInstance()->DataTransportTimeout);
+    return connect(Settings::getSnapshot()->DataTransportTimeout);
 }
 
 bool TCPDataTransport::connect(long int timeout)
 {
+    if (d_persistentConnection &&
+        d_lastActivity != std::chrono::steady_clock::time_point())
+    {
+        // The persistent connection was established before, reopening is a reconnect.
+        if (d_socket.is_open() && checkConnection(timeout))
+            return true;
+        d_metrics->recordReconnect();
+    }
+
     if (d_socket.is_open())
-        d_socket.close();
+    {
+        boost::system::error_code ec;
+        d_socket.close(ec);
+    }
 
     try
     {
-        d_ios.reset();
-        d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
-        d_timer.async_wait(boost::bind(&TCPDataTransport::time_out, this,
-                                       boost::asio::placeholders::error));
-
         boost::asio::ip::tcp::endpoint endpoint(BOOST_ASIO_MAKE_ADDRESS(getIpAddress()),
                                                 getPort());
-        d_socket.async_connect(endpoint,
-                               boost::bind(&TCPDataTransport::connect_complete, this,
-                                           boost::asio::placeholders::error));
-
-        d_ios.run();
 
+        d_handlers.run(d_ioStrand, 2, [this, endpoint, timeout]() {
+            boost::system::error_code ec;
+            d_timer.expires_from_now(boost::posix_time::milliseconds(timeout), ec);
+            d_timer.async_wait(d_ioStrand.wrap(boost::bind(
+                &TCPDataTransport::time_out, this, boost::asio::placeholders::error)));
+            d_socket.async_connect(
+                endpoint, d_ioStrand.wrap(boost::bind(&TCPDataTransport::connect_complete,
+                                                      this,
+                                                      boost::asio::placeholders::error)));
+        });
+
+        d_receiveBuffer.clear();
         if (d_read_error)
+        {
+            LOG(LogLevel::ERRORS) << "Cannot establish connection on " << getIpAddress()
+                                  << ":" << getPort() << ".";
             d_socket.close();
-
-        LOG(LogLevel::INFOS) << "Connected to " << getIpAddress() << " on port "
-                             << getPort() << ".";
+        }
+        else
+        {
+            if (d_persistentConnection)
+            {
+                d_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+                d_socket.set_option(boost::asio::socket_base::keep_alive(true));
+            }
+            d_lastActivity = std::chrono::steady_clock::now();
+            LOG(LogLevel::INFOS) << "Connected to " << getIpAddress() << " on port "
+                                 << getPort() << ".";
+        }
     }
     catch (boost::system::system_error &ex)
     {
@@ -94,6 +226,90 @@ bool TCPDataTransport::connect(long int timeout)
     return bool(d_socket.is_open());
 }
 
+bool TCPDataTransport::checkConnection(long int timeout)
+{
+    if (!checkSocket())
+        return false;
+
+    if (d_healthCheckInterval > 0 &&
+        std::chrono::steady_clock::now() - d_lastActivity >
+            std::chrono::milliseconds(d_healthCheckInterval))
+    {
+        return probeConnection(timeout);
+    }
+
+    return true;
+}
+
+bool TCPDataTransport::checkSocket()
+{
+    boost::system::error_code ec, ignored;
+    ByteVector stale(256);
+    size_t len;
+
+    d_socket.non_blocking(true, ignored);
+    if (isUnsolicitedDataExpected())
+    {
+        // Only peek: pending bytes belong to the reader, receive() reads them later.
+        len = d_socket.receive(boost::asio::buffer(stale),
+                               boost::asio::socket_base::message_peek, ec);
+        if (!ec && len > 0)
+            ec = boost::asio::error::would_block;
+    }
+    else
+    {
+        d_receiveBuffer.clear();
+        do
+        {
+            len = d_socket.receive(boost::asio::buffer(stale), 0, ec);
+            if (!ec && len > 0)
+            {
+                LOG(LogLevel::COMS) << "TCP Discard stale data: "
+                                    << BufferHelper::getHex(ByteVector(
+                                           stale.begin(), stale.begin() + len));
+            }
+        } while (!ec && len > 0);
+    }
+    d_socket.non_blocking(false, ignored);
+
+    if (ec != boost::asio::error::would_block)
+    {
+        LOG(LogLevel::INFOS) << "Persistent connection to " << getIpAddress() << ":"
+                             << getPort() << " lost (" << ec.message()
+                             << "). Reconnecting...";
+        return false;
+    }
+
+    return true;
+}
+
+bool TCPDataTransport::probeConnection(long int timeout)
+{
+    std::shared_ptr<ReaderUnit> readerUnit = getReaderUnit();
+    if (!readerUnit)
+        return true;
+
+    ByteVector cmd = readerUnit->getPingCommand();
+    if (cmd.size() == 0)
+        return true;
+
+    std::shared_ptr<ReaderCardAdapter> rca = readerUnit->getDefaultReaderCardAdapter();
+    if (rca)
+        cmd = rca->adaptCommand(cmd);
+
+    try
+    {
+        send(cmd);
+        return receive(timeout).size() > 0;
+    }
+    catch (std::exception &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Health probe failed on " << getIpAddress() << ":"
+                                << getPort() << " : " << e.what();
+    }
+    return false;
+}
+
 void TCPDataTransport::disconnect()
 {
     LOG(LogLevel::INFOS) << getIpAddress() << ":" << getPort() << "Disconnected.";
@@ -118,6 +334,7 @@ void TCPDataTransport::send(const ByteVector &data)
         {
             LOG(LogLevel::COMS) << "TCP Send Data: " << BufferHelper::getHex(data);
             d_socket.send(boost::asio::buffer(data));
+            d_lastActivity = std::chrono::steady_clock::now();
         }
         catch (boost::system::system_error &ex)
         {
@@ -134,7 +351,9 @@ void TCPDataTransport::connect_complete(const boost::system::error_code &error)
 {
     // 0 is success.
     d_read_error = static_cast<bool>(error.value());
-    d_timer.cancel();
+    boost::system::error_code ec;
+    d_timer.cancel(ec);
+    d_handlers.completed();
 }
 
 void TCPDataTransport::read_complete(const boost::system::error_code &error,
@@ -142,44 +361,370 @@ void TCPDataTransport::read_complete(const boost::system::error_code &error,
 {
     d_read_error        = (error || bytes_transferred == 0);
     d_bytes_transferred = bytes_transferred;
-    d_timer.cancel();
+    d_last_error        = error;
+    boost::system::error_code ec;
+    d_timer.cancel(ec);
+    d_handlers.completed();
 }
 
 void TCPDataTransport::time_out(const boost::system::error_code &error)
 {
-    if (error)
-        return;
-    d_socket.cancel();
+    if (!error)
+    {
+        boost::system::error_code ec;
+        d_socket.cancel(ec);
+    }
+    d_handlers.completed();
 }
 
-ByteVector TCPDataTransport::receive(long int timeout)
+size_t TCPDataTransport::receiveSome(long int timeout)
 {
-    ByteVector recv(256);
-    d_ios.reset();
     d_bytes_transferred = 0;
 
-    d_ios.reset();
-    d_socket.async_receive(boost::asio::buffer(recv),
-                           boost::bind(&TCPDataTransport::read_complete, this,
-                                       boost::asio::placeholders::error,
-                                       boost::asio::placeholders::bytes_transferred));
+    d_handlers.run(d_ioStrand, 2, [this, timeout]() {
+        d_socket.async_receive(
+            boost::asio::buffer(d_readBuffer),
+            d_ioStrand.wrap(boost::bind(&TCPDataTransport::read_complete, this,
+                                        boost::asio::placeholders::error,
+                                        boost::asio::placeholders::bytes_transferred)));
+
+        boost::system::error_code ec;
+        d_timer.expires_from_now(boost::posix_time::milliseconds(timeout), ec);
+        d_timer.async_wait(d_ioStrand.wrap(boost::bind(
+            &TCPDataTransport::time_out, this, boost::asio::placeholders::error)));
+    });
 
-    d_timer.expires_from_now(boost::posix_time::milliseconds(timeout));
-    d_timer.async_wait(
-        boost::bind(&TCPDataTransport::time_out, this, boost::asio::placeholders::error));
+    if (d_read_error)
+    {
+        if (d_persistentConnection && d_last_error &&
+            d_last_error != boost::asio::error::operation_aborted)
+        {
+            // The connection is broken, not just late: reconnect on next command.
+            disconnect();
+        }
+        return 0;
+    }
+    return d_bytes_transferred;
+}
 
-    d_ios.run();
+ByteVector TCPDataTransport::receive(long int timeout)
+{
+    ByteVector res;
+    const std::chrono::steady_clock::time_point clock_timeout =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    bool firstRead = true;
 
-    recv.resize(d_bytes_transferred);
-    if (d_read_error || recv.size() == 0)
+    for (;;)
     {
-        char buf[64];
-        sprintf(buf, "Socket receive timeout (> %ld milliseconds).", timeout);
-        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, buf);
+        if (d_circular_buffer_parser && !d_receiveBuffer.empty())
+        {
+            res = d_circular_buffer_parser->getValidBuffer(d_receiveBuffer);
+            if (res.size() > 0)
+                break;
+        }
+
+        long int remaining =
+            static_cast<long int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      clock_timeout - std::chrono::steady_clock::now())
+                                      .count());
+        size_t len = 0;
+        if (firstRead || remaining > 0)
+            len = receiveSome(std::max(remaining, 0L));
+        firstRead = false;
+
+        if (len == 0)
+        {
+            char buf[64];
+            d_metrics->recordTimeout();
+            sprintf(buf, "Socket receive timeout (> %ld milliseconds).", timeout);
+            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, buf);
+        }
+
+        if (!d_circular_buffer_parser)
+        {
+            res.assign(d_readBuffer.begin(), d_readBuffer.begin() + len);
+            break;
+        }
+
+        appendReceived(len);
     }
 
-    LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(recv);
-    return recv;
+    d_lastActivity = std::chrono::steady_clock::now();
+    LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(res);
+    return res;
+}
+
+void TCPDataTransport::appendReceived(size_t len)
+{
+    if (d_receiveBuffer.reserve() < len)
+    {
+        size_t capacity =
+            std::max(d_receiveBuffer.capacity() * 2, d_receiveBuffer.size() + len);
+        if (capacity > TCP_MAX_FRAME_BUFFER_SIZE)
+        {
+            LOG(LogLevel::WARNINGS) << "No valid frame in " << d_receiveBuffer.size()
+                                    << " received bytes. Discarding them.";
+            d_receiveBuffer.clear();
+        }
+        else
+            d_receiveBuffer.set_capacity(capacity);
+    }
+    d_receiveBuffer.insert(d_receiveBuffer.end(), d_readBuffer.begin(),
+                           d_readBuffer.begin() + static_cast<std::ptrdiff_t>(len));
+}
+
+void TCPDataTransport::asyncSendCommand(const ByteVector &command, long int timeout,
+                                        CommandCallback callback)
+{
+    if (timeout == -1)
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+    d_asyncCommands.push(command, timeout, callback);
+}
+
+void TCPDataTransport::asyncStart(const AsyncCommandQueue::Command &command)
+{
+    d_asyncCommand   = command.command;
+    d_asyncTimeout   = command.timeout;
+    d_asyncAborted   = false;
+    d_asyncFirstRead = true;
+    commandStarted(d_asyncCommand, d_asyncTimeout);
+    d_asyncSendTime = std::chrono::steady_clock::now();
+    d_asyncDeadline = d_asyncSendTime + std::chrono::milliseconds(d_asyncTimeout);
+
+    if (d_asyncCommand.empty())
+        asyncReceive();
+    else if (!connectBeforeCommand())
+        asyncSend();
+    else if (d_persistentConnection &&
+             d_lastActivity != std::chrono::steady_clock::time_point())
+    {
+        if (d_socket.is_open() && checkSocket())
+            asyncSend();
+        else
+        {
+            d_metrics->recordReconnect();
+            asyncConnect();
+        }
+    }
+    else
+        asyncConnect();
+}
+
+void TCPDataTransport::asyncAbort()
+{
+    d_asyncAborted = true;
+    boost::system::error_code ec;
+    d_timer.cancel(ec);
+    d_socket.cancel(ec);
+}
+
+void TCPDataTransport::asyncArmTimer(AsyncStep step)
+{
+    d_asyncStep        = step;
+    d_asyncWaiting     = 2;
+    d_asyncError       = boost::system::error_code();
+    d_asyncTransferred = 0;
+    d_asyncTimedOut    = false;
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        d_asyncDeadline - std::chrono::steady_clock::now());
+    boost::system::error_code ec;
+    d_timer.expires_from_now(
+        boost::posix_time::milliseconds(std::max<long long>(remaining.count(), 0)), ec);
+    auto onTimer = [this](const boost::system::error_code &error) {
+        if (!error)
+        {
+            d_asyncTimedOut = true;
+            boost::system::error_code ignored;
+            d_socket.cancel(ignored);
+        }
+        asyncStepDone();
+    };
+    d_timer.async_wait(d_asyncCommands.wrap(onTimer));
+}
+
+void TCPDataTransport::asyncConnect()
+{
+    boost::system::error_code ec;
+    if (d_socket.is_open())
+        d_socket.close(ec);
+    d_receiveBuffer.clear();
+
+    boost::asio::ip::tcp::endpoint endpoint;
+    try
+    {
+        endpoint = boost::asio::ip::tcp::endpoint(BOOST_ASIO_MAKE_ADDRESS(getIpAddress()),
+                                                  getPort());
+    }
+    catch (boost::system::system_error &ex)
+    {
+        asyncFail(std::string("Cannot establish connection on ") + getIpAddress() + ": " +
+                  ex.what());
+        return;
+    }
+
+    asyncArmTimer(AsyncStep::Connect);
+    d_socket.async_connect(
+        endpoint, d_asyncCommands.wrap([this](const boost::system::error_code &error) {
+            d_asyncError = error;
+            boost::system::error_code ignored;
+            d_timer.cancel(ignored);
+            asyncStepDone();
+        }));
+}
+
+void TCPDataTransport::asyncSend()
+{
+    d_asyncSendTime = std::chrono::steady_clock::now();
+    LOG(LogLevel::COMS) << "TCP Send Data: " << BufferHelper::getHex(d_asyncCommand);
+
+    asyncArmTimer(AsyncStep::Send);
+    boost::asio::async_write(
+        d_socket, boost::asio::buffer(d_asyncCommand),
+        d_asyncCommands.wrap([this](const boost::system::error_code &error, size_t len) {
+            d_asyncError       = error;
+            d_asyncTransferred = len;
+            boost::system::error_code ignored;
+            d_timer.cancel(ignored);
+            asyncStepDone();
+        }));
+}
+
+void TCPDataTransport::asyncReceive()
+{
+    if (d_circular_buffer_parser && !d_receiveBuffer.empty())
+    {
+        ByteVector res;
+        try
+        {
+            res = d_circular_buffer_parser->getValidBuffer(d_receiveBuffer);
+        }
+        catch (std::exception &e)
+        {
+            asyncFail(e.what());
+            return;
+        }
+        if (res.size() > 0)
+        {
+            asyncSucceed(res);
+            return;
+        }
+    }
+
+    if (!d_asyncFirstRead && std::chrono::steady_clock::now() >= d_asyncDeadline)
+    {
+        d_metrics->recordTimeout();
+        asyncFail("Socket receive timeout (> " + std::to_string(d_asyncTimeout) +
+                  " milliseconds).");
+        return;
+    }
+    d_asyncFirstRead = false;
+
+    asyncArmTimer(AsyncStep::Receive);
+    d_socket.async_receive(
+        boost::asio::buffer(d_readBuffer),
+        d_asyncCommands.wrap([this](const boost::system::error_code &error, size_t len) {
+            d_asyncError       = error;
+            d_asyncTransferred = len;
+            boost::system::error_code ignored;
+            d_timer.cancel(ignored);
+            asyncStepDone();
+        }));
+}
+
+void TCPDataTransport::asyncStepDone()
+{
+    // Wait for both the I/O and the timer handlers: the next step reuses the timer.
+    if (--d_asyncWaiting > 0)
+        return;
+
+    if (d_asyncAborted)
+    {
+        asyncFail("The transport was closed.");
+        return;
+    }
+
+    const bool failed = d_asyncTimedOut || d_asyncError;
+    switch (d_asyncStep)
+    {
+    case AsyncStep::Connect:
+        if (failed)
+        {
+            boost::system::error_code ec;
+            d_socket.close(ec);
+            asyncFail("Cannot establish connection on " + getIpAddress() + ":" +
+                      std::to_string(getPort()) + " : " +
+                      (d_asyncTimedOut ? std::string("timeout")
+                                       : d_asyncError.message()));
+            return;
+        }
+        if (d_persistentConnection)
+        {
+            boost::system::error_code ec;
+            d_socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+            d_socket.set_option(boost::asio::socket_base::keep_alive(true), ec);
+        }
+        d_lastActivity = std::chrono::steady_clock::now();
+        LOG(LogLevel::INFOS) << "Connected to " << getIpAddress() << " on port "
+                             << getPort() << ".";
+        asyncSend();
+        break;
+
+    case AsyncStep::Send:
+        if (failed)
+        {
+            disconnect();
+            asyncFail("Cannot send on " + getIpAddress() + ":" +
+                      std::to_string(getPort()) + " : " +
+                      (d_asyncTimedOut ? std::string("timeout")
+                                       : d_asyncError.message()));
+            return;
+        }
+        d_lastActivity = std::chrono::steady_clock::now();
+        asyncReceive();
+        break;
+
+    case AsyncStep::Receive:
+        if (failed || d_asyncTransferred == 0)
+        {
+            if (d_persistentConnection && d_asyncError &&
+                d_asyncError != boost::asio::error::operation_aborted)
+            {
+                // The connection is broken, not just late: reconnect on next command.
+                disconnect();
+            }
+            d_metrics->recordTimeout();
+            asyncFail("Socket receive timeout (> " + std::to_string(d_asyncTimeout) +
+                      " milliseconds).");
+            return;
+        }
+        if (!d_circular_buffer_parser)
+        {
+            asyncSucceed(ByteVector(d_readBuffer.begin(),
+                                    d_readBuffer.begin() +
+                                        static_cast<std::ptrdiff_t>(d_asyncTransferred)));
+            return;
+        }
+        appendReceived(d_asyncTransferred);
+        asyncReceive();
+        break;
+    }
+}
+
+void TCPDataTransport::asyncSucceed(const ByteVector &result)
+{
+    d_lastActivity = std::chrono::steady_clock::now();
+    LOG(LogLevel::COMS) << "TCP Data read: " << BufferHelper::getHex(result);
+    commandCompleted(d_asyncCommand, result, d_lastActivity - d_asyncSendTime);
+    d_asyncCommands.complete(result, std::exception_ptr());
+}
+
+void TCPDataTransport::asyncFail(const std::string &message)
+{
+    LOG(LogLevel::ERRORS) << message;
+    std::exception_ptr eptr = std::make_exception_ptr(LibLogicalAccessException(message));
+    commandFailed(eptr);
+    d_asyncCommands.complete(ByteVector(), eptr);
 }
 
 void TCPDataTransport::serialize(boost::property_tree::ptree &parentNode)
@@ -189,6 +734,9 @@ void TCPDataTransport::serialize(boost::property_tree::ptree &parentNode)
     node.put("<xmlattr>.type", getTransportType());
     node.put("IpAddress", d_ipAddress);
     node.put("Port", d_port);
+    node.put("PersistentConnection", d_persistentConnection);
+    node.put("HealthCheckInterval", d_healthCheckInterval);
+    node.put("Pipelining", d_pipelining);
 
     parentNode.add_child(getDefaultXmlNodeName(), node);
 }
@@ -197,6 +745,9 @@ void TCPDataTransport::unSerialize(boost::property_tree::ptree &node)
 {
     d_ipAddress = node.get_child("IpAddress").get_value<std::string>();
     d_port      = node.get_child("Port").get_value<int>();
+    d_persistentConnection = node.get<bool>("PersistentConnection", false);
+    d_healthCheckInterval  = node.get<long int>("HealthCheckInterval", 0);
+    d_pipelining           = node.get<bool>("Pipelining", false);
 }
 
 std::string TCPDataTransport::getDefaultXmlNodeName() const
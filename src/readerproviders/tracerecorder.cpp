@@ -0,0 +1,209 @@
+/**
+ * \file tracerecorder.cpp
+ * \brief Binary trace of the data transports traffic.
+ */
+
+#include <logicalaccess/readerproviders/tracerecorder.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+#include <cstring>
+#include <limits>
+
+namespace logicalaccess
+{
+static const char TRACE_MAGIC[8] = {'L', 'L', 'A', 'T', 'R', 'A', 'C', 'E'};
+
+/**
+ * \brief Record type declaring a transport name.
+ */
+static const uint8_t TRACE_TRANSPORT = 0;
+
+const uint16_t TraceRecorder::VERSION;
+std::shared_ptr<TraceRecorder> TraceRecorder::s_global;
+std::atomic<bool> TraceRecorder::s_enabled(false);
+
+TraceRecorder::TraceRecorder(const std::string &filename)
+    : d_file(filename, std::ios::out | std::ios::binary | std::ios::trunc)
+    , d_start(std::chrono::steady_clock::now())
+    , d_records(0)
+{
+    EXCEPTION_ASSERT_WITH_LOG(d_file.is_open(), LibLogicalAccessException,
+                              "Cannot create the trace file " + filename + ".");
+
+    d_file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    writeU16(VERSION);
+    writeU64(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count()));
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    d_file.flush();
+}
+
+void TraceRecorder::record(const std::string &transport, TraceDirection direction,
+                           const ByteVector &data)
+{
+    const uint64_t timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - d_start)
+            .count());
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    auto it = d_transports.find(transport);
+    if (it == d_transports.end())
+    {
+        if (d_transports.size() > std::numeric_limits<uint16_t>::max())
+            return;
+        const uint16_t id = static_cast<uint16_t>(d_transports.size());
+        it                = d_transports.insert(std::make_pair(transport, id)).first;
+
+        const size_t len = std::min<size_t>(transport.size(),
+                                            std::numeric_limits<uint16_t>::max());
+        writeU8(TRACE_TRANSPORT);
+        writeU16(id);
+        writeU16(static_cast<uint16_t>(len));
+        d_file.write(transport.data(), len);
+    }
+
+    writeU8(static_cast<uint8_t>(direction));
+    writeU16(it->second);
+    writeU64(timestamp);
+    writeU32(static_cast<uint32_t>(data.size()));
+    if (!data.empty())
+        d_file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    ++d_records;
+}
+
+void TraceRecorder::flush()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_file.flush();
+}
+
+uint64_t TraceRecorder::getRecordCount() const
+{
+    return d_records;
+}
+
+void TraceRecorder::setGlobal(std::shared_ptr<TraceRecorder> recorder)
+{
+    s_enabled = static_cast<bool>(recorder);
+    std::atomic_store(&s_global, recorder);
+}
+
+std::shared_ptr<TraceRecorder> TraceRecorder::getGlobal()
+{
+    if (!s_enabled.load(std::memory_order_relaxed))
+        return std::shared_ptr<TraceRecorder>();
+    return std::atomic_load(&s_global);
+}
+
+void TraceRecorder::writeU8(uint8_t value)
+{
+    d_file.put(static_cast<char>(value));
+}
+
+void TraceRecorder::writeU16(uint16_t value)
+{
+    char buf[2] = {static_cast<char>(value & 0xff), static_cast<char>(value >> 8)};
+    d_file.write(buf, sizeof(buf));
+}
+
+void TraceRecorder::writeU32(uint32_t value)
+{
+    char buf[4];
+    for (size_t i = 0; i < sizeof(buf); ++i)
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    d_file.write(buf, sizeof(buf));
+}
+
+void TraceRecorder::writeU64(uint64_t value)
+{
+    char buf[8];
+    for (size_t i = 0; i < sizeof(buf); ++i)
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    d_file.write(buf, sizeof(buf));
+}
+
+/**
+ * \brief Read a little-endian integer, throw on a truncated file.
+ */
+static uint64_t readLE(std::istream &in, size_t size)
+{
+    unsigned char buf[8];
+    in.read(reinterpret_cast<char *>(buf), size);
+    EXCEPTION_ASSERT_WITH_LOG(static_cast<size_t>(in.gcount()) == size,
+                              LibLogicalAccessException, "Truncated trace file.");
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i)
+        value = (value << 8) | buf[i - 1];
+    return value;
+}
+
+TraceReader::TraceReader(const std::string &filename)
+    : d_startTime(0)
+{
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    EXCEPTION_ASSERT_WITH_LOG(in.is_open(), LibLogicalAccessException,
+                              "Cannot open the trace file " + filename + ".");
+    in.seekg(0, std::ios::end);
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    char magic[sizeof(TRACE_MAGIC)];
+    in.read(magic, sizeof(magic));
+    EXCEPTION_ASSERT_WITH_LOG(in.gcount() == sizeof(magic) &&
+                                  memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0,
+                              LibLogicalAccessException, "Not a trace file.");
+    const uint64_t version = readLE(in, 2);
+    EXCEPTION_ASSERT_WITH_LOG(version == TraceRecorder::VERSION,
+                              LibLogicalAccessException,
+                              "Unsupported trace file version.");
+    d_startTime = readLE(in, 8);
+
+    std::vector<std::string> transports;
+    int type;
+    while ((type = in.get()) != std::char_traits<char>::eof())
+    {
+        const uint16_t id = static_cast<uint16_t>(readLE(in, 2));
+        if (type == TRACE_TRANSPORT)
+        {
+            const size_t len = static_cast<size_t>(readLE(in, 2));
+            std::string name(len, '\0');
+            in.read(&name[0], len);
+            EXCEPTION_ASSERT_WITH_LOG(static_cast<size_t>(in.gcount()) == len,
+                                      LibLogicalAccessException, "Truncated trace file.");
+            if (transports.size() <= id)
+                transports.resize(id + 1);
+            transports[id] = name;
+            continue;
+        }
+
+        EXCEPTION_ASSERT_WITH_LOG(type >= static_cast<int>(TraceDirection::Command) &&
+                                      type <= static_cast<int>(TraceDirection::Error) &&
+                                      id < transports.size(),
+                                  LibLogicalAccessException, "Corrupted trace file.");
+        TraceRecord record;
+        record.direction = static_cast<TraceDirection>(type);
+        record.transport = transports[id];
+        record.timestamp = readLE(in, 8);
+        const size_t len = static_cast<size_t>(readLE(in, 4));
+        // Never trust the length over the bytes actually left in the file.
+        const std::streamoff remaining = fileSize - in.tellg();
+        EXCEPTION_ASSERT_WITH_LOG(static_cast<std::streamoff>(len) <= remaining,
+                                  LibLogicalAccessException, "Truncated trace file.");
+        record.data.resize(len);
+        if (len > 0)
+        {
+            in.read(reinterpret_cast<char *>(record.data.data()), len);
+            EXCEPTION_ASSERT_WITH_LOG(static_cast<size_t>(in.gcount()) == len,
+                                      LibLogicalAccessException, "Truncated trace file.");
+        }
+        d_records.push_back(std::move(record));
+    }
+}
+}
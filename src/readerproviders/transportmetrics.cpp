@@ -0,0 +1,151 @@
+/**
+ * \file transportmetrics.cpp
+ * \brief Counters and latency histogram of a data transport.
+ */
+
+#include <logicalaccess/readerproviders/transportmetrics.hpp>
+#include "nlohmann/json.hpp"
+
+#include <limits>
+
+namespace logicalaccess
+{
+TransportMetrics::TransportMetrics()
+{
+    reset();
+}
+
+void TransportMetrics::recordCommand(size_t bytesOut, size_t bytesIn,
+                                     std::chrono::steady_clock::duration latency)
+{
+    const int64_t us =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    const uint64_t value = us > 0 ? static_cast<uint64_t>(us) : 0;
+
+    d_commands.fetch_add(1, std::memory_order_relaxed);
+    d_bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+    d_bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+    d_latencySum.fetch_add(value, std::memory_order_relaxed);
+    d_buckets[LogLinearHistogram::getBucketIndex(value)].fetch_add(
+        1, std::memory_order_relaxed);
+
+    uint64_t current = d_latencyMin.load(std::memory_order_relaxed);
+    while (value < current &&
+           !d_latencyMin.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+    current = d_latencyMax.load(std::memory_order_relaxed);
+    while (value > current &&
+           !d_latencyMax.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void TransportMetrics::recordTimeout()
+{
+    d_timeouts.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TransportMetrics::recordError()
+{
+    d_errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TransportMetrics::recordReconnect()
+{
+    d_reconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getCommandCount() const
+{
+    return d_commands.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getBytesOut() const
+{
+    return d_bytesOut.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getBytesIn() const
+{
+    return d_bytesIn.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getTimeoutCount() const
+{
+    return d_timeouts.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getErrorCount() const
+{
+    return d_errors.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getReconnectCount() const
+{
+    return d_reconnects.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getMinLatency() const
+{
+    uint64_t value = d_latencyMin.load(std::memory_order_relaxed);
+    return value == std::numeric_limits<uint64_t>::max() ? 0 : value;
+}
+
+uint64_t TransportMetrics::getMaxLatency() const
+{
+    return d_latencyMax.load(std::memory_order_relaxed);
+}
+
+uint64_t TransportMetrics::getMeanLatency() const
+{
+    uint64_t count = getCommandCount();
+    return count > 0 ? d_latencySum.load(std::memory_order_relaxed) / count : 0;
+}
+
+uint64_t TransportMetrics::getLatencyPercentile(double percentile) const
+{
+    std::array<uint64_t, LogLinearHistogram::BUCKET_COUNT> counts;
+    for (size_t i = 0; i < counts.size(); ++i)
+        counts[i] = d_buckets[i].load(std::memory_order_relaxed);
+    return LogLinearHistogram::getPercentile(counts.data(), percentile, getMaxLatency());
+}
+
+void TransportMetrics::reset()
+{
+    d_commands   = 0;
+    d_bytesOut   = 0;
+    d_bytesIn    = 0;
+    d_timeouts   = 0;
+    d_errors     = 0;
+    d_reconnects = 0;
+    d_latencySum = 0;
+    d_latencyMin = std::numeric_limits<uint64_t>::max();
+    d_latencyMax = 0;
+    for (auto &bucket : d_buckets)
+        bucket = 0;
+}
+
+std::string TransportMetrics::toJson() const
+{
+    nlohmann::json json;
+    json["commands"]   = getCommandCount();
+    json["bytesOut"]   = getBytesOut();
+    json["bytesIn"]    = getBytesIn();
+    json["timeouts"]   = getTimeoutCount();
+    json["errors"]     = getErrorCount();
+    json["reconnects"] = getReconnectCount();
+
+    nlohmann::json latency;
+    latency["min"]  = getMinLatency();
+    latency["mean"] = getMeanLatency();
+    latency["p50"]  = getLatencyPercentile(50);
+    latency["p90"]  = getLatencyPercentile(90);
+    latency["p99"]  = getLatencyPercentile(99);
+    latency["p999"] = getLatencyPercentile(99.9);
+    latency["max"]  = getMaxLatency();
+    json["latencyUs"] = latency;
+
+    return json.dump();
+}
+}
@@ -0,0 +1,271 @@
+/**
+ * \file transportreactor.cpp
+ * \brief Shared event loop for data transports.
+ */
+
+#include <logicalaccess/readerproviders/transportreactor.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+#include <algorithm>
+
+namespace logicalaccess
+{
+namespace
+{
+thread_local bool s_ioThread = false;
+}
+
+PendingHandlers::PendingHandlers()
+    : d_count(0)
+{
+}
+
+void PendingHandlers::run(boost::asio::io_service::strand &strand, int count,
+                          const std::function<void()> &start)
+{
+    if (TransportReactor::isIOThread())
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Blocking transport I/O from a reactor I/O thread.");
+
+    TransportReactor::getInstance()->start();
+    {
+        std::lock_guard<std::mutex> lg(d_mutex);
+        d_count += count;
+    }
+    strand.post(start);
+
+    std::unique_lock<std::mutex> ul(d_mutex);
+    d_cond.wait(ul, [this]() { return d_count == 0; });
+}
+
+void PendingHandlers::add(int count)
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    d_count += count;
+}
+
+void PendingHandlers::wait()
+{
+    std::unique_lock<std::mutex> ul(d_mutex);
+    d_cond.wait(ul, [this]() { return d_count == 0; });
+}
+
+void PendingHandlers::completed()
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    if (--d_count == 0)
+        d_cond.notify_all();
+}
+
+AsyncCommandQueue::AsyncCommandQueue(boost::asio::io_service::strand &strand,
+                                     std::function<void(const Command &)> start,
+                                     std::function<void()> abort)
+    : d_strand(strand)
+    , d_start(start)
+    , d_abort(abort)
+    , d_closed(false)
+    , d_used(false)
+{
+}
+
+AsyncCommandQueue::~AsyncCommandQueue()
+{
+    close();
+}
+
+void AsyncCommandQueue::push(const ByteVector &command, long int timeout,
+                             Callback callback)
+{
+    d_used = true;
+    TransportReactor::getInstance()->start();
+    post([this, command, timeout, callback]() {
+        if (d_closed)
+        {
+            TransportReactor::getInstance()->getCommandService().post([callback]() {
+                callback(ByteVector(), std::make_exception_ptr(LibLogicalAccessException(
+                                           "The transport was closed.")));
+            });
+            return;
+        }
+        d_commands.push_back({command, timeout, callback});
+        if (d_commands.size() == 1)
+            d_start(d_commands.front());
+    });
+}
+
+void AsyncCommandQueue::complete(const ByteVector &result, std::exception_ptr eptr)
+{
+    Callback callback = d_commands.front().callback;
+    d_commands.pop_front();
+    if (callback)
+    {
+        TransportReactor::getInstance()->getCommandService().post(
+            [callback, result, eptr]() { callback(result, eptr); });
+    }
+
+    if (!d_commands.empty())
+        d_start(d_commands.front());
+}
+
+void AsyncCommandQueue::post(const std::function<void()> &handler)
+{
+    d_handlers.add(1);
+    d_strand.post([this, handler]() {
+        Completion completion{&d_handlers};
+        handler();
+    });
+}
+
+void AsyncCommandQueue::close()
+{
+    if (!d_used)
+        return;
+
+    post([this]() {
+        if (d_closed)
+            return;
+        d_closed = true;
+        if (d_commands.empty())
+            return;
+
+        // Only the running command stays: its aborted handlers complete it.
+        std::exception_ptr eptr = std::make_exception_ptr(
+            LibLogicalAccessException("The transport was closed."));
+        while (d_commands.size() > 1)
+        {
+            Callback callback = d_commands.back().callback;
+            d_commands.pop_back();
+            if (callback)
+            {
+                TransportReactor::getInstance()->getCommandService().post(
+                    [callback, eptr]() { callback(ByteVector(), eptr); });
+            }
+        }
+        d_abort();
+    });
+    d_handlers.wait();
+}
+
+TransportReactor::TransportReactor()
+    : d_threadCount(0)
+    , d_workerCount(0)
+{
+}
+
+TransportReactor::~TransportReactor()
+{
+    stop();
+}
+
+TransportReactor *TransportReactor::getInstance()
+{
+    // Intentionally never destroyed: joining worker threads from a static
+    // destructor may deadlock while the library is being unloaded.
+    static TransportReactor *instance = new TransportReactor();
+    return instance;
+}
+
+bool TransportReactor::isIOThread()
+{
+    return s_ioThread;
+}
+
+void TransportReactor::spawn(boost::asio::io_service &ios, size_t count, bool io,
+                             std::vector<std::thread> &threads)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        threads.emplace_back([&ios, io]() {
+            s_ioThread = io;
+            for (;;)
+            {
+                try
+                {
+                    ios.run();
+                    break;
+                }
+                catch (std::exception &e)
+                {
+                    LOG(LogLevel::ERRORS) << "Unhandled exception in transport reactor: "
+                                          << e.what();
+                }
+            }
+        });
+    }
+}
+
+void TransportReactor::start()
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    if (!d_threads.empty())
+        return;
+
+    size_t threadCount = d_threadCount;
+    if (threadCount == 0)
+        threadCount = static_cast<size_t>(
+            std::max(1, Settings::getSnapshot()->TransportReactorThreads));
+    size_t workerCount = d_workerCount;
+    if (workerCount == 0)
+        workerCount = static_cast<size_t>(
+            std::max(1, Settings::getSnapshot()->TransportWorkerThreads));
+
+    LOG(LogLevel::INFOS) << "Starting transport reactor with " << threadCount
+                         << " I/O thread(s) and " << workerCount
+                         << " command thread(s).";
+    d_ios.reset();
+    d_commandIos.reset();
+    d_work.reset(new boost::asio::io_service::work(d_ios));
+    d_commandWork.reset(new boost::asio::io_service::work(d_commandIos));
+    spawn(d_ios, threadCount, true, d_threads);
+    spawn(d_commandIos, workerCount, false, d_threads);
+}
+
+void TransportReactor::stop()
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    d_work.reset();
+    d_commandWork.reset();
+    d_ios.stop();
+    d_commandIos.stop();
+    for (auto &thread : d_threads)
+    {
+        if (thread.get_id() == std::this_thread::get_id())
+            thread.detach();
+        else
+            thread.join();
+    }
+    d_threads.clear();
+}
+
+size_t TransportReactor::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    if (d_threadCount == 0)
+        return static_cast<size_t>(
+            std::max(1, Settings::getSnapshot()->TransportReactorThreads));
+    return d_threadCount;
+}
+
+void TransportReactor::setThreadCount(size_t count)
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    d_threadCount = count > 0 ? count : 1;
+}
+
+size_t TransportReactor::getWorkerCount() const
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    if (d_workerCount == 0)
+        return static_cast<size_t>(
+            std::max(1, Settings::getSnapshot()->TransportWorkerThreads));
+    return d_workerCount;
+}
+
+void TransportReactor::setWorkerCount(size_t count)
+{
+    std::lock_guard<std::mutex> lg(d_mutex);
+    d_workerCount = count > 0 ? count : 1;
+}
+}
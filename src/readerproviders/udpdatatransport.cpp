@@ -5,20 +5,38 @@
  */
 
 #include <logicalaccess/readerproviders/udpdatatransport.hpp>
+#include <logicalaccess/readerproviders/transportreactor.hpp>
 #include <logicalaccess/cards/readercardadapter.hpp>
 #include <logicalaccess/boost_version_types.hpp>
+#include <logicalaccess/bufferhelper.hpp>
 
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
 #include <boost/array.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <thread>
+#include <boost/bind/bind.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+#include <logicalaccess/myexception.hpp>
 
 namespace logicalaccess
 {
 UDPDataTransport::UDPDataTransport()
-    : d_ipAddress("127.0.0.1")
+    : d_ioStrand(TransportReactor::getInstance()->getIOService())
+    , d_timer(TransportReactor::getInstance()->getIOService())
+    , d_readBuffer(1024)
+    , d_bytes_transferred(0)
+    , d_ipAddress("127.0.0.1")
     , d_port(9559)
+    , d_asyncTimeout(0)
+    , d_asyncWaiting(0)
+    , d_asyncTransferred(0)
+    , d_asyncAborted(false)
+    , d_asyncCommands(d_ioStrand,
+                      [this](const AsyncCommandQueue::Command &command) {
+                          asyncStart(command);
+                      },
+                      [this]() { asyncAbort(); })
 {
 }
 
@@ -46,6 +64,16 @@ void UDPDataTransport::setPort(int port)
     d_port = port;
 }
 
+size_t UDPDataTransport::getMaxDatagramSize() const
+{
+    return d_readBuffer.size();
+}
+
+void UDPDataTransport::setMaxDatagramSize(size_t size)
+{
+    d_readBuffer.resize(size > 0 ? size : 1);
+}
+
 std::shared_ptr<boost::asio::ip::udp::socket> UDPDataTransport::getSocket() const
 {
     return d_socket;
@@ -57,7 +85,8 @@ bool UDPDataTransport::connect()
     {
         boost::asio::ip::udp::endpoint endpoint(BOOST_ASIO_MAKE_ADDRESS(getIpAddress()),
                                                 getPort());
-        d_socket.reset(new boost::asio::ip::udp::socket(ios));
+        d_socket.reset(new boost::asio::ip::udp::socket(
+            TransportReactor::getInstance()->getIOService()));
 
         try
         {
@@ -100,33 +129,209 @@ void UDPDataTransport::send(const ByteVector &data)
     }
 }
 
+void UDPDataTransport::read_complete(const boost::system::error_code &error,
+                                     size_t bytes_transferred)
+{
+    d_bytes_transferred = error ? 0 : bytes_transferred;
+    boost::system::error_code ec;
+    d_timer.cancel(ec);
+    d_handlers.completed();
+}
+
+void UDPDataTransport::time_out(const boost::system::error_code &error)
+{
+    if (!error && d_socket)
+    {
+        boost::system::error_code ec;
+        d_socket->cancel(ec);
+    }
+    d_handlers.completed();
+}
+
 ByteVector UDPDataTransport::receive(long int timeout)
 {
     ByteVector res;
     std::shared_ptr<boost::asio::ip::udp::socket> socket = getSocket();
+    if (!socket)
+        return res;
 
-    long int currentWait = 0;
-    size_t lenav         = socket->available();
-    while (lenav == 0 && (timeout == 0 || currentWait < timeout))
+    d_bytes_transferred = 0;
+    if (timeout < 0)
+    {
+        // Only take a datagram already received.
+        boost::system::error_code ec;
+        if (socket->available(ec) > 0 && !ec)
+        {
+            d_bytes_transferred =
+                socket->receive(boost::asio::buffer(d_readBuffer), 0, ec);
+        }
+        if (ec)
+            d_bytes_transferred = 0;
+    }
+    else
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        currentWait += 250;
+        d_handlers.run(d_ioStrand, (timeout > 0) ? 2 : 1, [this, socket, timeout]() {
+            socket->async_receive(
+                boost::asio::buffer(d_readBuffer),
+                d_ioStrand.wrap(boost::bind(
+                    &UDPDataTransport::read_complete, this,
+                    boost::asio::placeholders::error,
+                    boost::asio::placeholders::bytes_transferred)));
 
-        lenav = socket->available();
+            if (timeout > 0)
+            {
+                boost::system::error_code ec;
+                d_timer.expires_from_now(boost::posix_time::milliseconds(timeout), ec);
+                d_timer.async_wait(d_ioStrand.wrap(
+                    boost::bind(&UDPDataTransport::time_out, this,
+                                boost::asio::placeholders::error)));
+            }
+        });
     }
 
-    if (lenav > 0)
+    if (d_bytes_transferred > 0)
     {
-        boost::array<char, 128> recv_buf;
-        boost::asio::ip::udp::endpoint sender_endpoint;
-        // TODO: Need to set up a timeout here !
-        size_t len = socket->receive_from(boost::asio::buffer(recv_buf), sender_endpoint);
-        res        = ByteVector(recv_buf.begin(), recv_buf.begin() + len);
+        res.assign(d_readBuffer.begin(), d_readBuffer.begin() + d_bytes_transferred);
+        LOG(LogLevel::COMS) << "UDP Data read: " << BufferHelper::getHex(res);
     }
+    else
+        d_metrics->recordTimeout();
 
     return res;
 }
 
+void UDPDataTransport::asyncSendCommand(const ByteVector &command, long int timeout,
+                                        CommandCallback callback)
+{
+    if (timeout == -1)
+        timeout = Settings::getSnapshot()->DataTransportTimeout;
+    d_asyncCommands.push(command, timeout, callback);
+}
+
+void UDPDataTransport::asyncStart(const AsyncCommandQueue::Command &command)
+{
+    d_asyncCommand = command.command;
+    d_asyncTimeout = command.timeout;
+    d_asyncAborted = false;
+    commandStarted(d_asyncCommand, d_asyncTimeout);
+    d_asyncSendTime = std::chrono::steady_clock::now();
+
+    if (d_asyncCommand.empty())
+    {
+        asyncReceive();
+        return;
+    }
+
+    // Opening a UDP socket does not wait for the peer.
+    if (connectBeforeCommand())
+        connect();
+    std::shared_ptr<boost::asio::ip::udp::socket> socket = getSocket();
+    if (!socket)
+    {
+        asyncComplete(ByteVector(),
+                      std::make_exception_ptr(LibLogicalAccessException(
+                          "Cannot open the UDP socket to " + getIpAddress() + ".")));
+        return;
+    }
+
+    socket->async_send(
+        boost::asio::buffer(d_asyncCommand),
+        d_asyncCommands.wrap([this](const boost::system::error_code &error, size_t) {
+            if (d_asyncAborted || error)
+            {
+                std::string message = d_asyncAborted
+                                          ? std::string("The transport was closed.")
+                                          : "Cannot send on " + getIpAddress() + " : " +
+                                                error.message();
+                asyncComplete(ByteVector(), std::make_exception_ptr(
+                                                LibLogicalAccessException(message)));
+                return;
+            }
+            asyncReceive();
+        }));
+}
+
+void UDPDataTransport::asyncAbort()
+{
+    d_asyncAborted = true;
+    boost::system::error_code ec;
+    d_timer.cancel(ec);
+    if (d_socket)
+        d_socket->cancel(ec);
+}
+
+void UDPDataTransport::asyncReceive()
+{
+    std::shared_ptr<boost::asio::ip::udp::socket> socket = getSocket();
+    if (!socket || d_asyncTimeout < 0)
+    {
+        // Like receive(): a negative timeout only takes a datagram already received.
+        asyncComplete(receive(d_asyncTimeout), std::exception_ptr());
+        return;
+    }
+
+    d_asyncTransferred = 0;
+    d_asyncWaiting     = (d_asyncTimeout > 0) ? 2 : 1;
+    socket->async_receive(
+        boost::asio::buffer(d_readBuffer),
+        d_asyncCommands.wrap([this](const boost::system::error_code &error, size_t len) {
+            d_asyncTransferred = error ? 0 : len;
+            boost::system::error_code ignored;
+            d_timer.cancel(ignored);
+            asyncReceiveDone();
+        }));
+
+    if (d_asyncTimeout > 0)
+    {
+        boost::system::error_code ec;
+        d_timer.expires_from_now(boost::posix_time::milliseconds(d_asyncTimeout), ec);
+        d_timer.async_wait(d_asyncCommands.wrap(
+            [this, socket](const boost::system::error_code &error) {
+                if (!error)
+                {
+                    boost::system::error_code ignored;
+                    socket->cancel(ignored);
+                }
+                asyncReceiveDone();
+            }));
+    }
+}
+
+void UDPDataTransport::asyncReceiveDone()
+{
+    // Wait for both the read and the timer handlers: the next command reuses the timer.
+    if (--d_asyncWaiting > 0)
+        return;
+
+    if (d_asyncAborted)
+    {
+        asyncComplete(ByteVector(), std::make_exception_ptr(LibLogicalAccessException(
+                                        "The transport was closed.")));
+        return;
+    }
+
+    ByteVector res;
+    if (d_asyncTransferred > 0)
+    {
+        auto end = d_readBuffer.begin() + static_cast<std::ptrdiff_t>(d_asyncTransferred);
+        res.assign(d_readBuffer.begin(), end);
+        LOG(LogLevel::COMS) << "UDP Data read: " << BufferHelper::getHex(res);
+    }
+    else
+        d_metrics->recordTimeout();
+    asyncComplete(res, std::exception_ptr());
+}
+
+void UDPDataTransport::asyncComplete(const ByteVector &result, std::exception_ptr eptr)
+{
+    if (eptr)
+        commandFailed(eptr);
+    else
+        commandCompleted(d_asyncCommand, result,
+                         std::chrono::steady_clock::now() - d_asyncSendTime);
+    d_asyncCommands.complete(result, eptr);
+}
+
 void UDPDataTransport::serialize(boost::property_tree::ptree &parentNode)
 {
     boost::property_tree::ptree node;
@@ -134,6 +339,7 @@ void UDPDataTransport::serialize(boost::property_tree::ptree &parentNode)
     node.put("<xmlattr>.type", getTransportType());
     node.put("IpAddress", d_ipAddress);
     node.put("Port", d_port);
+    node.put("MaxDatagramSize", d_readBuffer.size());
 
     parentNode.add_child(getDefaultXmlNodeName(), node);
 }
@@ -142,6 +348,7 @@ void UDPDataTransport::unSerialize(boost::property_tree::ptree &node)
 {
     d_ipAddress = node.get_child("IpAddress").get_value<std::string>();
     d_port      = node.get_child("Port").get_value<int>();
+    setMaxDatagramSize(node.get<size_t>("MaxDatagramSize", 1024));
 }
 
 std::string UDPDataTransport::getDefaultXmlNodeName() const
@@ -0,0 +1,54 @@
+#include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include <logicalaccess/bufferhelper.hpp>
+#include "des_reference.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+using namespace logicalaccess;
+
+/**
+ * Time deciphering and MACing an 8 KB legacy DESFire file with libtomcrypt and
+ * with DESEngine. Not a unit test: run it by hand, optionally with an iteration
+ * count.
+ */
+int main(int argc, char **argv)
+{
+    const ByteVector key =
+        BufferHelper::fromHexString("0123456789abcdeffedcba9876543210");
+    const ByteVector data = make_data(8192);
+    const int iterations  = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+
+    auto run = [&](const std::function<void()> &read) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            read();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count() /
+               iterations;
+    };
+
+    ByteVector expected, result;
+    auto tomcrypt = run([&]() {
+        expected = tomcrypt_cbc(key, {}, data, RECEIVE);
+        tomcrypt_cbc(key, {}, expected, ENCRYPT);
+    });
+    auto engine = run([&]() {
+        result = DESFireCrypto::desfire_CBC_receive(key, {}, data);
+        DESFireCrypto::desfire_CBC_mac(key, {}, result);
+    });
+    if (expected != result)
+    {
+        std::cerr << "DESEngine and libtomcrypt results differ." << std::endl;
+        return 1;
+    }
+
+    std::cout << "8 KB legacy read (decipher + MAC), " << iterations
+              << " iterations: libtomcrypt " << tomcrypt << " us, DESEngine " << engine
+              << " us" << std::endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <logicalaccess/lla_fwd.hpp>
+#include <logicalaccess/plugins/crypto/tomcrypt.h>
+
+#include <cstring>
+
+namespace logicalaccess
+{
+enum TomcryptMode
+{
+    SEND,
+    RECEIVE,
+    ENCRYPT
+};
+
+/**
+ * The libtomcrypt block by block implementation replaced by DESEngine.
+ */
+inline ByteVector tomcrypt_cbc(const ByteVector &key, const ByteVector &iv,
+                               const ByteVector &data, TomcryptMode mode)
+{
+    symmetric_key skey;
+    bool is3des = key.size() == 16;
+    if (is3des)
+        des3_setup(&key[0], 16, 0, &skey);
+    else
+        des_setup(&key[0], 8, 0, &skey);
+
+    unsigned char chain[8] = {0};
+    if (iv.size() >= 8)
+        memcpy(chain, &iv[0], 8);
+
+    ByteVector ret;
+    unsigned char in[8], out[8];
+    for (size_t i = 0; i < data.size() / 8; ++i)
+    {
+        memcpy(in, &data[i * 8], 8);
+        if (mode != RECEIVE)
+        {
+            for (int j = 0; j < 8; ++j)
+                in[j] ^= chain[j];
+        }
+
+        if (mode == ENCRYPT)
+            is3des ? des3_ecb_encrypt(in, out, &skey) : des_ecb_encrypt(in, out, &skey);
+        else
+            is3des ? des3_ecb_decrypt(in, out, &skey) : des_ecb_decrypt(in, out, &skey);
+
+        if (mode == RECEIVE)
+        {
+            for (int j = 0; j < 8; ++j)
+                out[j] ^= chain[j];
+            memcpy(chain, &data[i * 8], 8);
+        }
+        else
+        {
+            memcpy(chain, out, 8);
+        }
+        ret.insert(ret.end(), out, out + 8);
+    }
+
+    is3des ? des3_done(&skey) : des_done(&skey);
+    return ret;
+}
+
+/**
+ * Deterministic test data.
+ */
+inline ByteVector make_data(size_t size)
+{
+    ByteVector data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<unsigned char>(i * 7 + 3);
+    return data;
+}
+}
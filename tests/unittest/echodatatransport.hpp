@@ -0,0 +1,64 @@
+#pragma once
+
+#include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/myexception.hpp>
+
+namespace logicalaccess
+{
+/**
+ * Test transport answering each command with its bytes incremented.
+ *
+ * An empty answer (no command sent) fails.
+ */
+class EchoDataTransport : public DataTransport
+{
+  public:
+    std::string getTransportType() const override
+    {
+        return "Echo";
+    }
+    bool connect() override
+    {
+        return true;
+    }
+    void disconnect() override
+    {
+    }
+    bool isConnected() override
+    {
+        return true;
+    }
+    std::string getName() const override
+    {
+        return "test";
+    }
+    void serialize(boost::property_tree::ptree &) override
+    {
+    }
+    void unSerialize(boost::property_tree::ptree &) override
+    {
+    }
+    std::string getDefaultXmlNodeName() const override
+    {
+        return "EchoDataTransport";
+    }
+
+  protected:
+    void send(const ByteVector &data) override
+    {
+        d_pending = data;
+    }
+    ByteVector receive(long int) override
+    {
+        if (d_pending.empty())
+            throw LibLogicalAccessException("No answer");
+        ByteVector res = d_pending;
+        for (auto &b : res)
+            ++b;
+        d_pending.clear();
+        return res;
+    }
+
+    ByteVector d_pending;
+};
+}
@@ -0,0 +1,392 @@
+#include "iks_local_server.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <grpc++/security/server_credentials.h>
+#include <grpc++/server_builder.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/aes_symmetric_key.hpp>
+#include <openssl/rand.h>
+
+namespace logicalaccess
+{
+namespace iks
+{
+namespace
+{
+ByteVector random_bytes(size_t size)
+{
+    ByteVector ret(size);
+    if (size && RAND_bytes(&ret[0], static_cast<int>(size)) != 1)
+        throw std::runtime_error("Cannot retrieve random bytes");
+    return ret;
+}
+
+ByteVector to_bytes(const std::string &str)
+{
+    return ByteVector(str.begin(), str.end());
+}
+
+ByteVector aes(const ByteVector &key, const ByteVector &iv, const ByteVector &in,
+               bool decrypt)
+{
+    ByteVector out;
+    openssl::AESCipher cipher;
+    auto symkey = openssl::AESSymmetricKey::createFromData(key);
+    auto aesiv  = iv.empty() ? openssl::AESInitializationVector::createNull()
+                            : openssl::AESInitializationVector::createFromData(iv);
+    if (decrypt)
+        cipher.decipher(in, out, symkey, aesiv, false);
+    else
+        cipher.cipher(in, out, symkey, aesiv, false);
+    return out;
+}
+
+ByteVector rotate_left(const ByteVector &in)
+{
+    ByteVector ret(in.begin() + 1, in.end());
+    ret.push_back(in[0]);
+    return ret;
+}
+
+void append_crc32(ByteVector &buf, const ByteVector &data)
+{
+    uint32_t crc = DESFireCrypto::desfire_crc32(data.data(), data.size());
+    for (int i = 0; i < 4; ++i)
+        buf.push_back(static_cast<unsigned char>(crc >> (8 * i)));
+}
+
+grpc::Status invalid(const std::string &why)
+{
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, why);
+}
+}
+
+const size_t IKSLocalServer::MAX_AUTH_CONTEXTS;
+const size_t IKSLocalServer::MAX_SESSION_KEYS;
+
+IKSLocalServer::IKSLocalServer()
+    : port_(0)
+    , run_uuid_(random_bytes(16))
+    , nonce_(0)
+{
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port_);
+    builder.RegisterService(this);
+    server_ = builder.BuildAndStart();
+    if (!server_ || port_ == 0)
+        throw std::runtime_error("Cannot start the local IKS server");
+}
+
+IKSLocalServer::~IKSLocalServer()
+{
+    server_->Shutdown();
+}
+
+void IKSLocalServer::add_key(const std::string &key_uuid, const ByteVector &key)
+{
+    std::lock_guard<std::mutex> lg(mutex_);
+    keys_[key_uuid] = key;
+}
+
+uint16_t IKSLocalServer::get_port() const
+{
+    return static_cast<uint16_t>(port_);
+}
+
+std::string IKSLocalServer::get_public_key_pem() const
+{
+    return signer_.public_key_pem();
+}
+
+grpc::Status IKSLocalServer::get_key(const std::string &key_uuid,
+                                     const KeyDiversificationInfo &div_info,
+                                     ByteVector &key)
+{
+    if (div_info.div_type() != KeyDiversificationInfo::NONE)
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                            "Key diversification is not supported");
+
+    std::lock_guard<std::mutex> lg(mutex_);
+    auto it = keys_.find(key_uuid);
+    if (it == keys_.end())
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Unknown key " + key_uuid);
+    key = it->second;
+    return grpc::Status::OK;
+}
+
+void IKSLocalServer::add_auth_context(const std::string &id, const AuthContext &ctx)
+{
+    auth_contexts_[id] = ctx;
+    auth_context_ids_.push_back(id);
+    // Ids of completed authentications are dropped here too, erase() ignores them.
+    while (auth_context_ids_.size() > MAX_AUTH_CONTEXTS)
+    {
+        auth_contexts_.erase(auth_context_ids_.front());
+        auth_context_ids_.pop_front();
+    }
+}
+
+std::string IKSLocalServer::sign(const std::string &data)
+{
+    return signer_.sign(data);
+}
+
+grpc::Status IKSLocalServer::GenRandom(grpc::ServerContext *,
+                                       const CMSG_GenRandom *request,
+                                       SMSG_GenRandom *response)
+{
+    if (request->size() < 0 || request->size() > 4096)
+        return invalid("Bad random size");
+    response->set_randombytes(
+        BufferHelper::getStdString(random_bytes(static_cast<size_t>(request->size()))));
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::AESEncrypt(grpc::ServerContext *,
+                                       const CMSG_AESOperation *request,
+                                       SMSG_AESResult *response)
+{
+    ByteVector key;
+    grpc::Status status = get_key(request->key_uuid(), request->diversification(), key);
+    if (!status.ok())
+        return status;
+    if (request->payload().size() % 16)
+        return invalid("Payload is not block aligned");
+
+    response->set_payload(BufferHelper::getStdString(
+        aes(key, to_bytes(request->iv()), to_bytes(request->payload()), false)));
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::AESDecrypt(grpc::ServerContext *,
+                                       const CMSG_AESOperation *request,
+                                       SMSG_AESResult *response)
+{
+    ByteVector key;
+    grpc::Status status = get_key(request->key_uuid(), request->diversification(), key);
+    if (!status.ok())
+        return status;
+    if (request->payload().size() % 16)
+        return invalid("Payload is not block aligned");
+
+    std::string payload = BufferHelper::getStdString(
+        aes(key, to_bytes(request->iv()), to_bytes(request->payload()), true));
+    response->set_payload(payload);
+
+    if (request->request_signature())
+    {
+        SignatureDescription *desc = response->mutable_signaturedescription();
+        desc->set_payload(payload);
+        desc->set_run_uuid(BufferHelper::getStdString(run_uuid_));
+        desc->set_timestamp(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count()));
+        {
+            std::lock_guard<std::mutex> lg(mutex_);
+            desc->set_nonce(++nonce_);
+        }
+        response->set_signature(sign(desc->SerializeAsString()));
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::DESFireISOAuth1(grpc::ServerContext *,
+                                            const CMSG_DesfireISOAuth_Step1 *request,
+                                            SMSG_DesfireISOAuth_Step1 *response)
+{
+    ByteVector key;
+    grpc::Status status = get_key(request->key_uuid(), request->diversification(), key);
+    if (!status.ok())
+        return status;
+    if (request->random_picc().size() != 16)
+        return invalid("The card random must be 16 bytes");
+
+    // Cryptogram for External Authenticate: E(RPCD1 || RPICC1).
+    AuthContext ctx;
+    ctx.key_uuid   = request->key_uuid();
+    ctx.rnd_reader = random_bytes(16);
+    ByteVector plain(ctx.rnd_reader);
+    plain.insert(plain.end(), request->random_picc().begin(),
+                 request->random_picc().end());
+    ByteVector cryptogram = aes(key, {}, plain, false);
+    ctx.iv.assign(cryptogram.end() - 16, cryptogram.end());
+    // RPCD2, the challenge for Internal Authenticate. The card echoes it back.
+    ctx.rnd_card = random_bytes(16);
+
+    std::string id = BufferHelper::getStdString(random_bytes(16));
+    response->set_success(true);
+    response->set_random2(BufferHelper::getStdString(ctx.rnd_card));
+    response->set_encrypted_cryptogram(BufferHelper::getStdString(cryptogram));
+    response->set_auth_context_id(id);
+
+    std::lock_guard<std::mutex> lg(mutex_);
+    add_auth_context(id, ctx);
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::DESFireISOAuth2(grpc::ServerContext *,
+                                            const CMSG_DesfireAuth_Step2 *request,
+                                            SMSG_DesfireAuth_Step2 *response)
+{
+    return finish_auth(request, true, response);
+}
+
+grpc::Status IKSLocalServer::DESFireAESAuth1(grpc::ServerContext *,
+                                            const CMSG_DesfireAESAuth_Step1 *request,
+                                            SMSG_DesfireAESAuth_Step1 *response)
+{
+    ByteVector key;
+    grpc::Status status = get_key(request->key_uuid(), request->diversification(), key);
+    if (!status.ok())
+        return status;
+    if (request->encrypted_random_picc().size() != 16)
+        return invalid("The encrypted card random must be 16 bytes");
+
+    // Reader part of AuthenticateAES: E(RndA || RndB <<< 1), chained on E(RndB).
+    ByteVector encRndB = to_bytes(request->encrypted_random_picc());
+    AuthContext ctx;
+    ctx.key_uuid   = request->key_uuid();
+    ctx.rnd_card   = aes(key, {}, encRndB, true);
+    ctx.rnd_reader = random_bytes(16);
+    ByteVector plain(ctx.rnd_reader);
+    ByteVector rndB1 = rotate_left(ctx.rnd_card);
+    plain.insert(plain.end(), rndB1.begin(), rndB1.end());
+    ByteVector cryptogram = aes(key, encRndB, plain, false);
+    ctx.iv.assign(cryptogram.end() - 16, cryptogram.end());
+
+    std::string id = BufferHelper::getStdString(random_bytes(16));
+    response->set_success(true);
+    response->set_encrypted_cryptogram(BufferHelper::getStdString(cryptogram));
+    response->set_auth_context_id(id);
+
+    std::lock_guard<std::mutex> lg(mutex_);
+    add_auth_context(id, ctx);
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::DESFireAESAuth2(grpc::ServerContext *,
+                                            const CMSG_DesfireAuth_Step2 *request,
+                                            SMSG_DesfireAuth_Step2 *response)
+{
+    return finish_auth(request, false, response);
+}
+
+grpc::Status IKSLocalServer::finish_auth(const CMSG_DesfireAuth_Step2 *request,
+                                         bool card_first,
+                                         SMSG_DesfireAuth_Step2 *response)
+{
+    AuthContext ctx;
+    {
+        std::lock_guard<std::mutex> lg(mutex_);
+        auto it = auth_contexts_.find(request->auth_context_id());
+        if (it == auth_contexts_.end())
+            return invalid("Unknown authentication context");
+        ctx = it->second;
+        auth_contexts_.erase(it);
+    }
+    if (ctx.key_uuid != request->key_uuid())
+        return invalid("Key mismatch between the authentication steps");
+
+    ByteVector key;
+    grpc::Status status = get_key(request->key_uuid(), request->diversification(), key);
+    if (!status.ok())
+        return status;
+
+    ByteVector cryptogram = to_bytes(request->picc_cryptogram());
+    ByteVector rndA, rndB;
+    if (card_first)
+    {
+        // Internal Authenticate response: E(RPICC2 || RPCD2).
+        if (cryptogram.size() != 32)
+            return invalid("The card cryptogram must be 32 bytes");
+        ByteVector plain = aes(key, ctx.iv, cryptogram, true);
+        rndA             = ctx.rnd_reader;
+        rndB.assign(plain.begin(), plain.begin() + 16);
+        response->set_success(ByteVector(plain.begin() + 16, plain.end()) ==
+                              ctx.rnd_card);
+    }
+    else
+    {
+        // AuthenticateAES last frame: E(RndA <<< 1).
+        if (cryptogram.size() != 16)
+            return invalid("The card cryptogram must be 16 bytes");
+        ByteVector plain = aes(key, ctx.iv, cryptogram, true);
+        rndA             = ctx.rnd_reader;
+        rndB             = ctx.rnd_card;
+        response->set_success(plain == rotate_left(ctx.rnd_reader));
+    }
+
+    if (response->success())
+    {
+        ByteVector session_key;
+        session_key.insert(session_key.end(), rndA.begin(), rndA.begin() + 4);
+        session_key.insert(session_key.end(), rndB.begin(), rndB.begin() + 4);
+        session_key.insert(session_key.end(), rndA.begin() + 12, rndA.end());
+        session_key.insert(session_key.end(), rndB.begin() + 12, rndB.end());
+
+        std::string ref = BufferHelper::getHex(random_bytes(16));
+        response->set_session_key(BufferHelper::getStdString(session_key));
+        response->set_session_key_ref(ref);
+
+        std::lock_guard<std::mutex> lg(mutex_);
+        keys_[ref] = session_key;
+        session_key_refs_.push_back(ref);
+        if (session_key_refs_.size() > MAX_SESSION_KEYS)
+        {
+            keys_.erase(session_key_refs_.front());
+            session_key_refs_.pop_front();
+        }
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status IKSLocalServer::DESFireChangeKey(grpc::ServerContext *,
+                                             const CMSG_DesfireChangeKey *request,
+                                             SMSG_DesfireChangeKey *response)
+{
+    ByteVector old_key, new_key, session_key;
+    grpc::Status status =
+        get_key(request->old_key_uuid(), request->old_key_div(), old_key);
+    if (status.ok())
+        status = get_key(request->new_key_uuid(), request->new_key_div(), new_key);
+    if (!status.ok())
+        return status;
+
+    if (!request->session_key().empty())
+        session_key = to_bytes(request->session_key());
+    else if (!(status = get_key(request->session_key_uuid(), KeyDiversificationInfo(),
+                                session_key))
+                  .ok())
+        return status;
+
+    // DESFire EV1 ChangeKey (0xC4) cryptogram, AES key version 0.
+    ByteVector key_data = new_key;
+    if (!request->change_same_key())
+    {
+        if (old_key.size() != new_key.size())
+            return invalid("The old and new keys must have the same size");
+        for (size_t i = 0; i < key_data.size(); ++i)
+            key_data[i] ^= old_key[i];
+    }
+    key_data.push_back(0x00);
+
+    ByteVector crc_data{0xC4, static_cast<unsigned char>(request->key_number())};
+    crc_data.insert(crc_data.end(), key_data.begin(), key_data.end());
+
+    ByteVector plain = key_data;
+    append_crc32(plain, crc_data);
+    if (!request->change_same_key())
+        append_crc32(plain, new_key);
+    plain.resize(((plain.size() + 15) / 16) * 16, 0x00);
+
+    response->set_cryptogram(BufferHelper::getStdString(
+        aes(session_key, to_bytes(request->iv()), plain, false)));
+    return grpc::Status::OK;
+}
+}
+}
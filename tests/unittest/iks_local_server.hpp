@@ -0,0 +1,133 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <logicalaccess/lla_fwd.hpp>
+#include <logicalaccess/plugins/iks/iks.grpc.pb.h>
+#include <grpc++/server.h>
+#include "test_signer.hpp"
+
+namespace logicalaccess
+{
+namespace iks
+{
+/**
+ * A local, in-memory stand-in for the Islog Key Server.
+ *
+ * It implements IKSService with AES keys registered by the caller, so the
+ * IKS client can be exercised and benchmarked without a live server.
+ * It listens on an ephemeral localhost port, without TLS.
+ *
+ * Key diversification is not supported.
+ */
+class IKSLocalServer : public IKSService::Service
+{
+  public:
+    /**
+     * Authentications waiting for their second step. The oldest are dropped.
+     */
+    static const size_t MAX_AUTH_CONTEXTS = 64;
+
+    /**
+     * Session keys kept after successful authentications. The oldest are dropped.
+     */
+    static const size_t MAX_SESSION_KEYS = 64;
+
+    IKSLocalServer();
+    ~IKSLocalServer();
+
+    /**
+     * Register a 16 bytes AES key.
+     */
+    void add_key(const std::string &key_uuid, const ByteVector &key);
+
+    /**
+     * The localhost port the server listens on.
+     */
+    uint16_t get_port() const;
+
+    /**
+     * PEM public key to verify the signatures issued by this server.
+     */
+    std::string get_public_key_pem() const;
+
+    grpc::Status GenRandom(grpc::ServerContext *context, const CMSG_GenRandom *request,
+                           SMSG_GenRandom *response) override;
+
+    grpc::Status AESEncrypt(grpc::ServerContext *context,
+                            const CMSG_AESOperation *request,
+                            SMSG_AESResult *response) override;
+
+    grpc::Status AESDecrypt(grpc::ServerContext *context,
+                            const CMSG_AESOperation *request,
+                            SMSG_AESResult *response) override;
+
+    grpc::Status DESFireISOAuth1(grpc::ServerContext *context,
+                                 const CMSG_DesfireISOAuth_Step1 *request,
+                                 SMSG_DesfireISOAuth_Step1 *response) override;
+
+    grpc::Status DESFireISOAuth2(grpc::ServerContext *context,
+                                 const CMSG_DesfireAuth_Step2 *request,
+                                 SMSG_DesfireAuth_Step2 *response) override;
+
+    grpc::Status DESFireAESAuth1(grpc::ServerContext *context,
+                                 const CMSG_DesfireAESAuth_Step1 *request,
+                                 SMSG_DesfireAESAuth_Step1 *response) override;
+
+    grpc::Status DESFireAESAuth2(grpc::ServerContext *context,
+                                 const CMSG_DesfireAuth_Step2 *request,
+                                 SMSG_DesfireAuth_Step2 *response) override;
+
+    grpc::Status DESFireChangeKey(grpc::ServerContext *context,
+                                  const CMSG_DesfireChangeKey *request,
+                                  SMSG_DesfireChangeKey *response) override;
+
+  private:
+    /**
+     * State kept between the two steps of a DESFire authentication.
+     */
+    struct AuthContext
+    {
+        std::string key_uuid;
+        ByteVector rnd_reader;
+        ByteVector rnd_card;
+        ByteVector iv;
+    };
+
+    grpc::Status get_key(const std::string &key_uuid,
+                         const KeyDiversificationInfo &div_info, ByteVector &key);
+
+    /**
+     * Complete an authentication: check the card cryptogram and derive the session key.
+     *
+     * \param card_first Whether the card random comes first in the deciphered cryptogram.
+     */
+    grpc::Status finish_auth(const CMSG_DesfireAuth_Step2 *request, bool card_first,
+                             SMSG_DesfireAuth_Step2 *response);
+
+    std::string sign(const std::string &data);
+
+    /**
+     * Keep an authentication context, dropping the oldest ones.
+     * Must be called with mutex_ held.
+     */
+    void add_auth_context(const std::string &id, const AuthContext &ctx);
+
+    std::unique_ptr<grpc::Server> server_;
+    int port_;
+
+    std::mutex mutex_;
+    std::map<std::string, ByteVector> keys_;
+    std::map<std::string, AuthContext> auth_contexts_;
+    std::deque<std::string> auth_context_ids_;
+    std::deque<std::string> session_key_refs_;
+
+    TestSigner signer_;
+    ByteVector run_uuid_;
+    uint64_t nonce_;
+};
+}
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/replaydatatransport.hpp>
+#include <logicalaccess/readerproviders/tracerecorder.hpp>
+#include <logicalaccess/myexception.hpp>
+#include "echodatatransport.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace logicalaccess;
+
+TEST(test_apdu_trace, record_and_replay)
+{
+    const std::string filename = "test_apdu_trace.bin";
+    {
+        auto recorder = std::make_shared<TraceRecorder>(filename);
+        TraceRecorder::setGlobal(recorder);
+
+        EchoDataTransport transport;
+        ASSERT_EQ(ByteVector({0x91, 0x01}), transport.sendCommand({0x90, 0x00}));
+        ASSERT_EQ(ByteVector({0x02}), transport.sendCommand({0x01}));
+        ASSERT_THROW(transport.sendCommand({}), LibLogicalAccessException);
+
+        TraceRecorder::setGlobal(nullptr);
+        ASSERT_EQ(6u, recorder->getRecordCount());
+    }
+
+    TraceReader reader(filename);
+    const auto &records = reader.getRecords();
+    ASSERT_EQ(6u, records.size());
+    ASSERT_EQ("Echo:test", records[0].transport);
+    ASSERT_EQ(TraceDirection::Command, records[0].direction);
+    ASSERT_EQ(TraceDirection::Response, records[1].direction);
+    ASSERT_EQ(ByteVector({0x91, 0x01}), records[1].data);
+    ASSERT_EQ(TraceDirection::Error, records[5].direction);
+    ASSERT_LE(records[0].timestamp, records[5].timestamp);
+
+    ReplayDataTransport replay(filename);
+    ASSERT_EQ(ByteVector({0x91, 0x01}), replay.sendCommand({0x90, 0x00}));
+    ASSERT_EQ(ByteVector({0x02}), replay.sendCommand({0x01}));
+    ASSERT_FALSE(replay.isFinished());
+    ASSERT_THROW(replay.sendCommand({}), LibLogicalAccessException);
+    ASSERT_TRUE(replay.isFinished());
+
+    replay.rewind();
+    ASSERT_THROW(replay.sendCommand({0x90, 0x01}), LibLogicalAccessException);
+
+    replay.rewind();
+    replay.setStrict(false);
+    ASSERT_EQ(ByteVector({0x91, 0x01}), replay.sendCommand({0x90, 0x01}));
+
+    std::remove(filename.c_str());
+}
+
+TEST(test_apdu_trace, replay_is_not_recorded)
+{
+    const std::string filename = "test_apdu_trace_replay.bin";
+    const std::string copy     = "test_apdu_trace_replay_copy.bin";
+    {
+        auto recorder = std::make_shared<TraceRecorder>(filename);
+        TraceRecorder::setGlobal(recorder);
+        EchoDataTransport transport;
+        transport.sendCommand({0x01});
+        TraceRecorder::setGlobal(nullptr);
+    }
+
+    {
+        auto recorder = std::make_shared<TraceRecorder>(copy);
+        TraceRecorder::setGlobal(recorder);
+        ReplayDataTransport replay(filename);
+        ASSERT_EQ(ByteVector({0x02}), replay.sendCommand({0x01}));
+        ASSERT_THROW(replay.sendCommand({0x01}), LibLogicalAccessException);
+        TraceRecorder::setGlobal(nullptr);
+        ASSERT_EQ(0u, recorder->getRecordCount());
+    }
+
+    std::remove(filename.c_str());
+    std::remove(copy.c_str());
+}
+
+TEST(test_apdu_trace, bogus_record_length)
+{
+    const std::string filename = "test_apdu_trace_bogus.bin";
+    {
+        auto recorder = std::make_shared<TraceRecorder>(filename);
+        recorder->record("Echo:test", TraceDirection::Command, {0x01, 0x02});
+    }
+
+    // Patch the record length to 0xffffffff.
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-6, std::ios::end);
+    const char length[4] = {'\xff', '\xff', '\xff', '\xff'};
+    file.write(length, sizeof(length));
+    file.close();
+
+    ASSERT_THROW(TraceReader reader(filename), LibLogicalAccessException);
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/tcpdatatransport.hpp>
+#include "echodatatransport.hpp"
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A TCP server on an ephemeral localhost port, echoing what it reads unless silent.
+ */
+class EchoPeer
+{
+  public:
+    explicit EchoPeer(bool silent = false)
+        : d_silent(silent)
+        , d_acceptor(d_ios, boost::asio::ip::tcp::endpoint(
+                                boost::asio::ip::address_v4::loopback(), 0))
+    {
+        accept();
+        d_thread = std::thread([this]() { d_ios.run(); });
+    }
+
+    ~EchoPeer()
+    {
+        d_ios.stop();
+        d_thread.join();
+    }
+
+    int getPort() const
+    {
+        return d_acceptor.local_endpoint().port();
+    }
+
+  private:
+    struct Session
+    {
+        explicit Session(boost::asio::io_service &ios)
+            : socket(ios)
+            , buffer(256)
+        {
+        }
+
+        boost::asio::ip::tcp::socket socket;
+        ByteVector buffer;
+    };
+
+    void accept()
+    {
+        auto session = std::make_shared<Session>(d_ios);
+        d_acceptor.async_accept(session->socket,
+                                [this, session](const boost::system::error_code &ec) {
+                                    if (ec)
+                                        return;
+                                    read(session);
+                                    accept();
+                                });
+    }
+
+    void read(std::shared_ptr<Session> session)
+    {
+        session->socket.async_read_some(
+            boost::asio::buffer(session->buffer),
+            [this, session](const boost::system::error_code &ec, size_t len) {
+                if (ec)
+                    return;
+                if (d_silent)
+                {
+                    read(session);
+                    return;
+                }
+                boost::asio::async_write(
+                    session->socket, boost::asio::buffer(session->buffer.data(), len),
+                    [this, session](const boost::system::error_code &wec, size_t) {
+                        if (!wec)
+                            read(session);
+                    });
+            });
+    }
+
+    bool d_silent;
+    boost::asio::io_service d_ios;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    std::thread d_thread;
+};
+
+void setup(TCPDataTransport &transport, const EchoPeer &peer, bool persistent)
+{
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(peer.getPort());
+    transport.setPersistentConnection(persistent);
+}
+}
+
+TEST(test_async_send_command, future)
+{
+    auto transport = std::make_shared<EchoDataTransport>();
+
+    auto res = transport->asyncSendCommand({0x90, 0x00}, 1000);
+    ASSERT_EQ(ByteVector({0x91, 0x01}), res.get());
+
+    auto failed = transport->asyncSendCommand(ByteVector(), 1000);
+    ASSERT_THROW(failed.get(), LibLogicalAccessException);
+}
+
+TEST(test_async_send_command, ordered_callbacks)
+{
+    auto transport = std::make_shared<EchoDataTransport>();
+    std::mutex mutex;
+    std::vector<uint8_t> order;
+
+    for (uint8_t i = 0; i < 50; ++i)
+    {
+        transport->asyncSendCommand({i}, 1000,
+                                    [&](const ByteVector &res, std::exception_ptr eptr) {
+                                        std::lock_guard<std::mutex> lg(mutex);
+                                        if (!eptr && res.size() == 1)
+                                            order.push_back(res[0]);
+                                    });
+    }
+    // Commands of one transport run in order: this one completes last.
+    transport->asyncSendCommand({0xff}, 1000).get();
+
+    std::lock_guard<std::mutex> lg(mutex);
+    ASSERT_EQ(50u, order.size());
+    for (uint8_t i = 0; i < 50; ++i)
+        ASSERT_EQ(i + 1, order[i]);
+}
+
+TEST(test_async_send_command, tcp_ordered_commands)
+{
+    for (bool persistent : {true, false})
+    {
+        EchoPeer peer;
+        TCPDataTransport transport;
+        setup(transport, peer, persistent);
+
+        std::list<std::future<ByteVector>> results;
+        for (uint8_t i = 0; i < 20; ++i)
+            results.push_back(transport.asyncSendCommand({i, 0x42}, 1000));
+
+        uint8_t i = 0;
+        for (auto &res : results)
+            ASSERT_EQ(ByteVector({i++, 0x42}), res.get());
+        ASSERT_EQ(20u, transport.getMetrics()->getCommandCount());
+    }
+}
+
+TEST(test_async_send_command, tcp_many_transports)
+{
+    EchoPeer peer;
+    std::vector<std::unique_ptr<TCPDataTransport>> transports;
+    std::vector<std::future<ByteVector>> results;
+    for (uint8_t i = 0; i < 64; ++i)
+    {
+        transports.emplace_back(new TCPDataTransport());
+        setup(*transports.back(), peer, true);
+        results.push_back(transports.back()->asyncSendCommand({i}, 2000));
+    }
+    // More readers than reactor threads make progress at once.
+    for (uint8_t i = 0; i < 64; ++i)
+        ASSERT_EQ(ByteVector({i}), results[i].get());
+}
+
+TEST(test_async_send_command, tcp_timeout)
+{
+    EchoPeer peer(true);
+    TCPDataTransport transport;
+    setup(transport, peer, true);
+
+    auto res = transport.asyncSendCommand({0x01}, 100);
+    ASSERT_EQ(std::future_status::ready, res.wait_for(std::chrono::seconds(5)));
+    ASSERT_THROW(res.get(), LibLogicalAccessException);
+    ASSERT_EQ(1u, transport.getMetrics()->getTimeoutCount());
+}
+
+TEST(test_async_send_command, tcp_destroyed_while_pending)
+{
+    EchoPeer peer(true);
+    std::promise<bool> failed;
+    auto notified = failed.get_future();
+    {
+        TCPDataTransport transport;
+        setup(transport, peer, true);
+        transport.asyncSendCommand({0x01}, 60000,
+                                   [&](const ByteVector &, std::exception_ptr eptr) {
+                                       failed.set_value(eptr != nullptr);
+                                   });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(std::future_status::ready, notified.wait_for(std::chrono::seconds(5)));
+    ASSERT_TRUE(notified.get());
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/readerproviders/delimiterbufferparser.hpp>
+#include <logicalaccess/readerproviders/lengthprefixbufferparser.hpp>
+
+using namespace logicalaccess;
+
+static void push(boost::circular_buffer<unsigned char> &cb, const std::string &hex)
+{
+    ByteVector data = BufferHelper::fromHexString(hex);
+    cb.insert(cb.end(), data.begin(), data.end());
+}
+
+TEST(test_buffer_parser, length_prefix_partial_frame)
+{
+    // Rpleth like frame: 3 bytes header, 1 byte length, data, 1 byte checksum.
+    LengthPrefixBufferParser parser(3, 1, 4, 1);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    push(cb, "0001");
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    push(cb, "0203AABB");
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    push(cb, "CC");
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    push(cb, "DD");
+    ASSERT_EQ(BufferHelper::fromHexString("00010203AABBCCDD"), parser.getValidBuffer(cb));
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(test_buffer_parser, length_prefix_keeps_trailing_bytes)
+{
+    LengthPrefixBufferParser parser(0, 2, 2, 0, false);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    push(cb, "0200AABB0100CC01");
+    ASSERT_EQ(BufferHelper::fromHexString("0200AABB"), parser.getValidBuffer(cb));
+    ASSERT_EQ(BufferHelper::fromHexString("0100CC"), parser.getValidBuffer(cb));
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    ASSERT_EQ(1u, cb.size());
+}
+
+TEST(test_buffer_parser, delimiter_with_checksum)
+{
+    DelimiterBufferParser parser(0x02, 0x03, 1);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    push(cb, "FFFF02AABB03");
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    push(cb, "1102CC");
+    ASSERT_EQ(BufferHelper::fromHexString("02AABB0311"), parser.getValidBuffer(cb));
+    ASSERT_EQ(BufferHelper::fromHexString("02CC"),
+              ByteVector(cb.begin(), cb.end()));
+}
+
+TEST(test_buffer_parser, length_prefix_bad_checksum_resync)
+{
+    // A small maximum length keeps misaligned headers from waiting for more data.
+    LengthPrefixBufferParser parser(3, 1, 4, 1, true, FrameChecksum::XOR8, 8);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    // Bad checksum, then a valid frame: 00 ^ 01 ^ 02 ^ 01 ^ AA = A8.
+    push(cb, "0001020155FF");
+    push(cb, "00010201AAA8");
+    ASSERT_EQ(BufferHelper::fromHexString("00010201AAA8"), parser.getValidBuffer(cb));
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(test_buffer_parser, length_prefix_bogus_length_resync)
+{
+    LengthPrefixBufferParser parser(0, 2, 2, 1, true, FrameChecksum::SUM8, 16);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    // A length of 0xFFFF would never complete: resynchronize on the next frame.
+    push(cb, "FFFF");
+    ASSERT_TRUE(parser.getValidBuffer(cb).empty());
+    ASSERT_EQ(1u, cb.size());
+    push(cb, "0001AAAB");
+    ASSERT_EQ(BufferHelper::fromHexString("0001AAAB"), parser.getValidBuffer(cb));
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(test_buffer_parser, delimiter_bad_checksum_resync)
+{
+    DelimiterBufferParser parser(0x02, 0x03, 1, FrameChecksum::XOR8);
+    boost::circular_buffer<unsigned char> cb(64);
+
+    // 02 ^ AA ^ 03 = AB.
+    push(cb, "02AA0300");
+    push(cb, "02AA03AB");
+    ASSERT_EQ(BufferHelper::fromHexString("02AA03AB"), parser.getValidBuffer(cb));
+    ASSERT_TRUE(cb.empty());
+}
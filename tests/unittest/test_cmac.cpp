@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/plugins/crypto/des_cipher.hpp>
+
+using namespace logicalaccess;
+using namespace logicalaccess::openssl;
+
+static const ByteVector MESSAGE = BufferHelper::fromHexString(
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+
+TEST(test_cmac, aes_nist_vectors)
+{
+    // NIST SP 800-38B D.1
+    ByteVector key = BufferHelper::fromHexString("2b7e151628aed2a6abf7158809cf4f3c");
+    auto cipher    = std::make_shared<AESCipher>();
+    CMACContext context(key, cipher);
+
+    ASSERT_EQ(BufferHelper::fromHexString("fbeed618357133667c85e08f7236a8de"),
+              context.getK1());
+    ASSERT_EQ(BufferHelper::fromHexString("f7ddac306ae266ccf90bc11ee46d513b"),
+              context.getK2());
+
+    const std::pair<size_t, const char *> vectors[] = {
+        {0, "bb1d6929e95937287fa37d129b756746"},
+        {16, "070a16b46b4d4144f79bdd9dd04a287c"},
+        {40, "dfa66747de9ae63030ca32611497c827"},
+        {64, "51f0bebf7e3b9d92fc49741779363cfe"}};
+
+    for (const auto &vector : vectors)
+    {
+        ByteVector data(MESSAGE.begin(), MESSAGE.begin() + vector.first);
+        ByteVector expected = BufferHelper::fromHexString(vector.second);
+        ASSERT_EQ(expected, context.cmac(data));
+        ASSERT_EQ(expected, CMACCrypto::cmac(key, cipher, data));
+
+        // Same result whatever the update sizes.
+        for (size_t chunk = 1; chunk <= 17; ++chunk)
+        {
+            context.start();
+            for (size_t i = 0; i < data.size(); i += chunk)
+            {
+                context.update(ByteVector(data.begin() + i,
+                                          data.begin() + std::min(i + chunk, data.size())));
+            }
+            ASSERT_EQ(expected, context.stop());
+        }
+    }
+}
+
+TEST(test_cmac, streaming_matches_one_shot)
+{
+    ByteVector key = BufferHelper::fromHexString("0123456789abcdeffedcba9876543210");
+    ByteVector iv  = BufferHelper::fromHexString("1122334455667788");
+    auto cipher    = std::make_shared<DESCipher>();
+    CMACContext context(key, cipher);
+
+    ASSERT_TRUE(context.matches(key, cipher));
+    ASSERT_FALSE(context.matches(key, std::make_shared<AESCipher>()));
+    ASSERT_FALSE(context.matches(ByteVector(16, 0x00), cipher));
+
+    for (size_t length = 0; length <= MESSAGE.size(); length += 5)
+    {
+        ByteVector data(MESSAGE.begin(), MESSAGE.begin() + length);
+        for (unsigned int padding : {0u, 16u})
+        {
+            for (bool forceK2 : {false, true})
+            {
+                ByteVector expected =
+                    CMACCrypto::cmac(key, cipher, data, iv, padding, forceK2);
+                ASSERT_EQ(expected, context.cmac(data, iv, padding, forceK2));
+
+                context.start(iv);
+                context.update(ByteVector(data.begin(), data.begin() + length / 2));
+                context.update(ByteVector(data.begin() + length / 2, data.end()));
+                ASSERT_EQ(expected, context.stop(padding, forceK2));
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include <logicalaccess/plugins/crypto/des_engine.hpp>
+#include "des_reference.hpp"
+
+using namespace logicalaccess;
+
+TEST(test_des_engine, matches_tomcrypt)
+{
+    const ByteVector keys[] = {
+        BufferHelper::fromHexString("0123456789abcdef0123456789abcdef"),
+        BufferHelper::fromHexString("0123456789abcdeffedcba9876543210")};
+    const ByteVector ivs[] = {ByteVector(), BufferHelper::fromHexString("1122334455667788")};
+
+    for (const auto &key : keys)
+    {
+        // Identical halves: single DES.
+        ByteVector tomcryptKey = memcmp(&key[0], &key[8], 8)
+                                     ? key
+                                     : ByteVector(key.begin(), key.begin() + 8);
+        for (const auto &iv : ivs)
+        {
+            for (size_t size : {0, 8, 20, 64, 4096})
+            {
+                ByteVector data = make_data(size);
+                ASSERT_EQ(tomcrypt_cbc(tomcryptKey, iv, data, SEND),
+                          DESFireCrypto::desfire_CBC_send(key, iv, data));
+                ASSERT_EQ(tomcrypt_cbc(tomcryptKey, iv, data, RECEIVE),
+                          DESFireCrypto::desfire_CBC_receive(key, iv, data));
+                ASSERT_EQ(tomcrypt_cbc(tomcryptKey, iv, data, ENCRYPT),
+                          DESFireCrypto::sam_CBC_send(key, iv, data));
+            }
+        }
+    }
+
+    // The engine keeps its key schedule between calls.
+    openssl::DESEngine engine(keys[1]);
+    ByteVector data = make_data(64);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(tomcrypt_cbc(keys[1], ivs[1], data, ENCRYPT),
+                  engine.cbcEncrypt(ivs[1], data));
+        ASSERT_EQ(tomcrypt_cbc(keys[1], ivs[1], data, RECEIVE),
+                  engine.cbcDecrypt(ivs[1], data));
+        ASSERT_EQ(tomcrypt_cbc(keys[1], {}, data, SEND), engine.cbcSendDecipher({}, data));
+    }
+}
+
+TEST(test_des_engine, session_engine_follows_key)
+{
+    DESFireCrypto crypto;
+    crypto.d_auth_method = CM_LEGACY;
+    const ByteVector data = make_data(20);
+
+    for (const char *hex :
+         {"0123456789abcdef0123456789abcdef", "0123456789abcdeffedcba9876543210"})
+    {
+        crypto.d_sessionKey = BufferHelper::fromHexString(hex);
+        for (int i = 0; i < 2; ++i)
+        {
+            ASSERT_EQ(DESFireCrypto::desfire_mac(crypto.d_sessionKey, data),
+                      crypto.generateMAC(0, data));
+            ASSERT_EQ(DESFireCrypto::desfire_encrypt(crypto.d_sessionKey, data),
+                      crypto.desfireEncrypt(data));
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/aes_symmetric_key.hpp>
+#include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfireev1chip.hpp>
+#include <logicalaccess/plugins/cards/iso7816/readercardadapters/iso7816readercardadapter.hpp>
+#include <logicalaccess/plugins/readers/iso7816/commands/desfireev1iso7816commands.hpp>
+#include "echodatatransport.hpp"
+
+using namespace logicalaccess;
+
+namespace
+{
+const ByteVector SESSION_KEY =
+    BufferHelper::fromHexString("00112233445566778899aabbccddeeff");
+
+void setupSession(DESFireCrypto &crypto)
+{
+    crypto.d_auth_method = CM_ISO;
+    crypto.d_cipher      = std::make_shared<openssl::AESCipher>();
+    crypto.d_sessionKey  = SESSION_KEY;
+    crypto.d_mac_size    = 8;
+    crypto.d_lastIV      = ByteVector(16, 0x00);
+}
+
+ByteVector makeData(size_t size)
+{
+    ByteVector data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<unsigned char>(i * 13 + 1);
+    return data;
+}
+
+/**
+ * Cipher data as a DESFire EV1 card does: data | CRC32(data | status) | padding.
+ * The padding starts with 0x80 when the reader did not give the data length.
+ */
+ByteVector cardEncrypt(const ByteVector &data, bool lengthUnknown)
+{
+    ByteVector crcbuf = data;
+    crcbuf.push_back(0x00);
+    uint32_t crc     = DESFireCrypto::desfire_crc32(crcbuf.data(), crcbuf.size());
+    ByteVector plain = data;
+    for (int i = 0; i < 4; ++i)
+        plain.push_back(static_cast<unsigned char>(crc >> (8 * i)));
+    if (lengthUnknown)
+        plain.push_back(0x80);
+    if (plain.size() % 16)
+    {
+        plain.resize(((plain.size() + 15) / 16) * 16, 0x00);
+    }
+
+    ByteVector ret;
+    openssl::AESCipher().cipher(plain, ret,
+                                openssl::AESSymmetricKey::createFromData(SESSION_KEY),
+                                openssl::AESInitializationVector::createNull(), false);
+    return ret;
+}
+
+ByteVector cardMAC(const ByteVector &data)
+{
+    ByteVector macbuf = data;
+    macbuf.push_back(0x00);
+    ByteVector mac = openssl::CMACCrypto::cmac(SESSION_KEY,
+                                               std::make_shared<openssl::AESCipher>(),
+                                               macbuf, ByteVector(16, 0x00), 16);
+    ByteVector received = data;
+    received.insert(received.end(), mac.begin(), mac.begin() + 8);
+    return received;
+}
+
+/**
+ * Transport of a card removed from the field.
+ */
+class RemovedCardDataTransport : public EchoDataTransport
+{
+  protected:
+    ByteVector receive(long int) override
+    {
+        throw LibLogicalAccessException("Card removed");
+    }
+};
+
+class TestDESFireEV1Commands : public DESFireEV1ISO7816Commands
+{
+  public:
+    using DESFireEV1ISO7816Commands::handleReadData;
+};
+}
+
+TEST(test_desfire_streaming, decipher_by_frame)
+{
+    for (size_t size : {0, 11, 12, 28, 300, 8192})
+    {
+        ByteVector data = makeData(size);
+
+        for (size_t length : {size_t(0), size})
+        {
+            ByteVector encrypted = cardEncrypt(data, length == 0);
+            DESFireCrypto crypto;
+            setupSession(crypto);
+            crypto.initBuf();
+            // 59 bytes frames, as returned by the card.
+            for (size_t i = 0; i < encrypted.size(); i += 59)
+            {
+                crypto.appendDecipherData(
+                    ByteVector(encrypted.begin() + i,
+                               encrypted.begin() + std::min(i + 59, encrypted.size())));
+            }
+            ASSERT_EQ(data, crypto.desfireDecrypt(length));
+            ASSERT_EQ(ByteVector(encrypted.end() - 16, encrypted.end()), crypto.d_lastIV);
+        }
+    }
+
+    // A corrupted frame is detected by the CRC.
+    ByteVector encrypted = cardEncrypt(makeData(300), false);
+    encrypted[100] ^= 0x01;
+    DESFireCrypto crypto;
+    setupSession(crypto);
+    crypto.initBuf();
+    crypto.appendDecipherData(encrypted);
+    ASSERT_THROW(crypto.desfireDecrypt(300), LibLogicalAccessException);
+}
+
+TEST(test_desfire_streaming, mac_by_frame)
+{
+    ByteVector received = cardMAC(makeData(500));
+
+    DESFireCrypto oneShot;
+    setupSession(oneShot);
+    oneShot.initBuf();
+    ASSERT_TRUE(oneShot.verifyMAC(true, received));
+
+    DESFireCrypto streamed;
+    setupSession(streamed);
+    streamed.initBuf();
+    for (size_t i = 0; i < received.size(); i += 59)
+    {
+        streamed.verifyMAC(false, ByteVector(received.begin() + i,
+                                             received.begin() +
+                                                 std::min(i + 59, received.size())));
+    }
+    ASSERT_TRUE(streamed.verifyMAC(true, ByteVector()));
+    ASSERT_EQ(oneShot.d_lastIV, streamed.d_lastIV);
+
+    received[10] ^= 0x01;
+    setupSession(streamed);
+    streamed.initBuf();
+    streamed.verifyMAC(false, received);
+    ASSERT_FALSE(streamed.verifyMAC(true, ByteVector()));
+}
+
+TEST(test_desfire_streaming, read_failing_midway)
+{
+    auto chip    = std::make_shared<DESFireEV1Chip>();
+    auto adapter = std::make_shared<ISO7816ReaderCardAdapter>();
+    adapter->setDataTransport(std::make_shared<RemovedCardDataTransport>());
+    TestDESFireEV1Commands commands;
+    commands.setChip(chip);
+    commands.setReaderCardAdapter(adapter);
+    auto crypto = chip->getCrypto();
+
+    for (EncryptionMode mode : {CM_MAC, CM_ENCRYPT})
+    {
+        setupSession(*crypto);
+        ASSERT_THROW(
+            commands.handleReadData(DF_INS_ADDITIONAL_FRAME, makeData(59), 0, mode),
+            LibLogicalAccessException);
+
+        // The next MAC verification (ChangeKey, GetVersion...) starts afresh.
+        setupSession(*crypto);
+        ASSERT_TRUE(crypto->verifyMAC(true, cardMAC(makeData(28))));
+    }
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/plugins/cards/desfire/nxpav1keydiversification.hpp>
 #include <logicalaccess/plugins/cards/desfire/nxpav2keydiversification.hpp>
+#include <logicalaccess/plugins/cards/desfire/omnitechkeydiversification.hpp>
 #include <logicalaccess/plugins/cards/desfire/desfirekey.hpp>
+#include <logicalaccess/plugins/cards/desfire/sagemkeydiversification.hpp>
 #include "logicalaccess/bufferhelper.hpp"
 #include "logicalaccess/plugins/crypto/signature_helper.hpp"
 
@@ -39,3 +42,83 @@ TEST(test_diversificaiton, av2_2)
     ASSERT_EQ(BufferHelper::fromHexString("0bb408baff98b6ee9f2e1585777f6a51"),
               diversified);
 }
+
+TEST(test_diversificaiton, av2_batch)
+{
+    const std::pair<DESFireKeyType, const char *> masters[] = {
+        {DF_KEY_AES, "00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF"},
+        {DF_KEY_DES, "00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF"},
+        {DF_KEY_3K3DES,
+         "00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF 01 23 45 67 89 AB CD EF"}};
+
+    std::vector<ByteVector> inputs;
+    for (unsigned char i = 0; i < 50; ++i)
+        inputs.push_back(ByteVector{0x04, 0x78, 0x2E, i, 0x80, 0x1D, 0x80, 0x30, i});
+
+    for (const auto &master : masters)
+    {
+        auto k = std::make_shared<DESFireKey>();
+        k->setKeyType(master.first);
+        k->fromString(master.second);
+        auto div = std::make_shared<NXPAV2KeyDiversification>();
+
+        std::vector<ByteVector> expected;
+        for (const auto &input : inputs)
+            expected.push_back(div->getDiversifiedKey(k, input));
+
+        ASSERT_EQ(expected, div->getDiversifiedKeys(k, inputs));
+        ASSERT_EQ(expected, div->getDiversifiedKeys(k, inputs, 4));
+        ASSERT_EQ(expected, div->getDiversifiedKeys(k, inputs, 0));
+    }
+}
+
+TEST(test_diversificaiton, av1_aes)
+{
+    auto k = std::make_shared<DESFireKey>();
+    k->setKeyType(DF_KEY_AES);
+    k->fromString("00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF");
+
+    auto div = std::make_shared<NXPAV1KeyDiversification>();
+    ASSERT_EQ(BufferHelper::fromHexString("67423557CA0509243B9EE04A5DA3448A"),
+              div->getDiversifiedKey(
+                  k, BufferHelper::fromHexString("000102030405060708090A0B0C0D0E0F")));
+}
+
+TEST(test_diversificaiton, sagem)
+{
+    auto k = std::make_shared<DESFireKey>();
+    k->setKeyType(DF_KEY_DES);
+    k->fromString("00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF");
+
+    auto div = std::make_shared<SagemKeyDiversification>();
+    ASSERT_EQ(BufferHelper::fromHexString("7C94D4AB991B841B7C94D4AB991B841B"),
+              div->getDiversifiedKey(k, ByteVector(16, 0x03)));
+}
+
+TEST(test_diversificaiton, des_batch)
+{
+    const std::pair<DESFireKeyType, std::shared_ptr<KeyDiversification>> divs[] = {
+        {DF_KEY_DES, std::make_shared<NXPAV1KeyDiversification>()},
+        {DF_KEY_AES, std::make_shared<NXPAV1KeyDiversification>()},
+        {DF_KEY_DES, std::make_shared<OmnitechKeyDiversification>()},
+        {DF_KEY_DES, std::make_shared<SagemKeyDiversification>()}};
+
+    for (const auto &div : divs)
+    {
+        auto k = std::make_shared<DESFireKey>();
+        k->setKeyType(div.first);
+        k->fromString("00 11 22 33 44 55 66 77 88 99 AA BB CC DD EE FF");
+
+        std::vector<ByteVector> inputs;
+        for (unsigned char i = 0; i < 10; ++i)
+            inputs.push_back(ByteVector(16, i));
+
+        std::vector<ByteVector> expected;
+        for (const auto &input : inputs)
+            expected.push_back(div.second->getDiversifiedKey(k, input));
+
+        ASSERT_EQ(expected, div.second->getDiversifiedKeys(k, inputs));
+        ASSERT_EQ(expected, div.second->getDiversifiedKeys(k, inputs, 3));
+        ASSERT_TRUE(div.second->getDiversifiedKeys(k, {}, 3).empty());
+    }
+}
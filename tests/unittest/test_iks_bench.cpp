@@ -1,6 +1,6 @@
 #include <logicalaccess/iks/IslogKeyServer.hpp>
 #include <thread>
-#include <logicalaccess/logs.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/iks/RemoteCrypto.hpp>
 #include <logicalaccess/utils.hpp>
 #include <iomanip>
@@ -11,6 +11,13 @@
 #include <string>
 #include <iostream>
 #include <logicalaccess/plugins/iks/IKSRPCClient.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/aes_symmetric_key.hpp>
+#include <atomic>
+#include <openssl/rand.h>
+#include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include "iks_local_server.hpp"
 
 using namespace logicalaccess;
 using namespace iks;
@@ -172,18 +179,54 @@ struct TestResultAgg
 
 TestResultAgg *test_result_aggregator;
 
-static void test_aes_key(size_t payload_size, size_t iterations,
+static std::atomic<bool> bench_failed{false};
+
+static void bench_failure(const std::string &what)
+{
+    std::unique_lock<decltype(lock)> ul(lock);
+    std::cout << "FAILURE: " << what << std::endl;
+    bench_failed = true;
+}
+
+static ByteVector random_bytes(size_t size)
+{
+    ByteVector ret(size);
+    RAND_bytes(&ret[0], static_cast<int>(size));
+    return ret;
+}
+
+static ByteVector card_aes(const ByteVector &key, const ByteVector &iv,
+                           const ByteVector &in, bool decrypt)
+{
+    ByteVector out;
+    openssl::AESCipher cipher;
+    auto symkey = openssl::AESSymmetricKey::createFromData(key);
+    auto aesiv  = openssl::AESInitializationVector::createFromData(iv);
+    if (decrypt)
+        cipher.decipher(in, out, symkey, aesiv, false);
+    else
+        cipher.cipher(in, out, symkey, aesiv, false);
+    return out;
+}
+
+static ByteVector rotate_left(const ByteVector &in)
+{
+    ByteVector ret(in.begin() + 1, in.end());
+    ret.push_back(in[0]);
+    return ret;
+}
+
+static void test_aes_key(iks::IKSRPCClient &rpc, const std::string &prefix,
+                         size_t payload_size, size_t iterations,
                          const std::string &key_uuid, bool with_signature)
 {
     TestResult test_result{.nb_itr = iterations, .op_per_itr = 2};
 
-    std::string test_name = "test_aes" + std::to_string(payload_size);
+    std::string test_name = prefix + "test_aes" + std::to_string(payload_size);
     if (with_signature)
         test_name += "_with_signature";
     test_result.name = test_name;
 
-    iks::IKSRPCClient rpc(iks::IslogKeyServer::get_global_config());
-
     // Build payload
     auto payload = ByteVector{};
     for (int i = 0; i < payload_size; ++i)
@@ -201,101 +244,313 @@ static void test_aes_key(size_t payload_size, size_t iterations,
         auto decrypted = rpc.aes_decrypt(encrypted, key_uuid, iv, sr_ptr);
         if (payload != decrypted)
         {
-            std::cout << "Failed at operation " << count << std::endl;
-            assert(payload == decrypted);
+            bench_failure(test_name + " at operation " + std::to_string(count));
+            return;
+        }
+
+        test_result.update_extreme_itr(itr_etc.elapsed_micro());
+    }
+    test_result.total_elapsed_ms = etc.elapsed();
+    test_result_aggregator->record_test_result(test_result);
+}
+
+static void test_aes_batch(iks::IKSRPCClient &rpc, const std::string &prefix,
+                           size_t batch_size, size_t iterations,
+                           const std::string &key_uuid)
+{
+    TestResult test_result{.nb_itr = iterations, .op_per_itr = int(2 * batch_size)};
+    test_result.name = prefix + "test_aes16_batch" + std::to_string(batch_size);
+
+    std::vector<AESOperation> ops(batch_size);
+    for (size_t i = 0; i < batch_size; ++i)
+    {
+        ops[i].key_name = key_uuid;
+        ops[i].iv       = ByteVector(16, 0x00);
+        ops[i].payload  = ByteVector(16, static_cast<uint8_t>(i));
+    }
+
+    ElapsedTimeCounter etc;
+    for (uint64_t count = 0; count < test_result.nb_itr; ++count)
+    {
+        ElapsedTimeCounter itr_etc;
+
+        auto encrypted = rpc.aes_encrypt_batch(ops);
+        std::vector<AESOperation> decrypt_ops = ops;
+        for (size_t i = 0; i < batch_size; ++i)
+            decrypt_ops[i].payload = encrypted[i];
+        auto decrypted = rpc.aes_decrypt_batch(decrypt_ops, nullptr);
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            if (decrypted[i] != ops[i].payload)
+            {
+                bench_failure(test_result.name + " at operation " +
+                              std::to_string(count));
+                return;
+            }
         }
 
-        // std::this_thread::sleep_for(std::chrono::milliseconds(15));
         test_result.update_extreme_itr(itr_etc.elapsed_micro());
     }
     test_result.total_elapsed_ms = etc.elapsed();
     test_result_aggregator->record_test_result(test_result);
 }
 
-void test_desfire_auth(size_t iterations, const std::string &key_uuid)
+/**
+ * DESFire AES authentication, with the card side emulated using `card_key`.
+ */
+void test_desfire_auth(iks::IKSRPCClient &rpc, const std::string &prefix,
+                       size_t iterations, const std::string &key_uuid,
+                       const ByteVector &card_key)
 {
     TestResult test_result{.nb_itr = iterations, .op_per_itr = 2};
-    test_result.name = "desfire_auth";
+    test_result.name = prefix + "desfire_auth";
 
     using namespace logicalaccess;
-    iks::IKSRPCClient rpc(iks::IslogKeyServer::get_global_config());
 
     ElapsedTimeCounter etc;
-    SignatureResult sr;
     for (uint64_t count = 0; count < test_result.nb_itr; ++count)
     {
+        ByteVector rndB    = random_bytes(16);
+        ByteVector encRndB = card_aes(card_key, ByteVector(16, 0x00), rndB, false);
+
         ElapsedTimeCounter itr_etc;
 
         CMSG_DesfireAESAuth_Step1 req;
         req.set_key_uuid(key_uuid);
-        req.set_encrypted_random_picc(BufferHelper::getStdString(
-            BufferHelper::fromHexString("01020304010203040102030401020304")));
+        req.set_encrypted_random_picc(BufferHelper::getStdString(encRndB));
         auto rep = rpc.desfire_auth_aes_step1(req);
 
+        ByteVector cryptogram(rep.encrypted_cryptogram().begin(),
+                              rep.encrypted_cryptogram().end());
+        ByteVector rndAB = card_aes(card_key, encRndB, cryptogram, true);
+        ByteVector rndA(rndAB.begin(), rndAB.begin() + 16);
+        if (ByteVector(rndAB.begin() + 16, rndAB.end()) != rotate_left(rndB))
+        {
+            bench_failure(test_result.name + ": bad reader cryptogram");
+            return;
+        }
+
         CMSG_DesfireAuth_Step2 req2;
         req2.set_auth_context_id(rep.auth_context_id());
         req2.set_key_uuid(key_uuid);
         req2.set_picc_cryptogram(BufferHelper::getStdString(
-            BufferHelper::fromHexString("01020304010203040102030401020304")));
+            card_aes(card_key, ByteVector(cryptogram.end() - 16, cryptogram.end()),
+                     rotate_left(rndA), false)));
 
         auto rep2 = rpc.desfire_auth_aes_step2(req2);
+        if (!rep2.success())
+        {
+            bench_failure(test_result.name + ": authentication refused");
+            return;
+        }
+        test_result.update_extreme_itr(itr_etc.elapsed_micro());
+    }
+    test_result.total_elapsed_ms = etc.elapsed();
+    test_result_aggregator->record_test_result(test_result);
+}
+
+/**
+ * DESFire ISO authentication, with the card side emulated using `card_key`.
+ */
+void test_desfire_iso_auth(iks::IKSRPCClient &rpc, const std::string &prefix,
+                           size_t iterations, const std::string &key_uuid,
+                           const ByteVector &card_key)
+{
+    TestResult test_result{.nb_itr = iterations, .op_per_itr = 2};
+    test_result.name = prefix + "desfire_iso_auth";
+
+    ElapsedTimeCounter etc;
+    for (uint64_t count = 0; count < test_result.nb_itr; ++count)
+    {
+        ByteVector rndPICC1 = random_bytes(16);
+
+        ElapsedTimeCounter itr_etc;
+
+        CMSG_DesfireISOAuth_Step1 req;
+        req.set_key_uuid(key_uuid);
+        req.set_random_picc(BufferHelper::getStdString(rndPICC1));
+        auto rep = rpc.desfire_auth_iso_step1(req);
+
+        // External Authenticate: the card checks E(RPCD1 || RPICC1).
+        ByteVector cryptogram(rep.encrypted_cryptogram().begin(),
+                              rep.encrypted_cryptogram().end());
+        ByteVector plain;
+        if (cryptogram.size() == 32)
+            plain = card_aes(card_key, ByteVector(16, 0x00), cryptogram, true);
+        if (plain.size() != 32 || ByteVector(plain.begin() + 16, plain.end()) != rndPICC1)
+        {
+            bench_failure(test_result.name + ": bad reader cryptogram");
+            return;
+        }
+        ByteVector rndPCD1(plain.begin(), plain.begin() + 16);
+
+        // Internal Authenticate: the card answers E(RPICC2 || RPCD2).
+        ByteVector rndPICC2 = random_bytes(16);
+        ByteVector answer   = rndPICC2;
+        answer.insert(answer.end(), rep.random2().begin(), rep.random2().end());
+
+        CMSG_DesfireAuth_Step2 req2;
+        req2.set_auth_context_id(rep.auth_context_id());
+        req2.set_key_uuid(key_uuid);
+        req2.set_picc_cryptogram(BufferHelper::getStdString(card_aes(
+            card_key, ByteVector(cryptogram.end() - 16, cryptogram.end()), answer,
+            false)));
+
+        auto rep2 = rpc.desfire_auth_iso_step2(req2);
+        ByteVector session_key(rndPCD1.begin(), rndPCD1.begin() + 4);
+        session_key.insert(session_key.end(), rndPICC2.begin(), rndPICC2.begin() + 4);
+        session_key.insert(session_key.end(), rndPCD1.begin() + 12, rndPCD1.end());
+        session_key.insert(session_key.end(), rndPICC2.begin() + 12, rndPICC2.end());
+        if (!rep2.success() ||
+            ByteVector(rep2.session_key().begin(), rep2.session_key().end()) !=
+                session_key)
+        {
+            bench_failure(test_result.name + ": authentication refused");
+            return;
+        }
+        test_result.update_extreme_itr(itr_etc.elapsed_micro());
+    }
+    test_result.total_elapsed_ms = etc.elapsed();
+    test_result_aggregator->record_test_result(test_result);
+}
+
+/**
+ * DESFire ChangeKey, the cryptogram being checked against DESFireCrypto.
+ */
+void test_desfire_change_key(iks::IKSRPCClient &rpc, const std::string &prefix,
+                             size_t iterations, const std::string &old_key_uuid,
+                             const ByteVector &old_key, const std::string &new_key_uuid,
+                             const ByteVector &new_key)
+{
+    TestResult test_result{.nb_itr = iterations, .op_per_itr = 1};
+    test_result.name = prefix + "desfire_change_key";
+
+    const uint8_t key_no   = 1;
+    ByteVector session_key = random_bytes(16);
+    CMSG_DesfireChangeKey req;
+    req.set_old_key_uuid(old_key_uuid);
+    req.set_new_key_uuid(new_key_uuid);
+    req.set_change_same_key(false);
+    req.set_session_key(BufferHelper::getStdString(session_key));
+    req.set_key_number(key_no);
+    req.set_iv(BufferHelper::getStdString(ByteVector(16, 0x00)));
+
+    // The same change, computed locally on an authenticated AES session.
+    DESFireCrypto crypto;
+    crypto.d_auth_method  = CM_ISO;
+    crypto.d_cipher       = std::make_shared<openssl::AESCipher>();
+    crypto.d_sessionKey   = session_key;
+    crypto.d_lastIV       = ByteVector(16, 0x00);
+    crypto.d_currentAid   = 0;
+    crypto.d_currentKeyNo = 0;
+    auto oldkey = std::make_shared<DESFireKey>(old_key.data(), old_key.size());
+    oldkey->setKeyType(DF_KEY_AES);
+    crypto.setKey(0, 0, key_no, oldkey);
+    auto newkey = std::make_shared<DESFireKey>(new_key.data(), new_key.size());
+    newkey->setKeyType(DF_KEY_AES);
+    ByteVector expected = crypto.changeKey_PICC(key_no, {}, newkey, {});
+
+    ElapsedTimeCounter etc;
+    for (uint64_t count = 0; count < test_result.nb_itr; ++count)
+    {
+        ElapsedTimeCounter itr_etc;
+
+        auto rep = rpc.desfire_change_key(req);
+        if (ByteVector(rep.cryptogram().begin(), rep.cryptogram().end()) != expected)
+        {
+            bench_failure(test_result.name + ": bad cryptogram");
+            return;
+        }
         test_result.update_extreme_itr(itr_etc.elapsed_micro());
     }
     test_result.total_elapsed_ms = etc.elapsed();
     test_result_aggregator->record_test_result(test_result);
 }
 
+/**
+ * Run the benchmark against a live IKS (--remote) or, by default, against a local
+ * in-memory stand-in server.
+ *
+ * Options: --agg to only display aggregated results, --iterations N per thread.
+ */
 int main(int ac, char **av)
 {
-    const int itr_count  = 1000;
-    const int NB_THREADS = 10;
-    /*
+    size_t itr_count = 1000;
+    bool remote      = false;
+    bool agg_only    = false;
+    for (int i = 1; i < ac; ++i)
+    {
+        std::string arg = av[i];
+        if (arg == "--agg")
+            agg_only = true;
+        else if (arg == "--remote")
+            remote = true;
+        else if (arg == "--iterations" && i + 1 < ac)
+            itr_count = std::stoul(av[++i]);
+    }
+    test_result_aggregator = new TestResultAgg(agg_only);
+
+    std::string aes_key_uuid     = "e8c0e771-3db8-4f53-9209-98ba4209ca59";
+    std::string desfire_key_uuid = "ae6b9177-4ea0-49a0-a91d-ca72a0ab8955";
+    std::string new_key_uuid     = "1f3b5e0c-3d52-4a41-9b7e-07c1f0e4d3a2";
+    ByteVector desfire_key =
+        BufferHelper::fromHexString("00112233445566778899aabbccddeeff");
+    ByteVector new_key = random_bytes(16);
+
+    std::unique_ptr<iks::IKSLocalServer> local_server;
+    std::unique_ptr<iks::IKSRPCClient> rpc;
+    if (remote)
+    {
         iks::IslogKeyServer::configureGlobalInstance(
-            "iksf", 6565, "/home/xaqq/Documents/iks/crypto/arnaud.pem",
-            "/home/xaqq/Documents/iks/crypto/arnaud.key",
-            "/tmp/iks-crypto/iks-server-intermediate-ca.pem");
-    */
-
-    iks::IslogKeyServer::configureGlobalInstance(
-        "iksf", 6565, "/home/xaqq/Documents/iks/crypto/certs/my-client-1.pem",
-        "/home/xaqq/Documents/iks/crypto/certs/my-client-1.key",
-        "/home/xaqq/Documents/iks/crypto/certs/iks-server-intermediate-ca.pem");
-
-    if (ac == 2 && std::string(av[1]) == "--agg")
-        test_result_aggregator = new TestResultAgg(true);
+            "iksf", 6565, "/home/xaqq/Documents/iks/crypto/certs/my-client-1.pem",
+            "/home/xaqq/Documents/iks/crypto/certs/my-client-1.key",
+            "/home/xaqq/Documents/iks/crypto/certs/iks-server-intermediate-ca.pem");
+        rpc.reset(new iks::IKSRPCClient(iks::IslogKeyServer::get_global_config(),
+                                        iks::RemoteCryptoIKSProvider::CHANNEL_POOL_SIZE));
+    }
     else
-        test_result_aggregator = new TestResultAgg(false);
-
+    {
+        local_server.reset(new iks::IKSLocalServer());
+        local_server->add_key(aes_key_uuid, random_bytes(16));
+        local_server->add_key(desfire_key_uuid, desfire_key);
+        local_server->add_key(new_key_uuid, new_key);
+
+        iks::IslogKeyServer::IKSConfig config("127.0.0.1", local_server->get_port(), "",
+                                              "", "");
+        rpc.reset(new iks::IKSRPCClient(config,
+                                        iks::RemoteCryptoIKSProvider::CHANNEL_POOL_SIZE,
+                                        grpc::InsecureChannelCredentials()));
+    }
 
-    std::vector<std::thread> threads;
-    for (int n = 0; n < NB_THREADS; ++n)
+    // All threads share one client, as readers share one IKS provider.
+    for (size_t concurrency : {1, 4, 16})
     {
-        std::thread t([]() {
-            std::string key = "e8c0e771-3db8-4f53-9209-98ba4209ca59";
-            // std::string key = "ae6b9177-4ea0-49a0-a91d-ca72a0ab8955";
-            // test_aes_key(1024, itr_count, key, false);
-            //   test_aes_key(1024, itr_count, key, true);
-            test_aes_key(16, itr_count, key, false);
-            // test_aes_key(16, itr_count, key, true);
-            // test_aes_key(1024 * 10, itr_count, key, false);
-            // test_aes_key(1024 * 10, itr_count, key, true);
-
-
-            // Now with key stored in IKSD
-            key = "ae6b9177-4ea0-49a0-a91d-ca72a0ab8955";
-            // test_desfire_auth(itr_count, key);
-            //           test_aes_key(1024, itr_count, key, false);
-            //         test_aes_key(1024, itr_count, key, true);
-            //       test_aes_key(16, itr_count, key, false);
-            //     test_aes_key(16, itr_count, key, true);
-            //          test_aes_key(1024 * 10, itr_count, key, false);
-            // test_aes_key(1024 * 10, itr_count, key, true);
-        });
-
-        threads.push_back(std::move(t));
+        std::string prefix = "c" + std::to_string(concurrency) + "_";
+        std::vector<std::thread> threads;
+        for (size_t n = 0; n < concurrency; ++n)
+        {
+            threads.emplace_back([&]() {
+                test_aes_key(*rpc, prefix, 16, itr_count, aes_key_uuid, false);
+                test_aes_key(*rpc, prefix, 1024, itr_count, aes_key_uuid, false);
+                test_aes_key(*rpc, prefix, 16, itr_count, aes_key_uuid, true);
+                test_aes_batch(*rpc, prefix, 64, std::max<size_t>(itr_count / 64, 1),
+                               aes_key_uuid);
+                if (local_server)
+                {
+                    // The card side needs the key value.
+                    test_desfire_auth(*rpc, prefix, itr_count, desfire_key_uuid,
+                                      desfire_key);
+                    test_desfire_iso_auth(*rpc, prefix, itr_count, desfire_key_uuid,
+                                          desfire_key);
+                    test_desfire_change_key(*rpc, prefix, itr_count, desfire_key_uuid,
+                                            desfire_key, new_key_uuid, new_key);
+                }
+            });
+        }
+        for (auto &t : threads)
+            t.join();
     }
-    for (auto &t : threads)
-        t.join();
 
     test_result_aggregator->display();
+    return bench_failed ? 1 : 0;
 }
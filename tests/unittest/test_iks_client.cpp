@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/iks/RemoteCrypto.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/aes_symmetric_key.hpp>
+#include <logicalaccess/plugins/iks/IKSRPCClient.hpp>
+#include "iks_local_server.hpp"
+
+using namespace logicalaccess;
+using namespace iks;
+
+namespace
+{
+const std::string AES_KEY_UUID = "e8c0e771-3db8-4f53-9209-98ba4209ca59";
+const ByteVector AES_KEY =
+    BufferHelper::fromHexString("000102030405060708090a0b0c0d0e0f");
+
+ByteVector card_aes(const ByteVector &iv, const ByteVector &in, bool decrypt)
+{
+    ByteVector out;
+    openssl::AESCipher cipher;
+    auto symkey = openssl::AESSymmetricKey::createFromData(AES_KEY);
+    auto aesiv  = openssl::AESInitializationVector::createFromData(iv);
+    if (decrypt)
+        cipher.decipher(in, out, symkey, aesiv, false);
+    else
+        cipher.cipher(in, out, symkey, aesiv, false);
+    return out;
+}
+
+ByteVector rotate_left(const ByteVector &in)
+{
+    ByteVector ret(in.begin() + 1, in.end());
+    ret.push_back(in[0]);
+    return ret;
+}
+
+/**
+ * A local IKS and a provider connected to it.
+ */
+class IKSClientTest : public ::testing::Test
+{
+  protected:
+    IKSClientTest()
+        : provider_(IslogKeyServer::IKSConfig("127.0.0.1", start_server(), "", "", ""),
+                    RemoteCryptoIKSProvider::CHANNEL_POOL_SIZE,
+                    grpc::InsecureChannelCredentials())
+    {
+    }
+
+    uint16_t start_server()
+    {
+        server_.add_key(AES_KEY_UUID, AES_KEY);
+        return server_.get_port();
+    }
+
+    /**
+     * DESFire AES authentication, with the card side emulated.
+     * \return The session key reference.
+     */
+    std::string authenticate()
+    {
+        ByteVector encRndB = card_aes(ByteVector(16, 0x00), ByteVector(16, 0x42), false);
+        bool success       = false;
+        ByteVector cryptogram, context_id, session_key, session_key_ref;
+        provider_.aes_authenticate_step1(AES_KEY_UUID, encRndB, MyDivInfo(), success,
+                                         cryptogram, context_id);
+        EXPECT_TRUE(success);
+
+        ByteVector rndA = card_aes(encRndB, cryptogram, true);
+        rndA.resize(16);
+        provider_.aes_authenticate_step2(
+            AES_KEY_UUID,
+            card_aes(ByteVector(cryptogram.end() - 16, cryptogram.end()),
+                     rotate_left(rndA), false),
+            context_id, MyDivInfo(), success, session_key, session_key_ref);
+        EXPECT_TRUE(success);
+        return std::string(session_key_ref.begin(), session_key_ref.end());
+    }
+
+    IKSLocalServer server_;
+    RemoteCryptoIKSProvider provider_;
+};
+}
+
+TEST_F(IKSClientTest, async_operations_through_remote_crypto)
+{
+    RemoteCrypto &crypto = provider_;
+    const ByteVector iv(16, 0x00);
+
+    std::vector<std::future<ByteVector>> encrypted;
+    for (unsigned char i = 0; i < 8; ++i)
+    {
+        encrypted.push_back(
+            crypto.aes_encrypt_async(ByteVector(32, i), AES_KEY_UUID, iv));
+    }
+
+    std::vector<SignatureResult> signatures(encrypted.size());
+    std::vector<std::future<ByteVector>> decrypted;
+    for (size_t i = 0; i < encrypted.size(); ++i)
+    {
+        ByteVector cryptogram = encrypted[i].get();
+        ASSERT_EQ(crypto.aes_encrypt(ByteVector(32, static_cast<unsigned char>(i)),
+                                     AES_KEY_UUID, iv),
+                  cryptogram);
+        decrypted.push_back(
+            crypto.aes_decrypt_async(cryptogram, AES_KEY_UUID, iv, &signatures[i]));
+    }
+
+    for (size_t i = 0; i < decrypted.size(); ++i)
+    {
+        ASSERT_EQ(ByteVector(32, static_cast<unsigned char>(i)), decrypted[i].get());
+        ASSERT_TRUE(crypto.verify_signature(signatures[i], server_.get_public_key_pem()));
+    }
+
+    // Failures are reported by the future.
+    auto failed = crypto.aes_encrypt_async(ByteVector(16), "unknown-key", iv);
+    ASSERT_ANY_THROW(failed.get());
+}
+
+TEST_F(IKSClientTest, batch_operations)
+{
+    RemoteCrypto &crypto = provider_;
+
+    // More operations than the in-flight window, with different IVs.
+    std::vector<AESOperation> ops(IKSRPCClient::MAX_IN_FLIGHT + 3);
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        ops[i].key_name = AES_KEY_UUID;
+        ops[i].iv       = ByteVector(16, static_cast<unsigned char>(i));
+        ops[i].payload  = ByteVector(16 * (i % 3 + 1), static_cast<unsigned char>(i));
+    }
+
+    std::vector<ByteVector> encrypted = crypto.aes_encrypt_batch(ops);
+    ASSERT_EQ(ops.size(), encrypted.size());
+    std::vector<AESOperation> decrypt_ops = ops;
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        ASSERT_EQ(crypto.aes_encrypt(ops[i].payload, ops[i].key_name, ops[i].iv),
+                  encrypted[i]);
+        decrypt_ops[i].payload = encrypted[i];
+    }
+
+    std::vector<SignatureResult> signatures;
+    std::vector<ByteVector> decrypted =
+        crypto.aes_decrypt_batch(decrypt_ops, &signatures);
+    ASSERT_EQ(ops.size(), signatures.size());
+    for (size_t i = 0; i < ops.size(); ++i)
+        ASSERT_EQ(ops[i].payload, decrypted[i]);
+    std::vector<bool> valid =
+        crypto.verify_signatures(signatures, server_.get_public_key_pem());
+    ASSERT_EQ(std::vector<bool>(ops.size(), true), valid);
+
+    ops[1].key_name = "unknown-key";
+    ASSERT_ANY_THROW(crypto.aes_encrypt_batch(ops));
+}
+
+TEST_F(IKSClientTest, abandoned_authentications_are_dropped)
+{
+    const ByteVector encRndB(16, 0x42);
+    bool success = false;
+    ByteVector cryptogram, first_context, context, session_key, session_key_ref;
+    provider_.aes_authenticate_step1(AES_KEY_UUID, encRndB, MyDivInfo(), success,
+                                     cryptogram, first_context);
+    for (size_t i = 0; i < IKSLocalServer::MAX_AUTH_CONTEXTS; ++i)
+    {
+        provider_.aes_authenticate_step1(AES_KEY_UUID, encRndB, MyDivInfo(), success,
+                                         cryptogram, context);
+    }
+
+    // The first context is gone, the last one is refused a bad cryptogram.
+    ASSERT_ANY_THROW(provider_.aes_authenticate_step2(AES_KEY_UUID, ByteVector(16),
+                                                      first_context, MyDivInfo(),
+                                                      success, session_key,
+                                                      session_key_ref));
+    provider_.aes_authenticate_step2(AES_KEY_UUID, ByteVector(16), context, MyDivInfo(),
+                                     success, session_key, session_key_ref);
+    ASSERT_FALSE(success);
+}
+
+TEST_F(IKSClientTest, old_session_keys_are_dropped)
+{
+    const ByteVector payload(16, 0x01), iv(16, 0x00);
+    std::string first = authenticate();
+    ASSERT_NO_THROW(provider_.aes_encrypt(payload, first, iv));
+
+    for (size_t i = 0; i < IKSLocalServer::MAX_SESSION_KEYS; ++i)
+        authenticate();
+    ASSERT_ANY_THROW(provider_.aes_encrypt(payload, first, iv));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/logsink.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <list>
+
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace logicalaccess;
+
+TEST(test_log_sink, records_from_many_threads_are_written_whole)
+{
+    std::ostringstream out;
+    const int threads = 4;
+    const int records = 2000;
+    uint64_t dropped;
+    {
+        AsyncLogSink sink(out, 16384, 0, false);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t)
+        {
+            producers.emplace_back([&sink, t]() {
+                for (int i = 0; i < records; ++i)
+                    sink.push(std::to_string(t) + ":" + std::to_string(i) + "\n");
+            });
+        }
+        for (auto &producer : producers)
+            producer.join();
+        sink.flush();
+
+        dropped = sink.getDroppedCount();
+        ASSERT_EQ(0u, dropped);
+        ASSERT_EQ(static_cast<uint64_t>(threads * records), sink.getWrittenCount());
+    }
+
+    std::istringstream in(out.str());
+    std::set<std::string> lines;
+    std::string line;
+    while (std::getline(in, line))
+        lines.insert(line);
+    ASSERT_EQ(static_cast<size_t>(threads * records), lines.size());
+    ASSERT_EQ(1u, lines.count("3:1999"));
+}
+
+TEST(test_log_sink, overflow_is_counted)
+{
+    std::ostringstream out;
+    uint64_t written, dropped;
+    const uint64_t pushed = 100000;
+    {
+        AsyncLogSink sink(out, 4, 1000, false);
+        for (uint64_t i = 0; i < pushed; ++i)
+            sink.push("x\n");
+        sink.flush();
+        written = sink.getWrittenCount();
+        dropped = sink.getDroppedCount();
+    }
+    ASSERT_EQ(pushed, written + dropped);
+    ASSERT_GT(dropped, 0u);
+    ASSERT_NE(std::string::npos, out.str().find("dropped"));
+}
+
+TEST(test_log_sink, capacity_is_clamped)
+{
+    std::ostringstream out;
+    AsyncLogSink huge(out, static_cast<size_t>(-1), 0, false);
+    ASSERT_EQ(AsyncLogSink::MAX_CAPACITY, huge.getCapacity());
+
+    AsyncLogSink empty(out, 0, 0, false);
+    ASSERT_EQ(2u, empty.getCapacity());
+}
+
+TEST(test_log_sink, replaced_while_logging)
+{
+    Settings::update([](Settings &s) { s.IsLogEnabled = true; });
+    Logs::logfile.open("test_log_sink.log");
+    std::atomic<bool> stop(false);
+
+    std::vector<std::thread> loggers;
+    for (int t = 0; t < 4; ++t)
+    {
+        loggers.emplace_back([&stop]() {
+            while (!stop)
+                LOG(LogLevel::INFOS) << "record";
+        });
+    }
+
+    // Each sink writes to its own stream, released after every sink is gone.
+    std::list<std::ostringstream> streams;
+    for (int i = 0; i < 200; ++i)
+    {
+        streams.emplace_back();
+        std::atomic_store(&Logs::asyncSink,
+                          std::make_shared<AsyncLogSink>(streams.back(), 64, 0, false));
+        std::atomic_store(&Logs::asyncSink, std::shared_ptr<AsyncLogSink>());
+    }
+
+    stop = true;
+    for (auto &logger : loggers)
+        logger.join();
+    Logs::logfile.close();
+    std::remove("test_log_sink.log");
+    Settings::update([](Settings &s) { s.IsLogEnabled = false; });
+}
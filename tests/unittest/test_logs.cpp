@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+using namespace logicalaccess;
+
+static int evaluations = 0;
+
+static std::string expensive()
+{
+    ++evaluations;
+    return "expensive";
+}
+
+TEST(test_logs, disabled_level_does_not_evaluate_arguments)
+{
+    Settings::update([](Settings &s) {
+        s.IsLogEnabled        = false;
+        s.SeeCommunicationLog = false;
+    });
+    evaluations = 0;
+
+    LOG(LogLevel::INFOS) << expensive();
+    ASSERT_FALSE(Logs::isEnabled(LogLevel::INFOS));
+    ASSERT_EQ(0, evaluations);
+
+    Settings::update([](Settings &s) { s.IsLogEnabled = true; });
+    LOG(LogLevel::COMS) << expensive();
+    ASSERT_FALSE(Logs::isEnabled(LogLevel::COMS));
+    ASSERT_EQ(0, evaluations);
+
+    if (Logs::isEnabled(LogLevel::INFOS))
+        LOG(LogLevel::INFOS) << expensive();
+    else
+        ASSERT_TRUE(false);
+    ASSERT_EQ(1, evaluations);
+
+    Settings::update([](Settings &s) { s.IsLogEnabled = false; });
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/cards/readercardadapter.hpp>
+#include <logicalaccess/resultchecker.hpp>
+#include "echodatatransport.hpp"
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * Adapter wrapping each command in a 0xAA prefix.
+ */
+class PrefixReaderCardAdapter : public ReaderCardAdapter
+{
+  public:
+    ByteVector adaptCommand(const ByteVector &command) override
+    {
+        ByteVector res(1, 0xAA);
+        res.insert(res.end(), command.begin(), command.end());
+        return res;
+    }
+
+    ByteVector adaptAnswer(const ByteVector &answer) override
+    {
+        EXPECT_EQ(0xAB, answer.at(0));
+        return ByteVector(answer.begin() + 1, answer.end());
+    }
+};
+
+/**
+ * Adapter keeping a sequence number across its own sendCommand() calls.
+ */
+class SequencedReaderCardAdapter : public ReaderCardAdapter
+{
+  public:
+    SequencedReaderCardAdapter()
+        : d_sequence(0)
+    {
+    }
+
+    ByteVector sendCommand(const ByteVector &command, long timeout = -1) override
+    {
+        ByteVector cmd(1, d_sequence++);
+        cmd.insert(cmd.end(), command.begin(), command.end());
+        return ReaderCardAdapter::sendCommand(cmd, timeout);
+    }
+
+    std::vector<ByteVector> sendCommands(const std::vector<ByteVector> &commands,
+                                         long timeout = -1) override
+    {
+        return sendCommandsInSequence(commands, timeout);
+    }
+
+  private:
+    unsigned char d_sequence;
+};
+
+/**
+ * Result checker rejecting answers starting with 0xFF.
+ */
+class FirstByteResultChecker : public ResultChecker
+{
+  public:
+    void CheckResult(const void *data, size_t datalen) override
+    {
+        if (datalen > 0 && static_cast<const unsigned char *>(data)[0] == 0xFF)
+            throw LibLogicalAccessException("Bad answer");
+    }
+};
+}
+
+TEST(test_send_commands, adapts_every_command)
+{
+    PrefixReaderCardAdapter adapter;
+    adapter.setDataTransport(std::make_shared<EchoDataTransport>());
+
+    auto results = adapter.sendCommands({{0x01}, {0x02, 0x03}}, 1000);
+    ASSERT_EQ(std::vector<ByteVector>({{0x02}, {0x03, 0x04}}), results);
+}
+
+TEST(test_send_commands, checks_every_answer)
+{
+    PrefixReaderCardAdapter adapter;
+    adapter.setDataTransport(std::make_shared<EchoDataTransport>());
+    adapter.setResultChecker(std::make_shared<FirstByteResultChecker>());
+
+    ASSERT_NO_THROW(adapter.sendCommands({{0x01}, {0x02}}, 1000));
+    ASSERT_THROW(adapter.sendCommands({{0x01}, {0xFE}}, 1000),
+                 LibLogicalAccessException);
+}
+
+TEST(test_send_commands, dispatches_through_send_command)
+{
+    SequencedReaderCardAdapter adapter;
+    adapter.setDataTransport(std::make_shared<EchoDataTransport>());
+
+    auto results = adapter.sendCommands({{0x10}, {0x20}, {0x30}}, 1000);
+    ASSERT_EQ(std::vector<ByteVector>({{0x01, 0x11}, {0x02, 0x21}, {0x03, 0x31}}),
+              results);
+    ASSERT_EQ(ByteVector({0x04, 0x41}), adapter.sendCommand({0x40}, 1000));
+}
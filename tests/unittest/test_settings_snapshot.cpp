@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+#include <thread>
+
+using namespace logicalaccess;
+
+TEST(test_settings_snapshot, publish_does_not_affect_held_snapshots)
+{
+    std::shared_ptr<const Settings> before = Settings::getSnapshot();
+    ASSERT_TRUE(before);
+
+    Settings *settings             = Settings::getInstance();
+    const int oldTimeout           = settings->DataTransportTimeout;
+    settings->DataTransportTimeout = oldTimeout + 1000;
+
+    settings->publish();
+    std::shared_ptr<const Settings> after = Settings::getSnapshot();
+    ASSERT_EQ(oldTimeout + 1000, after->DataTransportTimeout);
+    ASSERT_GT(after->getVersion(), before->getVersion());
+    ASSERT_EQ(settings->getVersion(), after->getVersion());
+    ASSERT_EQ(oldTimeout, before->DataTransportTimeout);
+
+    settings->DataTransportTimeout = oldTimeout;
+    settings->publish();
+    ASSERT_EQ(oldTimeout, Settings::getSnapshot()->DataTransportTimeout);
+}
+
+TEST(test_settings_snapshot, writes_are_published_explicitly)
+{
+    std::shared_ptr<const Settings> before = Settings::getSnapshot();
+    const int oldTimeout                   = before->DataTransportTimeout;
+
+    // A write through the instance is not seen before it is published.
+    Settings::getInstance()->DataTransportTimeout = oldTimeout + 500;
+    ASSERT_EQ(oldTimeout, Settings::getSnapshot()->DataTransportTimeout);
+    Settings::getInstance()->DataTransportTimeout = oldTimeout;
+
+    Settings::update(
+        [oldTimeout](Settings &s) { s.DataTransportTimeout = oldTimeout + 500; });
+    ASSERT_EQ(oldTimeout + 500, Settings::getSnapshot()->DataTransportTimeout);
+    ASSERT_EQ(oldTimeout, before->DataTransportTimeout);
+
+    // Other threads see the update too.
+    int seen = 0;
+    std::thread([&seen]() { seen = Settings::getSnapshot()->DataTransportTimeout; })
+        .join();
+    ASSERT_EQ(oldTimeout + 500, seen);
+
+    Settings::update([oldTimeout](Settings &s) { s.DataTransportTimeout = oldTimeout; });
+    ASSERT_EQ(oldTimeout, Settings::getSnapshot()->DataTransportTimeout);
+}
+
+TEST(test_settings_snapshot, reload_does_not_affect_held_snapshots)
+{
+    Settings::update([](Settings &s) { s.DataTransportTimeout += 700; });
+    std::shared_ptr<const Settings> before = Settings::getSnapshot();
+    const int timeout                      = before->DataTransportTimeout;
+
+    Settings::reload();
+    std::shared_ptr<const Settings> after = Settings::getSnapshot();
+    ASSERT_GT(after->getVersion(), before->getVersion());
+    ASSERT_EQ(timeout, before->DataTransportTimeout);
+    ASSERT_EQ(timeout - 700, after->DataTransportTimeout);
+}
+
+TEST(test_settings_snapshot, unchanged_snapshot_is_reused)
+{
+    std::shared_ptr<const Settings> first  = Settings::getSnapshot();
+    std::shared_ptr<const Settings> second = Settings::getSnapshot();
+    ASSERT_EQ(first.get(), second.get());
+}
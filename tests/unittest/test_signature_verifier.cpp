@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/crypto/signature_helper.hpp>
+#include "test_signer.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace logicalaccess;
+
+TEST(test_signature_verifier, verify_many)
+{
+    TestSigner signer;
+    SignatureVerifier verifier(signer.public_key_pem());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::string data = "payload " + std::to_string(i);
+        std::string sig  = signer.sign(data);
+        ASSERT_TRUE(verifier.verify_sha512(data, sig));
+        ASSERT_FALSE(verifier.verify_sha512(data + "!", sig));
+        ASSERT_TRUE(SignatureHelper::verify_sha512(data, sig, signer.public_key_pem()));
+    }
+}
+
+TEST(test_signature_verifier, batch)
+{
+    TestSigner signer;
+    SignatureVerifier verifier(signer.public_key_pem());
+
+    std::vector<std::pair<std::string, std::string>> signed_data;
+    for (int i = 0; i < 8; ++i)
+    {
+        std::string data = "payload " + std::to_string(i);
+        signed_data.emplace_back(data, signer.sign(data));
+    }
+    signed_data[3].first  = "tampered";
+    signed_data[5].second = signed_data[6].second;
+
+    auto results = verifier.verify_sha512(signed_data);
+    ASSERT_EQ(8u, results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+        ASSERT_EQ(i != 3 && i != 5, results[i]) << "at index " << i;
+}
+
+TEST(test_signature_verifier, concurrent_verifications)
+{
+    TestSigner signer;
+    SignatureVerifier verifier(signer.public_key_pem());
+    const std::string data = "payload";
+    const std::string sig  = signer.sign(data);
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 50; ++i)
+            {
+                if (!verifier.verify_sha512(data, sig) ||
+                    verifier.verify_sha512(data + "!", sig))
+                    ++failures;
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(0, failures);
+}
+
+TEST(test_signature_verifier, bad_public_key)
+{
+    ASSERT_THROW(SignatureVerifier("not a key"), std::runtime_error);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+
+namespace logicalaccess
+{
+/**
+ * A throw-away RSA 2048 key to sign test data with, RSA / SHA512.
+ */
+class TestSigner
+{
+  public:
+    TestSigner()
+        : pkey_(nullptr)
+    {
+        EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+        bool ok           = ctx && EVP_PKEY_keygen_init(ctx) == 1 &&
+                  EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) == 1 &&
+                  EVP_PKEY_keygen(ctx, &pkey_) == 1;
+        EVP_PKEY_CTX_free(ctx);
+        if (!ok)
+            throw std::runtime_error("Cannot generate the signing key");
+    }
+
+    ~TestSigner()
+    {
+        EVP_PKEY_free(pkey_);
+    }
+
+    TestSigner(const TestSigner &) = delete;
+    TestSigner &operator=(const TestSigner &) = delete;
+
+    /**
+     * PEM public key to verify the signatures with.
+     */
+    std::string public_key_pem() const
+    {
+        BIO *bio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PUBKEY(bio, pkey_);
+        char *data = nullptr;
+        long len   = BIO_get_mem_data(bio, &data);
+        std::string pem(data, static_cast<size_t>(len));
+        BIO_free_all(bio);
+        return pem;
+    }
+
+    /**
+     * Sign data, throw std::runtime_error on failure.
+     */
+    std::string sign(const std::string &data) const
+    {
+        EVP_MD_CTX *ctx = EVP_MD_CTX_create();
+        size_t len      = 0;
+        std::string signature;
+        if (EVP_DigestSignInit(ctx, nullptr, EVP_sha512(), nullptr, pkey_) == 1 &&
+            EVP_DigestSignUpdate(ctx, data.data(), data.size()) == 1 &&
+            EVP_DigestSignFinal(ctx, nullptr, &len) == 1)
+        {
+            signature.resize(len);
+            if (EVP_DigestSignFinal(ctx, reinterpret_cast<unsigned char *>(&signature[0]),
+                                    &len) == 1)
+                signature.resize(len);
+            else
+                signature.clear();
+        }
+        EVP_MD_CTX_destroy(ctx);
+        if (signature.empty())
+            throw std::runtime_error("Cannot sign data");
+        return signature;
+    }
+
+  private:
+    EVP_PKEY *pkey_;
+};
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/spanprofiler.hpp>
+
+#include <thread>
+
+using namespace logicalaccess;
+
+static void inner()
+{
+    LLA_LOG_CTX("inner");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+static void outer()
+{
+    LLA_LOG_CTX("outer");
+    inner();
+    inner();
+}
+
+TEST(test_span_profiler, nested_spans)
+{
+    SpanProfiler::reset();
+    SpanProfiler::setEnabled(true);
+    outer();
+    outer();
+    SpanProfiler::setEnabled(false);
+    outer();
+
+    std::vector<SpanStatistics> stats = SpanProfiler::getStatistics();
+    ASSERT_EQ(2u, stats.size());
+    ASSERT_EQ("outer", stats[0].path);
+    ASSERT_EQ(2u, stats[0].count);
+    ASSERT_EQ("outer;inner", stats[1].path);
+    ASSERT_EQ(4u, stats[1].count);
+    ASSERT_GE(stats[1].p50, 2000u);
+    ASSERT_LE(stats[1].p50, stats[1].p99);
+    ASSERT_LE(stats[1].p99, stats[1].max);
+    ASSERT_GE(stats[0].total, stats[1].total);
+
+    std::string folded = SpanProfiler::dumpFoldedStacks();
+    ASSERT_NE(std::string::npos, folded.find("outer;inner " + std::to_string(stats[1].total)));
+    ASSERT_NE(std::string::npos,
+              folded.find("outer " + std::to_string(stats[0].total - stats[1].total)));
+    ASSERT_NE(std::string::npos, SpanProfiler::dump().find("  inner"));
+
+    SpanProfiler::reset();
+    ASSERT_TRUE(SpanProfiler::getStatistics().empty());
+}
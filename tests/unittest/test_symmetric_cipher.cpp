@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/aes_symmetric_key.hpp>
+#include <logicalaccess/plugins/crypto/des_cipher.hpp>
+#include <logicalaccess/plugins/crypto/des_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/des_symmetric_key.hpp>
+#include <logicalaccess/plugins/crypto/openssl_symmetric_cipher_context.hpp>
+
+using namespace logicalaccess;
+using namespace logicalaccess::openssl;
+
+TEST(test_symmetric_cipher, aes_cbc_reuses_key_across_calls)
+{
+    // NIST SP 800-38A F.2.1
+    AESSymmetricKey key = AESSymmetricKey::createFromData(
+        BufferHelper::fromHexString("2b7e151628aed2a6abf7158809cf4f3c"));
+    AESInitializationVector iv = AESInitializationVector::createFromData(
+        BufferHelper::fromHexString("000102030405060708090a0b0c0d0e0f"));
+    AESSymmetricKey otherKey = AESSymmetricKey::createFromData(ByteVector(16, 0x42));
+    ByteVector plain = BufferHelper::fromHexString("6bc1bee22e409f96e93d7e117393172a");
+    ByteVector expected = BufferHelper::fromHexString("7649abac8119b246cee98e9b12e9197d");
+
+    AESCipher cipher;
+    ByteVector out, other, back;
+    for (int i = 0; i < 3; ++i)
+    {
+        cipher.cipher(plain, out, key, iv, false);
+        ASSERT_EQ(expected, out);
+    }
+
+    cipher.cipher(plain, other, key, AESInitializationVector::createNull(), false);
+    ASSERT_NE(expected, other);
+    cipher.cipher(plain, other, otherKey, iv, false);
+    ASSERT_NE(expected, other);
+    cipher.cipher(plain, out, key, iv, false);
+    ASSERT_EQ(expected, out);
+
+    cipher.decipher(out, back, key, iv, false);
+    ASSERT_EQ(plain, back);
+    cipher.decipher(out, back, key, iv, false);
+    ASSERT_EQ(plain, back);
+
+    // Same result as a one-shot session.
+    AESCipher copy(cipher);
+    OpenSSLSymmetricCipherContext context =
+        copy.start(OpenSSLSymmetricCipher::M_ENCRYPT, otherKey, iv, true);
+    OpenSSLSymmetricCipher::update(context, plain);
+    ByteVector oneShot = OpenSSLSymmetricCipher::stop(context);
+    copy.cipher(plain, out, otherKey, iv, true);
+    ASSERT_EQ(oneShot, out);
+    ASSERT_EQ(32u, out.size());
+}
+
+TEST(test_symmetric_cipher, des_key_size_change)
+{
+    DESCipher cipher;
+    DESInitializationVector iv = DESInitializationVector::createNull();
+    ByteVector plain(16, 0x11);
+    ByteVector twoKeys, threeKeys, again;
+
+    DESSymmetricKey key16 = DESSymmetricKey::createFromData(
+        BufferHelper::fromHexString("0123456789abcdeffedcba9876543210"));
+    DESSymmetricKey key24 = DESSymmetricKey::createFromData(BufferHelper::fromHexString(
+        "0123456789abcdeffedcba98765432100123456789abcdef"));
+
+    cipher.cipher(plain, twoKeys, key16, iv, false);
+    cipher.cipher(plain, threeKeys, key24, iv, false);
+    // 3K3DES with K3 == K1 is 2K3DES.
+    ASSERT_EQ(twoKeys, threeKeys);
+    ASSERT_NE(plain, twoKeys);
+
+    cipher.cipher(plain, again, key16, iv, false);
+    ASSERT_EQ(twoKeys, again);
+    cipher.decipher(again, again, key16, iv, false);
+    ASSERT_EQ(plain, again);
+}
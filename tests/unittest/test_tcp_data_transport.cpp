@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/readerproviders/tcpdatatransport.hpp>
+
+#include <future>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A one client TCP server on an ephemeral localhost port.
+ */
+class LocalPeer
+{
+  public:
+    LocalPeer()
+        : d_acceptor(d_ios, boost::asio::ip::tcp::endpoint(
+                                boost::asio::ip::address_v4::loopback(), 0))
+        , d_socket(d_ios)
+    {
+    }
+
+    int getPort() const
+    {
+        return d_acceptor.local_endpoint().port();
+    }
+
+    /**
+     * Run `connect` while accepting the connection it opens.
+     */
+    template <typename F>
+    void accept(F connect)
+    {
+        boost::system::error_code ec;
+        d_socket.close(ec);
+        std::thread acceptor([this]() { d_acceptor.accept(d_socket); });
+        connect();
+        acceptor.join();
+    }
+
+    void write(const ByteVector &data)
+    {
+        boost::asio::write(d_socket, boost::asio::buffer(data));
+        // Let the data reach the client socket.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    void close()
+    {
+        d_socket.close();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+  private:
+    boost::asio::io_service d_ios;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    boost::asio::ip::tcp::socket d_socket;
+};
+
+/**
+ * A TCP transport for a reader pushing events between commands.
+ */
+class EventTCPDataTransport : public TCPDataTransport
+{
+  protected:
+    bool isUnsolicitedDataExpected() const override
+    {
+        return true;
+    }
+};
+
+void setup(TCPDataTransport &transport, const LocalPeer &peer)
+{
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(peer.getPort());
+    transport.setPersistentConnection(true);
+}
+}
+
+TEST(test_tcp_data_transport, persistent_discards_stale_data)
+{
+    LocalPeer peer;
+    TCPDataTransport transport;
+    setup(transport, peer);
+    peer.accept([&]() { ASSERT_TRUE(transport.connect(1000)); });
+
+    peer.write({0xAA});
+    ASSERT_TRUE(transport.connect(1000));
+    peer.write({0x01, 0x02});
+    ASSERT_EQ(ByteVector({0x01, 0x02}), transport.receive(1000));
+    ASSERT_EQ(0u, transport.getMetrics()->getReconnectCount());
+}
+
+TEST(test_tcp_data_transport, persistent_keeps_unsolicited_data)
+{
+    LocalPeer peer;
+    EventTCPDataTransport transport;
+    setup(transport, peer);
+    peer.accept([&]() { ASSERT_TRUE(transport.connect(1000)); });
+
+    peer.write({0xAA});
+    ASSERT_TRUE(transport.connect(1000));
+    ASSERT_EQ(ByteVector({0xAA}), transport.receive(1000));
+    ASSERT_EQ(0u, transport.getMetrics()->getReconnectCount());
+}
+
+TEST(test_tcp_data_transport, persistent_reconnects_when_closed)
+{
+    LocalPeer peer;
+    EventTCPDataTransport transport;
+    setup(transport, peer);
+    peer.accept([&]() { ASSERT_TRUE(transport.connect(1000)); });
+
+    peer.close();
+    peer.accept([&]() { ASSERT_TRUE(transport.connect(1000)); });
+    ASSERT_EQ(1u, transport.getMetrics()->getReconnectCount());
+
+    peer.write({0x01});
+    ASSERT_EQ(ByteVector({0x01}), transport.receive(1000));
+}
+
+TEST(test_tcp_data_transport, blocking_on_reactor_thread_throws)
+{
+    LocalPeer peer;
+    TCPDataTransport transport;
+    setup(transport, peer);
+    peer.accept([&]() { ASSERT_TRUE(transport.connect(1000)); });
+
+    std::promise<bool> thrown;
+    TransportReactor::getInstance()->getIOService().post([&]() {
+        try
+        {
+            transport.receive(100);
+            thrown.set_value(false);
+        }
+        catch (LibLogicalAccessException &)
+        {
+            thrown.set_value(true);
+        }
+    });
+    auto res = thrown.get_future();
+    ASSERT_EQ(std::future_status::ready, res.wait_for(std::chrono::seconds(5)));
+    ASSERT_TRUE(res.get());
+    ASSERT_FALSE(TransportReactor::isIOThread());
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/transportmetrics.hpp>
+#include "echodatatransport.hpp"
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * Echo transport connected once by its owner, like the Rpleth transport.
+ */
+class SessionEchoDataTransport : public EchoDataTransport
+{
+  public:
+    SessionEchoDataTransport()
+        : d_connects(0)
+    {
+    }
+
+    bool connect() override
+    {
+        ++d_connects;
+        return true;
+    }
+
+    int d_connects;
+
+  protected:
+    bool connectBeforeCommand() const override
+    {
+        return false;
+    }
+};
+}
+
+TEST(test_transport_metrics, bucket_precision)
+{
+    for (uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456ull, 1ull << 35})
+    {
+        size_t index   = LogLinearHistogram::getBucketIndex(value);
+        uint64_t lower = LogLinearHistogram::getBucketValue(index);
+        ASSERT_LE(lower, value);
+        ASSERT_GE(lower + lower / 16 + 1, value);
+        ASSERT_LT(index, LogLinearHistogram::BUCKET_COUNT);
+    }
+    ASSERT_EQ(LogLinearHistogram::BUCKET_COUNT - 1,
+              LogLinearHistogram::getBucketIndex(~0ull));
+}
+
+TEST(test_transport_metrics, percentiles)
+{
+    TransportMetrics metrics;
+    ASSERT_EQ(0u, metrics.getLatencyPercentile(50));
+
+    for (int i = 1; i <= 100; ++i)
+        metrics.recordCommand(4, 2, std::chrono::milliseconds(i));
+    metrics.recordTimeout();
+
+    ASSERT_EQ(100u, metrics.getCommandCount());
+    ASSERT_EQ(400u, metrics.getBytesOut());
+    ASSERT_EQ(200u, metrics.getBytesIn());
+    ASSERT_EQ(1u, metrics.getTimeoutCount());
+    ASSERT_EQ(1000u, metrics.getMinLatency());
+    ASSERT_EQ(100000u, metrics.getMaxLatency());
+    ASSERT_EQ(50500u, metrics.getMeanLatency());
+
+    uint64_t p50 = metrics.getLatencyPercentile(50);
+    ASSERT_GE(p50, 50000u);
+    ASSERT_LE(p50, 52000u);
+    ASSERT_EQ(100000u, metrics.getLatencyPercentile(100));
+    ASSERT_NE(std::string::npos, metrics.toJson().find("\"commands\":100"));
+
+    metrics.reset();
+    ASSERT_EQ(0u, metrics.getCommandCount());
+    ASSERT_EQ(0u, metrics.getMinLatency());
+}
+
+TEST(test_transport_metrics, recorded_without_connecting)
+{
+    SessionEchoDataTransport transport;
+    ASSERT_EQ(ByteVector({0x02}), transport.sendCommand({0x01}, 1000));
+    ASSERT_THROW(transport.sendCommand({}, 1000), LibLogicalAccessException);
+
+    ASSERT_EQ(0, transport.d_connects);
+    ASSERT_EQ(1u, transport.getMetrics()->getCommandCount());
+    ASSERT_EQ(1u, transport.getMetrics()->getErrorCount());
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/udpdatatransport.hpp>
+
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A UDP socket on an ephemeral localhost port, standing for the reader.
+ */
+class LocalPeer
+{
+  public:
+    LocalPeer()
+        : d_socket(d_ios, boost::asio::ip::udp::endpoint(
+                              boost::asio::ip::address_v4::loopback(), 0))
+    {
+    }
+
+    int getPort() const
+    {
+        return d_socket.local_endpoint().port();
+    }
+
+    /**
+     * Receive a datagram and answer it with `answer`.
+     */
+    ByteVector answer(const ByteVector &answer)
+    {
+        ByteVector data(256);
+        boost::asio::ip::udp::endpoint sender;
+        size_t len = d_socket.receive_from(boost::asio::buffer(data), sender);
+        d_socket.send_to(boost::asio::buffer(answer), sender);
+        data.resize(len);
+        return data;
+    }
+
+  private:
+    boost::asio::io_service d_ios;
+    boost::asio::ip::udp::socket d_socket;
+};
+
+void setup(UDPDataTransport &transport, const LocalPeer &peer)
+{
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(peer.getPort());
+    ASSERT_TRUE(transport.connect());
+}
+}
+
+TEST(test_udp_data_transport, receive)
+{
+    LocalPeer peer;
+    UDPDataTransport transport;
+    setup(transport, peer);
+
+    transport.send({0x01, 0x02});
+    ASSERT_EQ(ByteVector({0x01, 0x02}), peer.answer({0x03}));
+    ASSERT_EQ(ByteVector({0x03}), transport.receive(1000));
+}
+
+TEST(test_udp_data_transport, timeout)
+{
+    LocalPeer peer;
+    UDPDataTransport transport;
+    setup(transport, peer);
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(transport.receive(100).empty());
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    ASSERT_EQ(1u, transport.getMetrics()->getTimeoutCount());
+}
+
+TEST(test_udp_data_transport, negative_timeout_does_not_wait)
+{
+    LocalPeer peer;
+    UDPDataTransport transport;
+    setup(transport, peer);
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(transport.receive(-1).empty());
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    transport.send({0x01});
+    peer.answer({0x04});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(ByteVector({0x04}), transport.receive(-1));
+}